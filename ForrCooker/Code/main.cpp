@@ -0,0 +1,34 @@
+/*===============================================
+
+    Forr Engine
+
+    File : main.cpp
+    Role : Asset cooker entry point
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "Forr/ResourceManagement/ResourceCooker.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+// ForrCooker [--force]
+// converts the assets to the runtime formats. only changed assets are cooked, unless --force is given
+int main(int argc, char* argv[]) {
+    fe::ResourceCookerDesc desc{};
+    for (int i = 0; i < argc; i++) desc.args.emplace_back(argv[i]);
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--force") == 0) desc.force = true;
+    }
+
+    fe::ResourceCooker cooker{ desc };
+    fe::ResourceCookerStats stats = cooker.Cook();
+
+    std::printf("Cooked : %zu, Up to date : %zu, Failed : %zu, Time : %.2f ms\n", stats.cooked, stats.up_to_date, stats.failed, stats.milliseconds);
+
+    return stats.failed == 0 ? 0 : 1; // fails the build of the project
+}
@@ -14,6 +14,8 @@
 #include <memory>
 #include <vector>
 
+#include "Core/derived_data_cache.hpp"
+#include "Core/job_system.hpp"
 #include "Platform/IPlatformSystem.hpp"
 #include "Graphics/IRenderer.hpp"
 #include "ResourceManagement/ResourceManager.hpp"
@@ -23,6 +25,9 @@
 namespace fe {
     struct FORR_API ApplicationDesc {
         bool validation_enabled = true;
+        bool hot_reload_enabled = true; // changed assets are imported again while running
+
+        uint32_t texture_quality_tier{}; // 0 - full resolution, every tier drops one top mip of textures
 
         GraphicsBackend graphics_backend{};
         PlatformBackend platform_backend{};
@@ -32,6 +37,10 @@ namespace fe {
         std::string application_name{};
         WindowDesc  primary_window_desc{};
 
+        JobSystemDesc        job_system_desc{};
+        DerivedDataCacheDesc derived_data_cache_desc{};
+        FileWatcherDesc      hot_reload_desc{};
+
         ApplicationDesc()  = default;
         ~ApplicationDesc() = default;
     };
@@ -39,7 +48,7 @@ namespace fe {
     class FORR_API Application {
     public:
         Application(const ApplicationDesc& desc);
-        ~Application() = default;
+        ~Application();
 
         void Run();
 
@@ -0,0 +1,37 @@
+/*===============================================
+
+    Forr Engine
+
+    File : block_compression.hpp
+    Role : CPU encoder of BC1, BC3, BC4, BC5 and BC7 blocks
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "attributes.hpp"
+
+namespace fe {
+    enum class BlockFormat : uint8_t {
+        BC1, // RGB,  8 bytes
+        BC3, // RGBA, 16 bytes. BC1 color and BC4 alpha
+        BC4, // R,    8 bytes
+        BC5, // RG,   16 bytes. two BC4
+        BC7, // RGBA, 16 bytes. only mode 6 is used : one subset, 7 bit endpoints with p-bits and 4 bit indices
+    };
+
+    FORR_NODISCARD constexpr uint32_t block_bytes(BlockFormat format) noexcept {
+        return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+    }
+
+    // compresses one image of 8-bit texels with 'components' channels ( 1 - R, 2 - RG, 3 - RGB, 4 - RGBA ) into 'blocks'.
+    // missing channels are 0, missing alpha is 255. blocks over the edges repeat the last row and column.
+    // rows of blocks are compressed in parallel on the job system
+    void FORR_API compress_blocks(const unsigned char* texels, uint32_t width, uint32_t height, uint32_t components, BlockFormat format, unsigned char* blocks);
+} // namespace fe
@@ -12,117 +12,394 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <vector>
 
 #include "attributes.hpp"
+#include "memory_tracking.hpp"
 
 namespace fe {
     struct ArenaMarker {
-        size_t offset{};
+        const void* block = nullptr;
+        size_t      offset{};
     };
 
+    // chained-block arena. when the current block is full, the next one is taken ( or allocated ).
+    // reset() keeps all the blocks, so after the first frames it doesn't touch the heap anymore.
+    // not thread-safe, use one arena per thread. see fe::thread_arena() and fe::FrameArena
     class Arena { // mostly per-frame container
+        struct alignas(std::max_align_t) Block {
+            Block* next     = nullptr;
+            size_t capacity = 0;
+
+            FORR_NODISCARD std::byte* data() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+        };
+
     public:
-        explicit Arena(size_t capacity) : m_capacity(capacity) {
-            m_buffer = static_cast<std::byte*>(::operator new(capacity, std::align_val_t{ alignof(std::max_align_t) }));
-        }
+        inline static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
 
-        ~Arena() { ::operator delete[](m_buffer, std::align_val_t{ alignof(std::max_align_t) }); }
+        // the first block is allocated on the first allocate()
+        explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE, MemoryTag tag = MemoryTag::Unknown)
+            : m_block_size(block_size), m_tag(tag) {}
+        ~Arena() { this->release(); }
 
         FORR_CLASS_NONCOPYABLE(Arena)
-        FORR_CLASS_MOVABLE(Arena)
+
+        Arena(Arena&& other) noexcept { this->swap(other); }
+        Arena& operator=(Arena&& other) noexcept {
+            if (this != &other) {
+                this->release();
+                this->swap(other);
+            }
+            return *this;
+        }
 
         FORR_NODISCARD std::byte* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
             assert(alignment > 0 && (alignment & (alignment - 1)) == 0); // check that it's a power of two
 
-            size_t aligned_offset = (m_offset + alignment - 1) & ~(alignment - 1);
+            while (m_current) {
+                size_t aligned_offset = Arena::alignOffset(m_current, m_offset, alignment);
 
-            if (aligned_offset + size > m_capacity) {
-                return nullptr;
+                if (aligned_offset + size <= m_current->capacity) {
+                    std::byte* ptr = m_current->data() + aligned_offset;
+                    m_offset       = aligned_offset + size;
+                    return ptr;
+                }
+
+                if (!m_current->next) break;
+
+                m_used_before_current += m_current->capacity;
+                m_current = m_current->next;
+                m_offset  = 0;
+            }
+
+            Block* block = this->allocateBlock(std::max(m_block_size, size + alignment));
+            if (m_current) {
+                m_used_before_current += m_current->capacity;
+
+                block->next     = m_current->next;
+                m_current->next = block;
+            }
+            else {
+                m_head = block;
             }
 
-            std::byte* ptr = m_buffer + aligned_offset;
+            m_current = block;
+            m_offset  = 0;
+
+            size_t aligned_offset = Arena::alignOffset(m_current, m_offset, alignment);
+
+            std::byte* ptr = m_current->data() + aligned_offset;
             m_offset       = aligned_offset + size;
             return ptr;
         }
 
-        void reset() { m_offset = 0; }
+        template <typename _Ty>
+        FORR_NODISCARD _Ty* allocate_array(size_t count) {
+            return reinterpret_cast<_Ty*>(this->allocate(count * sizeof(_Ty), alignof(_Ty)));
+        }
 
-        FORR_NODISCARD constexpr size_t get_used_memory() const noexcept { return m_offset; }
-        FORR_NODISCARD constexpr size_t get_available_memory() const noexcept { return m_capacity - m_offset; }
+        // keeps all the blocks
+        void reset() noexcept {
+            m_current             = m_head;
+            m_offset              = 0;
+            m_used_before_current = 0;
+        }
+
+        // frees all the blocks
+        void release() noexcept {
+            while (m_head) {
+                Block* next = m_head->next;
+                memory::trackDeallocation(m_tag, sizeof(Block) + m_head->capacity);
+                ::operator delete(m_head, std::align_val_t{ alignof(Block) });
+                m_head = next;
+            }
+
+            m_current             = nullptr;
+            m_offset              = 0;
+            m_used_before_current = 0;
+            m_reserved            = 0;
+            m_block_count         = 0;
+        }
+
+        FORR_NODISCARD constexpr size_t get_used_memory() const noexcept { return m_used_before_current + m_offset; }
+        FORR_NODISCARD constexpr size_t get_available_memory() const noexcept { return m_reserved - this->get_used_memory(); }
+        FORR_NODISCARD constexpr size_t get_reserved_memory() const noexcept { return m_reserved; }
+        FORR_NODISCARD constexpr size_t get_block_count() const noexcept { return m_block_count; }
 
         FORR_NODISCARD ArenaMarker save() const noexcept {
-            return { m_offset };
+            return { m_current, m_offset };
         }
 
         void restore(ArenaMarker marker) noexcept {
-            assert(marker.offset <= m_offset);
-            m_offset = marker.offset;
+            assert(marker.block != m_current || marker.offset <= m_offset);
+
+            if (!marker.block) {
+                this->reset();
+                return;
+            }
+
+            m_used_before_current = 0;
+            for (Block* block = m_head; block != marker.block; block = block->next) {
+                assert(block && "fe::Arena : the marker doesn't belong to this arena");
+                m_used_before_current += block->capacity;
+            }
+
+            m_current = const_cast<Block*>(static_cast<const Block*>(marker.block));
+            m_offset  = marker.offset;
+        }
+
+    private:
+        FORR_NODISCARD static size_t alignOffset(Block* block, size_t offset, size_t alignment) noexcept {
+            uintptr_t base    = reinterpret_cast<uintptr_t>(block->data());
+            uintptr_t aligned = (base + offset + alignment - 1) & ~(alignment - 1);
+            return aligned - base;
         }
 
+        FORR_NODISCARD Block* allocateBlock(size_t capacity) {
+            void* raw = ::operator new(sizeof(Block) + capacity, std::align_val_t{ alignof(Block) });
+            memory::trackAllocation(m_tag, sizeof(Block) + capacity);
+
+            Block* block    = std::construct_at(static_cast<Block*>(raw));
+            block->capacity = capacity;
+
+            m_reserved += capacity;
+            m_block_count++;
+
+            return block;
+        }
+
+        void swap(Arena& other) noexcept {
+            std::swap(m_block_size, other.m_block_size);
+            std::swap(m_tag, other.m_tag);
+            std::swap(m_head, other.m_head);
+            std::swap(m_current, other.m_current);
+            std::swap(m_offset, other.m_offset);
+            std::swap(m_used_before_current, other.m_used_before_current);
+            std::swap(m_reserved, other.m_reserved);
+            std::swap(m_block_count, other.m_block_count);
+        }
+
+    private:
+        size_t    m_block_size = DEFAULT_BLOCK_SIZE;
+        MemoryTag m_tag        = MemoryTag::Unknown;
+
+        Block* m_head    = nullptr;
+        Block* m_current = nullptr;
+        size_t m_offset  = 0; // offset in m_current
+
+        size_t m_used_before_current = 0;
+        size_t m_reserved            = 0;
+        size_t m_block_count         = 0;
+    };
+
+    // restores the arena when goes out of scope.
+    // the scope must be declared before the containers that use resource()
+    class ArenaScope {
+    public:
+        explicit ArenaScope(Arena& arena) noexcept : m_arena(arena), m_marker(arena.save()) {}
+        ~ArenaScope() { m_arena.restore(m_marker); }
+
+        FORR_CLASS_NONCOPYABLE(ArenaScope)
+
     private:
-        std::byte*   m_buffer   = nullptr;
-        const size_t m_capacity = 0;
-        size_t       m_offset   = 0;
+        Arena&      m_arena;
+        ArenaMarker m_marker{};
     };
 
-    template <typename _Ty>
-    class Pool {
+    // std::pmr adaptor. lets std::pmr containers use arena memory :
+    // fe::ArenaResource resource{ arena };
+    // std::pmr::vector<int> vec{ &resource };
+    // deallocate() does nothing, the memory is returned by Arena::reset() or Arena::restore()
+    class ArenaResource : public std::pmr::memory_resource {
+    public:
+        explicit ArenaResource(Arena& arena) noexcept : m_arena(&arena) {}
+        ~ArenaResource() = default;
+
+        FORR_NODISCARD Arena& arena() const noexcept { return *m_arena; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            return m_arena->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            const auto* other_resource = dynamic_cast<const ArenaResource*>(&other);
+            return other_resource && other_resource->m_arena == m_arena;
+        }
+
+    private:
+        Arena* m_arena = nullptr;
+    };
+
+    // one arena per frame in flight.
+    // call begin_frame() only when the GPU is done with that frame ( its fence has signaled )
+    template <size_t _FrameCount>
+    class FrameArena {
+    public:
+        inline static constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+        explicit FrameArena(size_t block_size = DEFAULT_BLOCK_SIZE, MemoryTag tag = MemoryTag::Renderer)
+            : m_arenas(FrameArena::makeArenas(block_size, tag, std::make_index_sequence<_FrameCount>{})) {}
+        ~FrameArena() = default;
+
+        FORR_CLASS_NONCOPYABLE(FrameArena)
+
+        void begin_frame(size_t frame_index) noexcept {
+            assert(frame_index < _FrameCount);
+
+            m_current = frame_index;
+            m_arenas[m_current].reset();
+        }
+
+        FORR_NODISCARD Arena&       get() noexcept { return m_arenas[m_current]; }
+        FORR_NODISCARD const Arena& get() const noexcept { return m_arenas[m_current]; }
+
+        FORR_NODISCARD constexpr size_t frame_count() const noexcept { return _FrameCount; }
+
+    private:
+        // Arena's constructor is explicit, so the array can't be list-initialized with '{}'
+        template <size_t... _Indices>
+        FORR_NODISCARD static std::array<Arena, _FrameCount> makeArenas(size_t block_size, MemoryTag tag, std::index_sequence<_Indices...>) {
+            return { ((void)_Indices, Arena{ block_size, tag })... };
+        }
+
+    private:
+        std::array<Arena, _FrameCount> m_arenas;
+        size_t                         m_current = 0;
+    };
+
+    // arena of the calling thread. use it with fe::ArenaScope for scratch memory :
+    // fe::ArenaScope    scope{ fe::thread_arena() };
+    // fe::ArenaResource resource{ fe::thread_arena() };
+    // std::pmr::vector<uint8_t> scratch{ &resource };
+    Arena& FORR_API thread_arena();
+
+    struct PoolStats {
+        size_t live_count{}; // objects given to the user
+        size_t peak_count{};
+        size_t slab_count{};
+        size_t slot_size{};
+
+        PoolStats()  = default;
+        ~PoolStats() = default;
+    };
+
+    // untyped slab pool. use fe::Pool<_Ty>.
+    // adds slabs when full. every thread keeps a small free-list cache, so most of allocate() / deallocate()
+    // calls don't lock. the cache is returned to the global free-list in batches.
+    // all functions are thread-safe. memory can be freed from another thread than it was allocated
+    class FORR_API PoolAllocator {
+    public:
+        inline static constexpr size_t DEFAULT_SLAB_CAPACITY = 256;
+
+        PoolAllocator(size_t slot_size, size_t slot_alignment, size_t slab_capacity = DEFAULT_SLAB_CAPACITY, MemoryTag tag = MemoryTag::Unknown);
+        ~PoolAllocator();
+
+        FORR_CLASS_NONCOPYABLE(PoolAllocator)
+
+        FORR_NODISCARD void* allocate();
+        void                 deallocate(void* ptr);
+
+        // returns the free-list cache of the calling thread to the global free-list
+        void flush_thread_cache();
+
+        // frees slabs that have no live objects. the caches of other threads are not touched,
+        // so their slabs stay alive. returns the count of released slabs
+        size_t release_empty_slabs();
+
+        FORR_NODISCARD PoolStats stats() const noexcept;
+
+    private:
         struct FreeNode {
             FreeNode* next = nullptr;
         };
 
-    public:
-        explicit Pool(size_t count) {
-            static_assert(sizeof(_Ty) >= sizeof(FreeNode*), "Object too small for pool");
+        struct Slab {
+            std::byte* begin       = nullptr;
+            size_t     outstanding = 0; // slots that are not in the global free-list
+        };
 
-            m_capacity = count;
-            m_buffer   = ::operator new(count * sizeof(_Ty), std::align_val_t{ alignof(_Ty) });
+        friend struct PoolThreadCache;
 
-            for (size_t i = 0; i < count; i++) {
-                auto* node  = reinterpret_cast<FreeNode*>(m_buffer + i * sizeof(_Ty));
-                node->next  = m_free_list;
-                m_free_list = node;
-            }
-        }
+        // all of them lock m_mutex
+        FreeNode* takeBatch(size_t count, size_t& taken);
+        void      returnBatch(FreeNode* head);
 
-        ~Pool() { ::operator delete[](m_buffer, std::align_val_t{ alignof(_Ty) }); }
+        // m_mutex must be locked
+        void  addSlab();
+        Slab* findSlab(const void* ptr) noexcept;
+
+        void onAllocate() noexcept;
+
+    private:
+        const uint64_t  m_id;
+        const size_t    m_slot_size;
+        const size_t    m_slot_alignment;
+        const size_t    m_slab_capacity;
+        const MemoryTag m_tag;
+
+        std::mutex        m_mutex;
+        FreeNode*         m_free_list = nullptr;
+        std::vector<Slab> m_slabs; // sorted by Slab::begin
+
+        std::atomic<size_t> m_live_count{};
+        std::atomic<size_t> m_peak_count{};
+        std::atomic<size_t> m_slab_count{};
+    };
+
+    template <typename _Ty>
+    class Pool {
+    public:
+        explicit Pool(size_t slab_capacity = PoolAllocator::DEFAULT_SLAB_CAPACITY, MemoryTag tag = MemoryTag::Unknown)
+            : m_allocator(sizeof(_Ty), alignof(_Ty), slab_capacity, tag) {}
+        ~Pool() = default;
 
         FORR_CLASS_NONCOPYABLE(Pool)
 
+        // never returns nullptr
         FORR_NODISCARD _Ty* allocate() {
-            if (!m_free_list) return nullptr;
-
-            std::byte* ptr = m_free_list;
-            m_free_list    = m_free_list->next;
-            return static_cast<_Ty*>(ptr);
+            return static_cast<_Ty*>(m_allocator.allocate());
         }
 
         void deallocate(_Ty* ptr) {
-            auto* node  = reinterpret_cast<FreeNode*>(ptr);
-            node->next  = m_free_list;
-            m_free_list = node;
+            m_allocator.deallocate(ptr);
         }
 
         // don't forget about Pool::destroy()
         template <typename... Args>
         FORR_NODISCARD _Ty* create(Args&&... args) {
-            _Ty* ptr = allocate();
-            std::construct_at(ptr, std::forward<Args>(args)...);
-            return ptr;
+            _Ty* ptr = this->allocate();
+            return std::construct_at(ptr, std::forward<Args>(args)...);
         }
 
         void destroy(_Ty* ptr) {
+            if (!ptr) return;
+
             std::destroy_at(ptr);
-            deallocate(ptr);
+            this->deallocate(ptr);
         }
 
+        void   flush_thread_cache() { m_allocator.flush_thread_cache(); }
+        size_t release_empty_slabs() { return m_allocator.release_empty_slabs(); }
+
+        FORR_NODISCARD PoolStats stats() const noexcept { return m_allocator.stats(); }
+
     private:
-        std::byte* m_buffer    = nullptr;
-        size_t     m_capacity  = 0;
-        FreeNode*  m_free_list = nullptr;
+        PoolAllocator m_allocator;
     };
 
 } // namespace fe
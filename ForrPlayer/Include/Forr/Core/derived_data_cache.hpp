@@ -0,0 +1,117 @@
+/*===============================================
+
+    Forr Engine
+
+    File : derived_data_cache.hpp
+    Role : content-addressed cache of importer outputs
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "attributes.hpp"
+#include "hash.hpp"
+
+namespace fe {
+    struct FORR_API DerivedDataCacheDesc {
+        bool enabled = true;
+
+        uint64_t max_size = 4ull << 30; // in bytes on the disk. the least recently used entries are removed above it
+
+        DerivedDataCacheDesc()  = default;
+        ~DerivedDataCacheDesc() = default;
+    };
+
+    struct FORR_API DerivedDataCacheStats {
+        size_t hits{};
+        size_t misses{};
+        size_t stores{};
+        size_t evictions{};
+
+        size_t   entry_count{};
+        uint64_t size{}; // in bytes
+
+        DerivedDataCacheStats()  = default;
+        ~DerivedDataCacheStats() = default;
+    };
+
+    // the first part of a key. hash source bytes and settings into it with hash_bytes() and hash_combine().
+    // increase 'importer_version' when the output of the importer is changed, old entries are never found again and get evicted
+    FORR_NODISCARD inline uint64_t derived_data_key(std::string_view importer_name, uint32_t importer_version) noexcept {
+        return hash_combine(hash_string(importer_name), importer_version);
+    }
+
+    // stores outputs of importers as files named by a key. a key is a hash of everything the output depends on,
+    // so an entry is never outdated : a changed source gives another key. entries are only evicted by the size limit.
+    // the recency of entries is kept in their last write time between runs. thread-safe.
+    // if the cache isn't initialized, find() always misses and store() does nothing
+    class FORR_API DerivedDataCache {
+    public:
+        FORR_CLASS_NONCOPYABLE(DerivedDataCache)
+
+        static DerivedDataCache& Instance();
+
+        void init(const std::filesystem::path& folder, const DerivedDataCacheDesc& desc);
+        void shutdown(); // logs the stats
+
+        FORR_NODISCARD bool is_enabled() const noexcept { return m_enabled.load(std::memory_order_acquire); }
+
+        // where the entry is written and read. the file may not exist
+        FORR_NODISCARD std::filesystem::path entry_path(uint64_t key, const std::filesystem::path& extension) const;
+
+        // counts a hit or a miss. a found entry becomes the most recently used one.
+        // it can still be evicted by another thread before it's read, so failed reading has to be handled as a miss
+        FORR_NODISCARD bool find(uint64_t key, const std::filesystem::path& extension);
+
+        // registers the entry after it's written to entry_path() and evicts old entries if the cache is too big
+        void store(uint64_t key, const std::filesystem::path& extension);
+
+        // removes an entry that was found but couldn't be read
+        void discard(uint64_t key, const std::filesystem::path& extension);
+
+        // a file next to 'path' to write into before it's renamed to 'path'. every call gives another name,
+        // so threads that write the same entry don't write into one file. left ones are removed by init()
+        FORR_NODISCARD static std::filesystem::path temporary_path(const std::filesystem::path& path);
+
+        FORR_NODISCARD DerivedDataCacheStats stats() const;
+
+    private:
+        DerivedDataCache()  = default;
+        ~DerivedDataCache() = default;
+
+        struct Entry {
+            uint64_t size{};
+            uint64_t last_use{}; // bigger is newer
+        };
+
+        FORR_NODISCARD static std::string entryName(uint64_t key, const std::filesystem::path& extension);
+
+        void evict(); // m_mutex has to be locked
+
+    private:
+        std::filesystem::path m_folder{};
+        DerivedDataCacheDesc  m_desc{};
+
+        std::atomic<bool> m_enabled{};
+
+        mutable std::mutex                     m_mutex;
+        std::unordered_map<std::string, Entry> m_entries{}; // by file name
+        uint64_t                               m_use_counter{};
+
+        DerivedDataCacheStats m_stats{};
+    };
+
+    inline static DerivedDataCache& DDC = DerivedDataCache::Instance();
+
+} // namespace fe
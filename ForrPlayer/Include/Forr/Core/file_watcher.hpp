@@ -0,0 +1,83 @@
+/*===============================================
+
+    Forr Engine
+
+    File : file_watcher.hpp
+    Role : reports changed files of a folder
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "attributes.hpp"
+
+namespace fe {
+    struct FORR_API FileWatcherDesc {
+        bool native = true; // inotify on Linux, ReadDirectoryChangesW on Windows. the folder is polled if it's false or not available
+
+        uint32_t poll_interval_milliseconds = 500; // how often the folder is scanned when it's polled
+
+        // a file is reported when it wasn't changed for this time. editors and exporters save in several writes
+        uint32_t settle_milliseconds = 100;
+
+        FileWatcherDesc()  = default;
+        ~FileWatcherDesc() = default;
+    };
+
+    // watches a folder and its subfolders. it doesn't use threads : events are collected in poll(),
+    // so call it regularly ( once per frame ) from one thread
+    class FORR_API FileWatcher {
+    public:
+        FileWatcher(); // in the .cpp, Native is complete only there
+        ~FileWatcher();
+
+        FORR_CLASS_NONCOPYABLE(FileWatcher)
+
+        FORR_NODISCARD bool init(const std::filesystem::path& folder, const FileWatcherDesc& desc = {});
+        void                shutdown();
+
+        FORR_NODISCARD bool is_watching() const noexcept { return !m_folder.empty(); }
+        FORR_NODISCARD bool is_native() const noexcept { return m_native != nullptr; }
+
+        // full paths of files that were changed, created or renamed to since the last call, every file once
+        FORR_NODISCARD std::vector<std::filesystem::path> poll();
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct FileState {
+            std::filesystem::file_time_type time{};
+            uint64_t                        size{};
+        };
+
+        struct Native; // the state of the OS API
+
+        FORR_NODISCARD bool initNative();
+        void                readNative();
+        void                scan(bool report);
+
+        void touch(const std::filesystem::path& path);
+
+    private:
+        std::filesystem::path m_folder{};
+        FileWatcherDesc       m_desc{};
+
+        std::unique_ptr<Native> m_native{};
+
+        std::unordered_map<std::string, FileState> m_snapshot{}; // only when the folder is polled
+        Clock::time_point                          m_last_scan{};
+
+        std::unordered_map<std::string, Clock::time_point> m_pending{}; // changed files waiting for the settle time
+    };
+} // namespace fe
@@ -0,0 +1,42 @@
+/*===============================================
+
+    Forr Engine
+
+    File : hash.hpp
+    Role : fast non-cryptographic hashing of bytes and files
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "attributes.hpp"
+
+namespace fe {
+    // XXH64. the same bytes and seed give the same hash on every platform, so hashes can be stored on the disk
+    FORR_NODISCARD uint64_t FORR_API hash_bytes(const void* data, size_t size, uint64_t seed = 0) noexcept;
+
+    FORR_NODISCARD inline uint64_t hash_string(std::string_view string, uint64_t seed = 0) noexcept {
+        return hash_bytes(string.data(), string.size(), seed);
+    }
+
+    // order matters : hash_combine(a, b) != hash_combine(b, a)
+    FORR_NODISCARD inline uint64_t hash_combine(uint64_t seed, uint64_t value) noexcept {
+        return hash_bytes(&value, sizeof(value), seed);
+    }
+
+    // hashes the whole file through a mapping. false if the file can't be read
+    FORR_NODISCARD bool FORR_API hash_file(const std::filesystem::path& path, uint64_t& hash, uint64_t seed = 0);
+
+    // 16 hex digits, used in file names and manifests
+    FORR_NODISCARD std::string FORR_API hash_to_string(uint64_t hash);
+    FORR_NODISCARD bool FORR_API        hash_from_string(std::string_view string, uint64_t& hash) noexcept;
+} // namespace fe
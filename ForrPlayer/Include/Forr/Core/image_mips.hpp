@@ -0,0 +1,92 @@
+/*===============================================
+
+    Forr Engine
+
+    File : image_mips.hpp
+    Role : layout and CPU generation of mip chains of 8-bit images
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "attributes.hpp"
+
+namespace fe {
+    // levels of a chain are tightly packed one after another, the largest first.
+    // every level is half of the previous one, rounded down, but not less than 1
+    struct MipLevel {
+        uint32_t width{};
+        uint32_t height{};
+        size_t   offset{}; // in bytes, from the start of the chain
+        size_t   size{};   // in bytes
+
+        MipLevel()  = default;
+        ~MipLevel() = default;
+    };
+
+    // how texels of a level are stored. uncompressed texels are blocks of 1x1
+    struct MipFormat {
+        uint32_t block_extent{ 1 }; // texels on a side of a block, 4 for block compressed formats
+        uint32_t block_bytes{};
+
+        MipFormat()  = default;
+        ~MipFormat() = default;
+
+        constexpr MipFormat(uint32_t block_extent, uint32_t block_bytes) noexcept
+            : block_extent(block_extent), block_bytes(block_bytes) {}
+    };
+
+    // the full chain, down to 1x1
+    FORR_NODISCARD constexpr uint32_t mip_count(uint32_t width, uint32_t height) noexcept {
+        return static_cast<uint32_t>(std::bit_width(std::max({ width, height, 1u })));
+    }
+
+    FORR_NODISCARD constexpr uint32_t mip_extent(uint32_t extent, uint32_t level) noexcept {
+        return std::max(extent >> level, 1u);
+    }
+
+    // a partial block at the edge takes the bytes of a whole one
+    FORR_NODISCARD constexpr MipLevel mip_level(uint32_t width, uint32_t height, MipFormat format, uint32_t level) noexcept {
+        MipLevel result{};
+
+        for (uint32_t i = 0; i <= level; i++) {
+            result.offset += result.size;
+            result.width  = mip_extent(width, i);
+            result.height = mip_extent(height, i);
+
+            size_t blocks_x = (result.width + format.block_extent - 1) / format.block_extent;
+            size_t blocks_y = (result.height + format.block_extent - 1) / format.block_extent;
+            result.size     = blocks_x * blocks_y * format.block_bytes;
+        }
+
+        return result;
+    }
+
+    FORR_NODISCARD constexpr MipLevel mip_level(uint32_t width, uint32_t height, uint32_t components, uint32_t level) noexcept {
+        return mip_level(width, height, MipFormat{ 1, components }, level);
+    }
+
+    // bytes of the first 'count' levels
+    FORR_NODISCARD constexpr size_t mip_chain_size(uint32_t width, uint32_t height, MipFormat format, uint32_t count) noexcept {
+        if (count == 0) return 0;
+
+        MipLevel last = mip_level(width, height, format, count - 1);
+        return last.offset + last.size;
+    }
+
+    FORR_NODISCARD constexpr size_t mip_chain_size(uint32_t width, uint32_t height, uint32_t components, uint32_t count) noexcept {
+        return mip_chain_size(width, height, MipFormat{ 1, components }, count);
+    }
+
+    // fills levels 1..count-1 of 'chain' from level 0, which has to be there already.
+    // a 2x2 box filter. with 'srgb' the color channels are averaged in linear space, the 4th channel is alpha and is always linear
+    void FORR_API generate_mips(unsigned char* chain, uint32_t width, uint32_t height, uint32_t components, uint32_t count, bool srgb);
+} // namespace fe
@@ -0,0 +1,179 @@
+/*===============================================
+
+    Forr Engine
+
+    File : job_system.hpp
+    Role : work-stealing job scheduler
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "attributes.hpp"
+#include "custom_allocators.hpp"
+
+namespace fe {
+    // counts unfinished jobs. pass it to JobSystem::run() and wait for it with JobSystem::wait()
+    class JobCounter {
+    public:
+        JobCounter()  = default;
+        ~JobCounter() = default;
+
+        FORR_CLASS_NONCOPYABLE(JobCounter)
+
+        FORR_NODISCARD bool is_done() const noexcept { return m_count.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_count{};
+    };
+
+    struct FORR_API JobSystemDesc {
+        size_t worker_count = 0; // 0 means one worker per core except the main thread's one
+
+        bool        pin_workers = false; // worker i runs only on core i + 1
+        std::string worker_name = "Forr Worker";
+
+        JobSystemDesc()  = default;
+        ~JobSystemDesc() = default;
+    };
+
+    // every worker has its own deque. a worker takes its newest jobs first and steals the oldest ones from others.
+    // jobs from non-worker threads go to a global queue.
+    // wait() doesn't block the thread, it runs other jobs until the counter is done.
+    // if the system has no workers ( or wasn't initialized ) run() executes the job right away.
+    // an exception that leaves a job is logged and the job counts as done, the same for inline jobs
+    class FORR_API JobSystem {
+    public:
+        using JobFunction = std::function<void()>;
+
+        inline static constexpr size_t INVALID_WORKER_INDEX = ~size_t(0);
+
+        FORR_CLASS_NONCOPYABLE(JobSystem)
+
+        static JobSystem& Instance();
+
+        void init(const JobSystemDesc& desc);
+        void shutdown(); // runs the jobs that are left and joins the workers
+
+        // 'counter' is increased now and decreased when the job is finished
+        void run(JobFunction func, JobCounter* counter = nullptr);
+
+        // the job is executed by process_main_thread_jobs() or by wait() on the main thread
+        void run_on_main_thread(JobFunction func, JobCounter* counter = nullptr);
+
+        // runs other jobs while waiting
+        void wait(const JobCounter& counter);
+
+        // call it once per frame from the main thread
+        void process_main_thread_jobs();
+
+        // splits [begin, end) into chunks of 'grain_size' and waits for all of them. the chunks on other threads are jobs,
+        // an exception of the chunk on this thread is rethrown after the others are done ( they reference 'func' ).
+        // it can be invoked by :
+        // [](size_t index) -> void {}
+        // [](size_t chunk_begin, size_t chunk_end) -> void {}
+        template <typename _Func>
+        void parallel_for(size_t begin, size_t end, size_t grain_size, _Func&& func) {
+            if (begin >= end) return;
+
+            grain_size = std::max<size_t>(grain_size, 1);
+
+            auto run_chunk = [&func](size_t chunk_begin, size_t chunk_end) {
+                if constexpr (std::is_invocable_v<_Func, size_t, size_t>) {
+                    func(chunk_begin, chunk_end);
+                }
+                else if constexpr (std::is_invocable_v<_Func, size_t>) {
+                    for (size_t i = chunk_begin; i < chunk_end; i++) func(i);
+                }
+                else {
+                    static_assert(false, "fe::JobSystem : parallel_for lambda has invalid signature");
+                }
+            };
+
+            JobCounter counter{};
+
+            size_t chunk_begin = begin;
+            for (; chunk_begin + grain_size < end; chunk_begin += grain_size) {
+                this->run([&run_chunk, chunk_begin, grain_size] { run_chunk(chunk_begin, chunk_begin + grain_size); }, &counter);
+            }
+
+            try {
+                run_chunk(chunk_begin, end); // the last chunk on this thread
+            }
+            catch (...) {
+                this->wait(counter);
+                throw;
+            }
+
+            this->wait(counter);
+        }
+
+        FORR_NODISCARD size_t worker_count() const noexcept { return m_workers.size(); }
+        FORR_NODISCARD bool   is_main_thread() const noexcept;
+
+        // INVALID_WORKER_INDEX for non-worker threads
+        FORR_NODISCARD size_t current_worker_index() const noexcept;
+
+    private:
+        JobSystem();
+        ~JobSystem();
+
+        struct Job;
+        struct Worker;
+
+        void workerLoop(size_t worker_index);
+
+        FORR_NODISCARD Job* createJob(JobFunction&& func, JobCounter* counter);
+        FORR_NODISCARD Job* findJob(size_t worker_index);
+        void                execute(Job* job);
+
+        static void invoke(const JobFunction& func) noexcept; // catches and logs what the job throws
+
+    private:
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::unique_ptr<Worker>              m_global; // queue of non-worker threads
+        std::unique_ptr<Worker>              m_main;   // main thread only jobs
+
+        std::unique_ptr<Pool<Job>> m_job_pool;
+
+        std::atomic<size_t> m_pending{}; // jobs in the deques, used to put workers to sleep
+        std::atomic<bool>   m_stop{};
+    };
+
+    // a set of jobs that is waited together. waits in the destructor
+    class JobGroup {
+    public:
+        explicit JobGroup(JobSystem& job_system = JobSystem::Instance()) noexcept : m_job_system(job_system) {}
+        ~JobGroup() { this->wait(); }
+
+        FORR_CLASS_NONCOPYABLE(JobGroup)
+
+        void run(JobSystem::JobFunction func) { m_job_system.run(std::move(func), &m_counter); }
+        void run_on_main_thread(JobSystem::JobFunction func) { m_job_system.run_on_main_thread(std::move(func), &m_counter); }
+
+        void wait() { m_job_system.wait(m_counter); }
+
+        FORR_NODISCARD bool is_done() const noexcept { return m_counter.is_done(); }
+
+    private:
+        JobSystem& m_job_system;
+        JobCounter m_counter{};
+    };
+
+    inline static JobSystem& JOBS = JobSystem::Instance();
+
+} // namespace fe
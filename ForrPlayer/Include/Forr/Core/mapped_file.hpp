@@ -0,0 +1,60 @@
+/*===============================================
+
+    Forr Engine
+
+    File : mapped_file.hpp
+    Role : read-only memory-mapped file
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+#include "attributes.hpp"
+
+namespace fe {
+    // the whole file is mapped at once. pages are loaded by the OS on the first access,
+    // so only the touched parts of the file are read from the disk
+    class FORR_API MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { this->close(); }
+
+        FORR_CLASS_NONCOPYABLE(MappedFile)
+
+        MappedFile(MappedFile&& other) noexcept { this->swap(other); }
+        MappedFile& operator=(MappedFile&& other) noexcept {
+            if (this != &other) {
+                this->close();
+                this->swap(other);
+            }
+            return *this;
+        }
+
+        FORR_NODISCARD bool open(const std::filesystem::path& path);
+        void                close();
+
+        void swap(MappedFile& other) noexcept;
+
+        FORR_NODISCARD bool             is_open() const noexcept { return m_data != nullptr; }
+        FORR_NODISCARD const std::byte* data() const noexcept { return m_data; }
+        FORR_NODISCARD size_t           size() const noexcept { return m_size; }
+
+        FORR_NODISCARD std::span<const std::byte> bytes() const noexcept { return { m_data, m_size }; }
+
+    private:
+        const std::byte* m_data = nullptr;
+        size_t           m_size = 0;
+
+#if _WIN32
+        void* m_file    = nullptr; // HANDLE
+        void* m_mapping = nullptr; // HANDLE
+#endif
+    };
+} // namespace fe
@@ -0,0 +1,150 @@
+/*===============================================
+
+    Forr Engine
+
+    File : memory_tracking.hpp
+    Role : per-subsystem memory accounting. Tags, budgets and high-water marks
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "attributes.hpp"
+
+namespace fe {
+    enum class MemoryTag : uint8_t {
+        Unknown,
+        Textures,
+        Meshes,
+        Animation,
+        Shaders,
+        Materials,
+        Renderer,
+        Resources,
+        Scratch, // thread arenas and other temporary memory
+        Jobs,
+
+        Count
+    };
+
+    namespace memory {
+        struct FORR_API TagStats {
+            size_t current_bytes{};
+            size_t peak_bytes{};
+            size_t allocation_count{}; // live allocations
+            size_t total_allocations{};
+            size_t budget{}; // 0 means no budget
+
+            TagStats()  = default;
+            ~TagStats() = default;
+        };
+
+        // both are lock-free. a warning is logged when an allocation goes over the tag's budget
+        void FORR_API trackAllocation(MemoryTag tag, size_t bytes) noexcept;
+        void FORR_API trackDeallocation(MemoryTag tag, size_t bytes) noexcept;
+
+        // 0 disables the budget
+        void FORR_API setBudget(MemoryTag tag, size_t bytes) noexcept;
+
+        TagStats FORR_API    getStats(MemoryTag tag) noexcept;
+        const char* FORR_API getTagName(MemoryTag tag) noexcept;
+
+        // resets peaks to the current values
+        void FORR_API resetPeaks() noexcept;
+
+        // logs the stats of every tag that was used
+        void FORR_API dump();
+
+    } // namespace memory
+
+    // std allocator that reports everything to fe::memory under '_Tag'
+    template <typename _Ty, MemoryTag _Tag>
+    class TaggedAllocator {
+    public:
+        using value_type = _Ty;
+
+        template <typename _Other>
+        struct rebind {
+            using other = TaggedAllocator<_Other, _Tag>;
+        };
+
+        TaggedAllocator()  = default;
+        ~TaggedAllocator() = default;
+
+        template <typename _Other>
+        constexpr TaggedAllocator(const TaggedAllocator<_Other, _Tag>&) noexcept {}
+
+        FORR_NODISCARD _Ty* allocate(size_t count) {
+            memory::trackAllocation(_Tag, count * sizeof(_Ty));
+
+            if constexpr (alignof(_Ty) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                return static_cast<_Ty*>(::operator new(count * sizeof(_Ty), std::align_val_t{ alignof(_Ty) }));
+            }
+            else {
+                return static_cast<_Ty*>(::operator new(count * sizeof(_Ty)));
+            }
+        }
+
+        void deallocate(_Ty* ptr, size_t count) noexcept {
+            memory::trackDeallocation(_Tag, count * sizeof(_Ty));
+
+            if constexpr (alignof(_Ty) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                ::operator delete(ptr, std::align_val_t{ alignof(_Ty) });
+            }
+            else {
+                ::operator delete(ptr);
+            }
+        }
+
+        template <typename _Other>
+        constexpr bool operator==(const TaggedAllocator<_Other, _Tag>&) const noexcept { return true; }
+    };
+
+    template <typename _Ty, MemoryTag _Tag>
+    using tagged_vector = std::vector<_Ty, TaggedAllocator<_Ty, _Tag>>;
+
+    template <typename _Ty, MemoryTag _Tag>
+    struct TaggedArrayDeleter {
+        size_t count{};
+        void (*release)(_Ty*){}; // for memory that wasn't made with new[], see adopt_tagged_unique_array()
+
+        void operator()(_Ty* ptr) const noexcept {
+            memory::trackDeallocation(_Tag, count * sizeof(_Ty));
+
+            if (release)
+                release(ptr);
+            else
+                delete[] ptr;
+        }
+    };
+
+    // std::unique_ptr<_Ty[]> that reports its memory under '_Tag'
+    template <typename _Ty, MemoryTag _Tag>
+    using tagged_unique_array = std::unique_ptr<_Ty[], TaggedArrayDeleter<_Ty, _Tag>>;
+
+    // like std::make_unique_for_overwrite<_Ty[]>()
+    template <typename _Ty, MemoryTag _Tag>
+    FORR_NODISCARD tagged_unique_array<_Ty, _Tag> make_tagged_unique_array(size_t count) {
+        tagged_unique_array<_Ty, _Tag> result{ new _Ty[count], TaggedArrayDeleter<_Ty, _Tag>{ count } };
+        memory::trackAllocation(_Tag, count * sizeof(_Ty));
+        return result;
+    }
+
+    // takes 'count' elements allocated by a library ( stbi_load(), ... ) without copying them. 'release' frees them
+    template <typename _Ty, MemoryTag _Tag>
+    FORR_NODISCARD tagged_unique_array<_Ty, _Tag> adopt_tagged_unique_array(_Ty* ptr, size_t count, void (*release)(_Ty*)) {
+        tagged_unique_array<_Ty, _Tag> result{ ptr, TaggedArrayDeleter<_Ty, _Tag>{ count, release } };
+        memory::trackAllocation(_Tag, count * sizeof(_Ty));
+        return result;
+    }
+
+} // namespace fe
@@ -61,10 +61,23 @@ namespace fe {
             return this->getShadersPath() / L"Default";
         }
 
+        // outputs of ForrCooker. the folder mirrors the assets folder
+        FORR_FORCE_INLINE FORR_NODISCARD std::filesystem::path getCookedAssetsPath() const noexcept {
+            return m_AssetsPath / L"Cooked";
+        }
+
+        // outputs of importers cached by DDC. it's next to the executable, not copied with the assets
+        FORR_FORCE_INLINE FORR_NODISCARD std::filesystem::path getDerivedDataPath() const noexcept {
+            return m_ExecutablePath / L"DerivedData";
+        }
+
         //
 
         FORR_FORCE_INLINE FORR_NODISCARD std::filesystem::path getMetadataExtension() const noexcept { return L".forr_meta"; }
         FORR_FORCE_INLINE FORR_NODISCARD std::filesystem::path getMaterialExtension() const noexcept { return L".forr_material"; }
+        FORR_FORCE_INLINE FORR_NODISCARD std::filesystem::path getModelExtension() const noexcept { return L".forr_model"; }
+        FORR_FORCE_INLINE FORR_NODISCARD std::filesystem::path getTextureExtension() const noexcept { return L".forr_texture"; }
+        FORR_FORCE_INLINE FORR_NODISCARD std::filesystem::path getShaderExtension() const noexcept { return L".forr_shader"; }
         FORR_FORCE_INLINE FORR_NODISCARD std::filesystem::path getVertexShaderExtension() const noexcept { return L".vert"; }
         FORR_FORCE_INLINE FORR_NODISCARD std::filesystem::path getFragmentShaderExtension() const noexcept { return L".frag"; }
 
@@ -15,12 +15,20 @@
 
 #pragma once
 #include <vector>
+#include <array>
+#include <atomic>
+#include <cassert>
 #include <cstdint>
+#include <algorithm>
 #include <unordered_map>
 #include <typeindex>
 #include <memory>
+#include <new>
+#include <limits>
+#include <mutex>
 #include <shared_mutex>
 #include <type_traits>
+#include <utility>
 
 #include "attributes.hpp"
 
@@ -75,7 +83,7 @@ namespace fe {
         handle_t m_index{ std::numeric_limits<handle_t>::max() };
         handle_t m_generation{ std::numeric_limits<handle_t>::max() };
 
-        template <storable_t>
+        template <storable_t, size_t>
         friend class typed_pointer_storage;
     };
 
@@ -93,96 +101,128 @@ namespace fe {
         }
     };
 
-    template <storable_t _Ty>
+    // objects are kept in fixed-size pages which are never moved or freed while the storage is alive.
+    // it means that '_Ty*' from get() stays valid until the object is destroyed, even if the storage grows.
+    // _PageCapacity must be a power of two
+    template <storable_t _Ty, size_t _PageCapacity = 256>
     class typed_pointer_storage {
+        static_assert(_PageCapacity > 0 && (_PageCapacity & (_PageCapacity - 1)) == 0, "fe::typed_pointer_storage : page capacity must be a power of two");
+
+        struct page_t {
+            alignas(_Ty) std::byte data[sizeof(_Ty) * _PageCapacity];
+        };
+
     public:
         using pointer_t = pointer<_Ty>;
 
-        typed_pointer_storage()  = default;
-        ~typed_pointer_storage() = default;
+        inline static constexpr size_t page_capacity = _PageCapacity;
 
-        FORR_NODISCARD pointer_t create(const _Ty& value) {
-            //std::unique_lock lock(m_mutex);
+        typed_pointer_storage() = default;
+        ~typed_pointer_storage() { this->destroy_all(); }
+
+        FORR_CLASS_NONCOPYABLE(typed_pointer_storage)
+
+        // constructs the object in place. dead slots are reused without any assignment
+        template <typename... Args>
+        FORR_NODISCARD pointer_t emplace(Args&&... args) {
 
             handle_t index{};
             if (!m_free_list.empty()) {
                 index = m_free_list.back();
-                m_free_list.pop_back();
 
-                m_slots_object[index] = value;
-                m_slots_alive[index]  = true;
+                std::construct_at(this->slot(index), std::forward<Args>(args)...);
+                m_free_list.pop_back(); // only after construction, so throwing constructor won't lose the slot
+
+                m_slots_alive[index] = true;
                 m_slots_generation[index]++;
             }
             else {
                 index = static_cast<handle_t>(m_slots_generation.size());
 
-                m_slots_object.emplace_back(value);
+                if (index == this->capacity()) {
+                    m_pages.emplace_back(std::make_unique_for_overwrite<page_t>());
+                }
+
+                std::construct_at(this->slot(index), std::forward<Args>(args)...);
+
                 m_slots_generation.emplace_back(0);
                 m_slots_alive.emplace_back(true);
             }
             return pointer_t(index, m_slots_generation[index]);
         }
 
-        FORR_NODISCARD pointer_t create(_Ty&& value) {
-            //std::unique_lock lock(m_mutex);
-
-            handle_t index{};
-            if (!m_free_list.empty()) {
-                index = m_free_list.back();
-                m_free_list.pop_back();
-
-                m_slots_object[index] = std::move(value);
-                m_slots_alive[index]  = true;
-                m_slots_generation[index]++;
-            }
-            else {
-                index = static_cast<handle_t>(m_slots_generation.size());
+        FORR_NODISCARD pointer_t create(const _Ty& value) {
+            return this->emplace(value);
+        }
 
-                m_slots_object.emplace_back(std::move(value));
-                m_slots_generation.emplace_back(0);
-                m_slots_alive.emplace_back(true);
-            }
-            return pointer_t(index, m_slots_generation[index]);
+        FORR_NODISCARD pointer_t create(_Ty&& value) {
+            return this->emplace(std::move(value));
         }
 
         FORR_NODISCARD pointer_t create()
             requires std::default_initializable<_Ty>
         {
-            return create(_Ty{});
+            return this->emplace();
         }
 
         void destroy(pointer_t handle) {
-            //std::unique_lock lock(m_mutex);
             if (!is_valid_locked(handle)) return;
 
-            m_slots_object[handle.m_index].~_Ty();
+            std::destroy_at(this->slot(handle.m_index));
             m_slots_alive[handle.m_index] = false;
 
             m_free_list.push_back(handle.m_index);
         }
 
+        // destroys all objects. pages stay allocated, so capacity() is not changed.
+        // all pointers become invalid, generations are kept, so old pointers won't match new objects
+        void clear() {
+            m_free_list.reserve(m_slots_alive.size()); // throws before anything is destroyed
+
+            for (size_t i = 0; i < m_slots_alive.size(); i++) {
+                if (m_slots_alive[i]) m_free_list.push_back(static_cast<handle_t>(i));
+            }
+
+            this->destroy_all();
+        }
+
+        // allocates pages to hold at least 'count' objects without allocating new pages
+        void reserve(size_t count) {
+            size_t page_count = (count + _PageCapacity - 1) / _PageCapacity;
+            if (page_count <= m_pages.size()) return;
+
+            m_pages.reserve(page_count);
+            while (m_pages.size() < page_count) {
+                m_pages.emplace_back(std::make_unique_for_overwrite<page_t>());
+            }
+
+            m_slots_generation.reserve(count);
+            m_slots_alive.reserve(count);
+        }
+
         FORR_NODISCARD _Ty* get(pointer_t handle) noexcept {
-            //std::shared_lock lock(m_mutex);
             if (!is_valid_locked(handle)) return nullptr;
-            return std::addressof(m_slots_object[handle.m_index]);
+            return this->slot(handle.m_index);
         }
 
         FORR_NODISCARD const _Ty* get(pointer_t handle) const noexcept {
-            //std::shared_lock lock(m_mutex);
             if (!is_valid_locked(handle)) return nullptr;
-            return std::addressof(m_slots_object[handle.m_index]);
+            return this->slot(handle.m_index);
         }
 
         FORR_NODISCARD bool is_valid(pointer_t handle) const noexcept {
-            //std::shared_lock lock(m_mutex);
             return is_valid_locked(handle);
         }
 
         FORR_NODISCARD size_t live_count() const noexcept {
-            //std::shared_lock lock(m_mutex);
             return m_slots_alive.size() - m_free_list.size();
         }
 
+        // how many objects can be stored without allocating a new page
+        FORR_NODISCARD size_t capacity() const noexcept {
+            return m_pages.size() * _PageCapacity;
+        }
+
         // this function runs your lambda through all objects of the storage.
         // it can be invoked by :
         // [](_Ty&, fe::pointer<_Ty>) -> void {}
@@ -194,18 +234,19 @@ namespace fe {
         // [](const _Ty&) -> void {}
         template <typename _Func>
         void for_each(_Func&& func) {
-            //std::shared_lock lock(m_mutex);
-            for (size_t i = 0; i < m_slots_object.size(); i++) {
+            for (size_t i = 0; i < m_slots_alive.size(); i++) {
                 if (!m_slots_alive[i]) continue;
 
+                _Ty& object = *this->slot(i);
+
                 if constexpr (std::is_invocable_v<_Func, _Ty&, pointer_t>) {
-                    func(m_slots_object[i], pointer_t(i, m_slots_generation[i]));
+                    func(object, pointer_t(i, m_slots_generation[i]));
                 }
                 else if constexpr (std::is_invocable_v<_Func, pointer_t, _Ty&>) {
-                    func(pointer_t(i, m_slots_generation[i]), m_slots_object[i]);
+                    func(pointer_t(i, m_slots_generation[i]), object);
                 }
                 else if constexpr (std::is_invocable_v<_Func, _Ty&>) {
-                    func(m_slots_object[i]);
+                    func(object);
                 }
                 else if constexpr (std::is_invocable_v<_Func, pointer_t>) {
                     func(pointer_t(i, m_slots_generation[i]));
@@ -224,18 +265,19 @@ namespace fe {
         // [](const _Ty&) -> void {}
         template <typename _Func>
         void for_each(_Func&& func) const {
-            //std::shared_lock lock(m_mutex);
-            for (size_t i = 0; i < m_slots_object.size(); i++) {
+            for (size_t i = 0; i < m_slots_alive.size(); i++) {
                 if (!m_slots_alive[i]) continue;
 
+                const _Ty& object = *this->slot(i);
+
                 if constexpr (std::is_invocable_v<_Func, const _Ty&, pointer_t>) {
-                    func(m_slots_object[i], pointer_t(i, m_slots_generation[i]));
+                    func(object, pointer_t(i, m_slots_generation[i]));
                 }
                 else if constexpr (std::is_invocable_v<_Func, pointer_t, const _Ty&>) {
-                    func(pointer_t(i, m_slots_generation[i]), m_slots_object[i]);
+                    func(pointer_t(i, m_slots_generation[i]), object);
                 }
                 else if constexpr (std::is_invocable_v<_Func, const _Ty&>) {
-                    func(m_slots_object[i]);
+                    func(object);
                 }
                 else if constexpr (std::is_invocable_v<_Func, pointer_t>) {
                     func(pointer_t(i, m_slots_generation[i]));
@@ -253,15 +295,339 @@ namespace fe {
             return m_slots_generation[handle.m_index] == handle.m_generation;
         }
 
+        // doesn't touch the free list, so it can't throw
+        void destroy_all() noexcept {
+            for (size_t i = 0; i < m_slots_alive.size(); i++) {
+                if (!m_slots_alive[i]) continue;
+
+                std::destroy_at(this->slot(i));
+                m_slots_alive[i] = false;
+            }
+        }
+
+        // the slot memory must be allocated. it doesn't check if the object is alive
+        FORR_NODISCARD FORR_FORCE_INLINE _Ty* slot(size_t index) const noexcept {
+            std::byte* page = m_pages[index / _PageCapacity]->data;
+            return std::launder(reinterpret_cast<_Ty*>(page) + (index % _PageCapacity));
+        }
+
         // devided to be more cache friendly
-        std::vector<_Ty>      m_slots_object;
-        std::vector<handle_t> m_slots_generation;
-        std::vector<bool>     m_slots_alive;
+        std::vector<std::unique_ptr<page_t>> m_pages;
+        std::vector<handle_t>                m_slots_generation;
+        std::vector<bool>                    m_slots_alive;
         //
 
         std::vector<handle_t> m_free_list;
 
-        //mutable std::shared_mutex m_mutex; // this is removed for now
+        // not thread-safe. use fe::concurrent_pointer_storage if you need to access it from multiple threads
+    };
+
+    // thread-safe version of fe::typed_pointer_storage.
+    // - emplace() takes a slot from the free list of the calling thread's shard, of other shards or a new index ( atomic counter )
+    // - is_valid() and get() are lock-free
+    // - destroy() only retires the slot. the object is destroyed and the slot is reused only in reclaim(),
+    //   so '_Ty*' from get() stays valid until the next reclaim() ( call it once per frame from a single thread )
+    // capacity is limited by _MaxPages * _PageCapacity objects
+    template <storable_t _Ty, size_t _PageCapacity = 256, size_t _MaxPages = 4096>
+    class concurrent_pointer_storage {
+        static_assert(_PageCapacity > 0 && (_PageCapacity & (_PageCapacity - 1)) == 0, "fe::concurrent_pointer_storage : page capacity must be a power of two");
+
+        // slot state : ( generation << 1 ) | alive
+        using state_t = uint64_t;
+
+        struct page_t {
+            alignas(_Ty) std::byte data[sizeof(_Ty) * _PageCapacity];
+            std::atomic<state_t>   states[_PageCapacity]{};
+        };
+
+        struct alignas(64) shard_t { // aligned to avoid false sharing between threads
+            std::mutex            mutex;
+            std::vector<handle_t> free_list;
+        };
+
+        inline static constexpr size_t SHARD_COUNT = 8;
+
+    public:
+        using pointer_t = pointer<_Ty>;
+
+        inline static constexpr size_t page_capacity = _PageCapacity;
+        inline static constexpr size_t max_capacity  = _PageCapacity * _MaxPages;
+
+        concurrent_pointer_storage() = default;
+        ~concurrent_pointer_storage() {
+            this->reclaim();
+
+            size_t count = std::min<size_t>(m_next_index.load(std::memory_order_acquire), max_capacity);
+            for (size_t i = 0; i < count; i++) {
+                page_t* page = m_pages[i / _PageCapacity].load(std::memory_order_acquire);
+                if (page == nullptr) continue;
+
+                if (page->states[i % _PageCapacity].load(std::memory_order_acquire) & 1) {
+                    std::destroy_at(this->slot(page, i));
+                }
+            }
+
+            for (auto& page : m_pages) {
+                delete page.load(std::memory_order_acquire);
+            }
+        }
+
+        FORR_CLASS_NONCOPYABLE(concurrent_pointer_storage)
+
+        template <typename... Args>
+        FORR_NODISCARD pointer_t emplace(Args&&... args) {
+            handle_t index{};
+            if (!this->pop_free_index(index)) {
+                size_t new_index = m_next_index.fetch_add(1, std::memory_order_relaxed);
+                if (new_index >= max_capacity) {
+                    assert(false && "fe::concurrent_pointer_storage : storage is full");
+                    return {};
+                }
+                index = static_cast<handle_t>(new_index);
+            }
+
+            page_t* page = this->acquire_page(index / _PageCapacity);
+
+            std::atomic<state_t>& state = page->states[index % _PageCapacity];
+
+            // the slot is owned by this thread now, nobody else can write its state.
+            // dead slots already keep the next generation ( see destroy() )
+            auto generation = static_cast<handle_t>(state.load(std::memory_order_relaxed) >> 1);
+
+            try {
+                std::construct_at(this->slot(page, index), std::forward<Args>(args)...);
+            }
+            catch (...) {
+                this->push_free_index(index);
+                throw;
+            }
+
+            state.store((static_cast<state_t>(generation) << 1) | 1, std::memory_order_release); // publish the object
+            m_live_count.fetch_add(1, std::memory_order_relaxed);
+
+            return pointer_t(index, generation);
+        }
+
+        FORR_NODISCARD pointer_t create(const _Ty& value) {
+            return this->emplace(value);
+        }
+
+        FORR_NODISCARD pointer_t create(_Ty&& value) {
+            return this->emplace(std::move(value));
+        }
+
+        FORR_NODISCARD pointer_t create()
+            requires std::default_initializable<_Ty>
+        {
+            return this->emplace();
+        }
+
+        // the object is not destroyed here. it will be destroyed in reclaim()
+        void destroy(pointer_t handle) {
+            std::atomic<state_t>* state = this->find_state(handle.index());
+            if (state == nullptr) return;
+
+            state_t alive_state = (static_cast<state_t>(handle.generation()) << 1) | 1;
+            state_t dead_state  = static_cast<state_t>(handle.generation() + 1) << 1; // the next owner of the slot gets new generation
+
+            if (!state->compare_exchange_strong(alive_state, dead_state, std::memory_order_acq_rel)) {
+                return; // already destroyed or the pointer is outdated
+            }
+
+            m_live_count.fetch_sub(1, std::memory_order_relaxed);
+
+            std::lock_guard lock(m_retired_mutex);
+            m_retired.push_back(handle.index());
+        }
+
+        // destroys retired objects and returns their slots to the free lists.
+        // nobody may use '_Ty*' of destroyed objects after this call
+        void reclaim() {
+            std::vector<handle_t> retired{};
+            {
+                std::lock_guard lock(m_retired_mutex);
+                if (m_retired.empty()) return;
+                retired.swap(m_retired);
+            }
+
+            for (handle_t index : retired) {
+                page_t* page = m_pages[index / _PageCapacity].load(std::memory_order_acquire);
+                std::destroy_at(this->slot(page, index));
+            }
+
+            for (size_t i = 0; i < retired.size(); i++) {
+                shard_t&    shard = m_shards[i % SHARD_COUNT];
+                std::lock_guard lock(shard.mutex);
+                shard.free_list.push_back(retired[i]);
+            }
+        }
+
+        // allocates pages to hold at least 'count' objects
+        void reserve(size_t count) {
+            size_t page_count = std::min((count + _PageCapacity - 1) / _PageCapacity, _MaxPages);
+            for (size_t i = 0; i < page_count; i++) {
+                FORR_ALLOW_DISCARD this->acquire_page(i);
+            }
+        }
+
+        FORR_NODISCARD _Ty* get(pointer_t handle) noexcept {
+            return const_cast<_Ty*>(std::as_const(*this).get(handle));
+        }
+
+        FORR_NODISCARD const _Ty* get(pointer_t handle) const noexcept {
+            if (handle.index() >= max_capacity) return nullptr;
+
+            page_t* page = m_pages[handle.index() / _PageCapacity].load(std::memory_order_acquire);
+            if (page == nullptr) return nullptr;
+
+            state_t state = page->states[handle.index() % _PageCapacity].load(std::memory_order_acquire);
+            if (state != ((static_cast<state_t>(handle.generation()) << 1) | 1)) return nullptr;
+
+            return this->slot(page, handle.index());
+        }
+
+        FORR_NODISCARD bool is_valid(pointer_t handle) const noexcept {
+            return this->get(handle) != nullptr;
+        }
+
+        FORR_NODISCARD size_t live_count() const noexcept {
+            return m_live_count.load(std::memory_order_relaxed);
+        }
+
+        FORR_NODISCARD size_t capacity() const noexcept {
+            return m_page_count.load(std::memory_order_relaxed) * _PageCapacity;
+        }
+
+        // the same signatures as fe::typed_pointer_storage::for_each().
+        // objects, created while iterating, may be skipped. don't destroy objects from other threads while iterating
+        template <typename _Func>
+        void for_each(_Func&& func) {
+            size_t count = std::min<size_t>(m_next_index.load(std::memory_order_acquire), max_capacity);
+            for (size_t i = 0; i < count; i++) {
+                page_t* page = m_pages[i / _PageCapacity].load(std::memory_order_acquire);
+                if (page == nullptr) continue;
+
+                state_t state = page->states[i % _PageCapacity].load(std::memory_order_acquire);
+                if ((state & 1) == 0) continue;
+
+                _Ty&      object = *this->slot(page, i);
+                pointer_t handle(static_cast<handle_t>(i), static_cast<handle_t>(state >> 1));
+
+                if constexpr (std::is_invocable_v<_Func, _Ty&, pointer_t>) {
+                    func(object, handle);
+                }
+                else if constexpr (std::is_invocable_v<_Func, pointer_t, _Ty&>) {
+                    func(handle, object);
+                }
+                else if constexpr (std::is_invocable_v<_Func, _Ty&>) {
+                    func(object);
+                }
+                else if constexpr (std::is_invocable_v<_Func, pointer_t>) {
+                    func(handle);
+                }
+                else {
+                    static_assert(false, "fe::concurrent_pointer_storage : for_each lambda has invalid signature");
+                }
+            }
+        }
+
+        template <typename _Func>
+        void for_each(_Func&& func) const {
+            size_t count = std::min<size_t>(m_next_index.load(std::memory_order_acquire), max_capacity);
+            for (size_t i = 0; i < count; i++) {
+                page_t* page = m_pages[i / _PageCapacity].load(std::memory_order_acquire);
+                if (page == nullptr) continue;
+
+                state_t state = page->states[i % _PageCapacity].load(std::memory_order_acquire);
+                if ((state & 1) == 0) continue;
+
+                const _Ty& object = *this->slot(page, i);
+                pointer_t  handle(static_cast<handle_t>(i), static_cast<handle_t>(state >> 1));
+
+                if constexpr (std::is_invocable_v<_Func, const _Ty&, pointer_t>) {
+                    func(object, handle);
+                }
+                else if constexpr (std::is_invocable_v<_Func, pointer_t, const _Ty&>) {
+                    func(handle, object);
+                }
+                else if constexpr (std::is_invocable_v<_Func, const _Ty&>) {
+                    func(object);
+                }
+                else if constexpr (std::is_invocable_v<_Func, pointer_t>) {
+                    func(handle);
+                }
+                else {
+                    static_assert(false, "fe::concurrent_pointer_storage : const for_each lambda has invalid signature");
+                }
+            }
+        }
+
+    private:
+        FORR_NODISCARD static size_t this_thread_shard() noexcept {
+            static std::atomic<size_t> next_shard{};
+            thread_local size_t        shard = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+            return shard;
+        }
+
+        // the own shard first, then the others. reclaim() spreads slots over every shard, and a thread, which creates
+        // most of the objects, would grow the storage while other shards keep free slots
+        FORR_NODISCARD bool pop_free_index(handle_t& index) {
+            size_t first = this_thread_shard();
+            for (size_t i = 0; i < SHARD_COUNT; i++) {
+                shard_t&        shard = m_shards[(first + i) % SHARD_COUNT];
+                std::lock_guard lock(shard.mutex);
+                if (shard.free_list.empty()) continue;
+
+                index = shard.free_list.back();
+                shard.free_list.pop_back();
+                return true;
+            }
+            return false;
+        }
+
+        void push_free_index(handle_t index) {
+            shard_t&        shard = m_shards[this_thread_shard()];
+            std::lock_guard lock(shard.mutex);
+            shard.free_list.push_back(index);
+        }
+
+        // returns the page, allocates it if needed. the first thread, which publishes the page, wins
+        FORR_NODISCARD page_t* acquire_page(size_t page_index) {
+            page_t* page = m_pages[page_index].load(std::memory_order_acquire);
+            if (page != nullptr) return page;
+
+            auto* new_page = new page_t();
+            if (m_pages[page_index].compare_exchange_strong(page, new_page, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                m_page_count.fetch_add(1, std::memory_order_relaxed);
+                return new_page;
+            }
+
+            delete new_page; // another thread was faster. 'page' contains its page now
+            return page;
+        }
+
+        FORR_NODISCARD std::atomic<state_t>* find_state(handle_t index) const noexcept {
+            if (index >= max_capacity) return nullptr;
+
+            page_t* page = m_pages[index / _PageCapacity].load(std::memory_order_acquire);
+            if (page == nullptr) return nullptr;
+
+            return &page->states[index % _PageCapacity];
+        }
+
+        FORR_NODISCARD static _Ty* slot(page_t* page, size_t index) noexcept {
+            return std::launder(reinterpret_cast<_Ty*>(page->data) + (index % _PageCapacity));
+        }
+
+        std::array<std::atomic<page_t*>, _MaxPages> m_pages{};
+        std::atomic<size_t>                         m_page_count{};
+        std::atomic<size_t>                         m_next_index{};
+        std::atomic<size_t>                         m_live_count{};
+
+        std::array<shard_t, SHARD_COUNT> m_shards{};
+
+        std::mutex            m_retired_mutex;
+        std::vector<handle_t> m_retired;
     };
 
     struct base_storage {
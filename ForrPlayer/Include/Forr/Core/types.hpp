@@ -29,11 +29,15 @@ namespace fe {
     // this is needed for GPU resource managers
     template <typename T>
     struct GPUHandle {
-        size_t index{};
+        inline static constexpr size_t INVALID_INDEX = ~size_t(0);
+
+        size_t index{ INVALID_INDEX }; // invalid until the GPU resource manager creates the resource
 
         GPUHandle()  = default;
         ~GPUHandle() = default;
 
         explicit GPUHandle(size_t index) : index(index) {}
+
+        FORR_NODISCARD constexpr bool is_valid() const noexcept { return index != INVALID_INDEX; }
     };
 } // namespace fe
@@ -0,0 +1,74 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ClusterCulling.hpp
+    Role : meshlets and their culling by the frustum and normal cones
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+
+#include "GPUTypes.hpp"
+
+namespace fe {
+    class Camera;
+
+    // limits of a meshlet. they fit mesh shader outputs of every vendor
+    inline constexpr uint32_t MAX_MESHLET_VERTICES  = 64;
+    inline constexpr uint32_t MAX_MESHLET_TRIANGLES = 124;
+
+    // a cluster of nearby triangles, a contiguous range of the indices of the mesh. bounds are in the space of the model
+    struct Meshlet {
+        uint32_t index_offset{};
+        uint32_t index_count{};
+        uint32_t vertex_count{}; // different vertices of its triangles
+
+        BoundingSphere bounds{};
+        glm::vec3      aabb_min{};
+        glm::vec3      aabb_max{};
+
+        // normals of every triangle are within the cone around 'cone_axis'. 'cone_cutoff' is the sine of its half angle,
+        // 1 if the triangles face too many ways and the meshlet is never back-facing as a whole
+        glm::vec3 cone_axis{ 0.0f, 0.0f, 1.0f };
+        float     cone_cutoff{ 1.0f };
+
+        Meshlet()  = default;
+        ~Meshlet() = default;
+    };
+
+    struct IndexRange {
+        uint32_t index_offset{};
+        uint32_t index_count{};
+    };
+
+    // CPU culling of meshlets against the camera of the frame. tests are made in the space of the model,
+    // so transforms with any scale are handled without touching the meshlets
+    class ClusterCuller {
+    public:
+        void beginFrame(const Camera& camera);
+
+        // false if the sphere is out of the frustum
+        FORR_NODISCARD bool isVisible(const glm::mat4& transform, const BoundingSphere& bounds) const;
+
+        // appends the index ranges of meshlets that are in the frustum and not back-facing. neighbouring ranges are merged,
+        // so a mostly visible mesh is still drawn with a few ranges
+        void cull(const glm::mat4& transform, std::span<const Meshlet> meshlets, std::pmr::vector<IndexRange>& ranges) const;
+
+        void                setEnabled(bool is_enabled) noexcept { m_IsEnabled = is_enabled; }
+        FORR_NODISCARD bool isEnabled() const noexcept { return m_IsEnabled; }
+
+    private:
+        bool m_IsEnabled{ true };
+
+        glm::mat4 m_ViewProjection{ 1.0f };
+        glm::vec3 m_EyePosition{};
+    };
+} // namespace fe
@@ -12,33 +12,35 @@
 
 #pragma once
 #include "Core/pointer.hpp"
+#include "Core/memory_tracking.hpp"
 
 #include <variant>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_precision.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/rotate_vector.hpp>
 #include <glm/gtx/vector_angle.hpp>
 
 namespace fe {
     //#pragma pack(push, 1) // disabled for now
-    struct Vertex {
-        glm::vec3 position{};
-        //glm::vec3    normal;
-        //glm::vec2    texture_coord;
-        //glm::u16vec4 joints;
-        //glm::vec4    weights;
-        //glm::vec4    tangent;
 
-        Vertex(const glm::vec3& position)
-            : position(position) {}
+    // quantized vertex, 28 bytes. how to encode and decode it is in "Graphics/VertexFormat.hpp".
+    // the GPU gets only the attributes the mesh has ( see VertexLayout ), in the order of the fields
+    struct Vertex {
+        glm::u16vec4 position{};      // unorm16 in the box of VertexQuantization. w is the handedness of the tangent : 0 - -1, 65535 - +1
+        glm::i16vec2 normal{};        // octahedral, snorm16
+        glm::i16vec2 tangent{};       // octahedral, snorm16
+        glm::u16vec2 texture_coord{}; // half float, or unorm16 if VertexFormat::unorm_texture_coords
+        glm::u8vec4  joints{};
+        glm::u8vec4  weights{};       // unorm8, the sum is 255
 
         Vertex()  = default;
         ~Vertex() = default;
     };
 
-    using Index = uint32_t; // convert all to uint32_t ( at least for now )
+    using Index = uint32_t; // on the CPU. see index_type_for()
 
     struct ShaderData {
         glm::mat4 projection_matrix{};
@@ -66,6 +68,29 @@ namespace fe {
         UNSIGNED_INT,
     };
 
-    using Vertices = std::vector<Vertex>;
-    using Indices  = std::vector<Index>;
+    FORR_NODISCARD constexpr size_t index_size(RenderIndexType type) noexcept {
+        switch (type) {
+            case RenderIndexType::UNSIGNED_BYTE: return 1;
+            case RenderIndexType::UNSIGNED_SHORT: return 2;
+            default: return 4;
+        }
+    }
+
+    // meshes keep fe::Index on the CPU, files and GPU buffers get the narrowest type that fits.
+    // 0xFFFF isn't used by 16-bit indices, it's the primitive restart index
+    FORR_NODISCARD constexpr RenderIndexType index_type_for(size_t vertex_count) noexcept {
+        return vertex_count <= 0xFFFF ? RenderIndexType::UNSIGNED_SHORT : RenderIndexType::UNSIGNED_INT;
+    }
+
+    // in the space of the model, before quantization
+    struct BoundingSphere {
+        glm::vec3 center{};
+        float     radius{};
+
+        BoundingSphere()  = default;
+        ~BoundingSphere() = default;
+    };
+
+    using Vertices = fe::tagged_vector<Vertex, MemoryTag::Meshes>;
+    using Indices  = fe::tagged_vector<Index, MemoryTag::Meshes>;
 } // namespace fe
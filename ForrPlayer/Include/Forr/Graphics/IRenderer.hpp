@@ -14,6 +14,7 @@
 #include <string>
 #include "Platform/IPlatformSystem.hpp"
 #include "Core/types.hpp"
+#include "Core/custom_allocators.hpp"
 
 #include "ResourceManagement/ResourceManager.hpp"
 
@@ -24,6 +25,12 @@ namespace fe {
 
         bool validation_enabled = true;
 
+        // coarser levels of detail of meshes are drawn while their error is smaller than this on the screen, in pixels. 0 - full meshes only
+        float lod_pixel_error = 1.0f;
+
+        // meshlets out of the frustum or facing away from the camera aren't drawn
+        bool cluster_culling_enabled = true;
+
         std::string application_name{};
         WindowDesc  primary_window_desc{};
 
@@ -71,6 +78,10 @@ namespace fe {
         virtual void Draw(DrawMeshCommand command) = 0;
         virtual void EndFrame()                    = 0;
 
+        // memory that lives until the GPU is done with the current frame.
+        // use it for per-frame data ( draw lists etc. ) with fe::ArenaResource
+        virtual fe::Arena& GetFrameArena() = 0;
+
         // TODO : remove this. It should work other way
         virtual void InitializeGPUResources() = 0;
     };
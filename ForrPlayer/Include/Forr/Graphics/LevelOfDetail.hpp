@@ -0,0 +1,98 @@
+/*===============================================
+
+    Forr Engine
+
+    File : LevelOfDetail.hpp
+    Role : levels of detail of meshes and their selection by the error on the screen
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+
+#include "GPUTypes.hpp"
+#include "Core/hash.hpp"
+
+namespace fe {
+    class Camera;
+
+    // how the importer makes the levels of detail of triangle lists. every level is simplified from the full mesh
+    struct LodSettings {
+        uint32_t max_levels{ 4 };   // besides the full mesh. 0 - no levels are made
+        float    reduction{ 0.5f }; // triangles of a level, relative to the previous one
+        float    max_error{ 0.1f }; // the largest distance a level moves the surface, relative to the radius of the mesh
+
+        // the levels are a part of imported models, so the settings are hashed into their keys
+        FORR_NODISCARD uint64_t hash(uint64_t seed) const noexcept {
+            seed = hash_combine(seed, max_levels);
+            seed = hash_combine(seed, std::bit_cast<uint32_t>(reduction));
+            return hash_combine(seed, std::bit_cast<uint32_t>(max_error));
+        }
+
+        LodSettings()  = default;
+        ~LodSettings() = default;
+    };
+
+    // indices of a level, in the indices of the mesh
+    struct MeshLod {
+        int   index_offset{};
+        int   index_count{};
+        float error{}; // the largest distance from the full mesh, in the space of the model
+
+        int meshlet_offset{}; // in the meshlets of the mesh, they cover the indices of the level
+        int meshlet_count{};
+
+        MeshLod()  = default;
+        ~MeshLod() = default;
+    };
+
+    // picks a level of detail for every drawn primitive, the coarsest one whose error is smaller than 'pixel_error' on the screen.
+    // a level is kept until the error crosses the limit by 'hysteresis', so objects near the limit don't switch levels every frame.
+    // draws are told apart by keys, see instanceKey()
+    class LodSelector {
+    public:
+        void beginFrame(const Camera& camera, float viewport_height);
+
+        // the key of the object in this frame. the same object drawn several times gets different keys, in the order of the draws
+        FORR_NODISCARD uint64_t instanceKey(uint64_t object);
+
+        // level 0 is the full mesh, level i is lods[i - 1]. 'transform' takes the model to the world
+        FORR_NODISCARD uint32_t select(uint64_t key, const BoundingSphere& bounds, const glm::mat4& transform, std::span<const MeshLod> lods);
+
+        void setPixelError(float pixel_error) noexcept { m_PixelError = pixel_error; }
+        void setHysteresis(float hysteresis) noexcept { m_Hysteresis = hysteresis; }
+
+        FORR_NODISCARD float getPixelError() const noexcept { return m_PixelError; }
+        FORR_NODISCARD float getHysteresis() const noexcept { return m_Hysteresis; }
+
+    private:
+        struct Entry {
+            uint32_t lod{};
+            uint64_t frame{}; // when it was selected last time
+        };
+
+        struct Occurrence {
+            uint32_t count{};
+            uint64_t frame{}; // of the count, it starts again from 0 in a new frame
+        };
+
+        float m_PixelError{ 1.0f };
+        float m_Hysteresis{ 0.25f };
+
+        glm::vec3 m_EyePosition{};
+        float     m_NearClip{};
+        float     m_PixelsPerUnit{}; // on the screen, of a length 1 unit away from the eye
+
+        uint64_t m_Frame{};
+
+        std::unordered_map<uint64_t, Entry>      m_Entries{};     // by key. entries of objects that weren't drawn last frame are removed
+        std::unordered_map<uint64_t, Occurrence> m_Occurrences{}; // draws of every object. kept between frames, so drawing doesn't allocate
+    };
+} // namespace fe
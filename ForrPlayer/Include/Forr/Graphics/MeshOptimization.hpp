@@ -0,0 +1,99 @@
+/*===============================================
+
+    Forr Engine
+
+    File : MeshOptimization.hpp
+    Role : reordering of indices and vertices for the post-transform cache, overdraw and vertex fetch. simplification, meshlets
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "GPUTypes.hpp"
+#include "ClusterCulling.hpp"
+
+namespace fe {
+    // the cache the reordering is tuned for. FIFO, as on most GPUs
+    inline constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+    // a vertex that no index uses, in a remap
+    inline constexpr Index UNUSED_VERTEX = std::numeric_limits<Index>::max();
+
+    // vertex shader invocations of a triangle list on a FIFO cache. statistics of several lists can be added
+    struct VertexCacheStatistics {
+        size_t transformed{}; // cache misses
+        size_t triangles{};
+        size_t vertices{}; // used by the list
+
+        // average cache miss ratio, per triangle. 0.5 at best, 3 at worst
+        FORR_NODISCARD constexpr float acmr() const noexcept { return triangles ? static_cast<float>(transformed) / static_cast<float>(triangles) : 0.0f; }
+        // average transform to vertex ratio. 1 at best
+        FORR_NODISCARD constexpr float atvr() const noexcept { return vertices ? static_cast<float>(transformed) / static_cast<float>(vertices) : 0.0f; }
+
+        constexpr VertexCacheStatistics& operator+=(const VertexCacheStatistics& other) noexcept {
+            transformed += other.transformed;
+            triangles += other.triangles;
+            vertices += other.vertices;
+            return *this;
+        }
+
+        VertexCacheStatistics()  = default;
+        ~VertexCacheStatistics() = default;
+    };
+
+    FORR_NODISCARD VertexCacheStatistics FORR_API analyze_vertex_cache(std::span<const Index> indices, size_t vertex_count, uint32_t cache_size = VERTEX_CACHE_SIZE);
+
+    // welding. 'remap' has 'vertex_count' elements, remap[i] is the new index of vertex i. vertices with equal bytes get the same one,
+    // in the order they are first met. returns the count of unique vertices
+    FORR_NODISCARD size_t FORR_API generate_vertex_remap(const void* vertices, size_t vertex_count, size_t vertex_size, std::span<Index> remap);
+
+    // vertices in the order the indices use them first, so vertex fetch goes forward through memory.
+    // vertices that no index uses get UNUSED_VERTEX. returns the count of used vertices
+    FORR_NODISCARD size_t FORR_API generate_vertex_fetch_remap(std::span<const Index> indices, size_t vertex_count, std::span<Index> remap);
+
+    void FORR_API remap_indices(std::span<Index> indices, std::span<const Index> remap) noexcept;
+
+    // 'unique_count' is what generate_vertex_remap() or generate_vertex_fetch_remap() returned
+    template <typename T, typename Allocator>
+    void remap_vertices(std::vector<T, Allocator>& vertices, std::span<const Index> remap, size_t unique_count) {
+        std::vector<T, Allocator> result(unique_count, vertices.get_allocator());
+
+        for (size_t i = 0; i < vertices.size(); i++) {
+            if (remap[i] != UNUSED_VERTEX) result[remap[i]] = vertices[i];
+        }
+
+        vertices = std::move(result);
+    }
+
+    // Tipsify ( Sander, Nehab, Barczak 2007 ). reorders the triangles of a list, the winding of each triangle is kept.
+    // 'clusters' gets the first triangles of runs that start with a cold cache, the first one is 0
+    void FORR_API optimize_vertex_cache(std::span<Index> indices, size_t vertex_count, std::vector<uint32_t>* clusters = nullptr,
+                                        uint32_t cache_size = VERTEX_CACHE_SIZE);
+
+    // reorders 'clusters' of optimize_vertex_cache() so the ones that face outwards of the mesh are drawn first and hide the rest.
+    // clusters are split further while it costs less than 'threshold' times their ACMR
+    void FORR_API optimize_overdraw(std::span<Index> indices, std::span<const glm::vec3> positions, std::span<const uint32_t> clusters,
+                                    float threshold = 1.05f, uint32_t cache_size = VERTEX_CACHE_SIZE);
+
+    // splits a triangle list into meshlets and reorders its triangles, so every meshlet is a contiguous range of 'indices'.
+    // a meshlet starts at the first triangle left and grows over triangles that add the fewest vertices, facing its way.
+    // triangles keep their order inside of a meshlet. meshlets are appended, their 'index_offset' is relative to 'indices'
+    void FORR_API build_meshlets(std::span<Index> indices, std::span<const glm::vec3> positions, std::vector<Meshlet>& meshlets,
+                                 uint32_t max_vertices = MAX_MESHLET_VERTICES, uint32_t max_triangles = MAX_MESHLET_TRIANGLES);
+
+    // quadric error edge collapse ( Garland, Heckbert 1997 ) of a triangle list. vertices are collapsed onto their neighbours, no new ones are made.
+    // vertices on borders and attribute seams ( several vertices at one position ) stay, collapses that flip a triangle are skipped.
+    // stops at 'target_index_count' or when the next collapse moves the surface further than 'target_error'.
+    // 'destination' has room for indices.size() indices. returns the count written, 'result_error' gets the largest distance made
+    FORR_NODISCARD size_t FORR_API simplify(std::span<const Index> indices, std::span<const glm::vec3> positions, size_t target_index_count, float target_error,
+                                            std::span<Index> destination, float* result_error = nullptr);
+} // namespace fe
@@ -11,16 +11,49 @@
 ===============================================*/
 
 #pragma once
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "Core/types.hpp"
 #include "ResourceManagement/Resources.hpp"
 
 namespace fe {
+    // one shader of ShaderCompiler::CompileBatch(). the source has to live until the batch is compiled
+    struct ShaderCompileRequest {
+        std::string_view       source{};
+        resource::Shader::Type type{};
+        GraphicsBackend        graphics_backend{};
+
+        std::vector<std::string> defines{}; // keywords of the variant, see ShaderVariants
+
+        std::filesystem::path name{}; // only for the log
+
+        ShaderCompileRequest()  = default;
+        ~ShaderCompileRequest() = default;
+    };
+
+    // every thread compiles with its own shaderc::Compiler, so Compile() can be called from any thread
     class ShaderCompiler {
     public:
+        inline static constexpr uint32_t VERSION = 1; // increase it when shaderc is updated
+
         ShaderCompiler()  = default;
         ~ShaderCompiler() = default;
 
-        static void Compile(std::vector<uint32_t>& dst, std::string_view src, resource::Shader::Type shader_type, GraphicsBackend graphics_backend);
+        // 'defines' are macros in addition to the ones of the graphics backend
+        static void Compile(resource::Shader::SourceCode& dst, std::string_view src, resource::Shader::Type shader_type, GraphicsBackend graphics_backend, std::span<const std::string> defines = {});
+
+        // compiles and reflects every request on the job system and waits. shaders[i] is the result of requests[i],
+        // so the output doesn't depend on the worker timings. a failed shader has no SPIR-V
+        static void CompileBatch(std::span<const ShaderCompileRequest> requests, std::span<resource::Shader> shaders);
+
+        // the same hash means the same SPIR-V. it covers the source and every compile option :
+        // macro definitions, target environment, GLSL version and shader kind.
+        // shaders can't #include yet, when they can, hashes of the included files have to be added here
+        FORR_NODISCARD static uint64_t Hash(std::string_view src, resource::Shader::Type shader_type, GraphicsBackend graphics_backend, std::span<const std::string> defines = {});
 
     private:
     };
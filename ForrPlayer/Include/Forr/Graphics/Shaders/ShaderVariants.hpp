@@ -0,0 +1,49 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ShaderVariants.hpp
+    Role : compile-time permutations of shaders
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ResourceManagement/Resources.hpp"
+
+namespace fe {
+    // a shader declares its keywords in the source :
+    //
+    //     #pragma forr_keywords FORR_ALPHA_MASK FORR_VERTEX_COLOR
+    //
+    // and every permutation of them is compiled as a separate resource::Shader, with the enabled keywords defined as macros.
+    // a material takes only the variant it needs from resource::Shader::variants ( bit i of the key is keywords[i] ),
+    // so it doesn't pay for branches of features it doesn't use.
+    // things that can change without compiling again ( like a cutoff or a light count ) should be specialization constants instead,
+    // they are set per material in resource::Material::specialization_values
+    class ShaderVariants {
+    public:
+        inline static constexpr size_t MAX_KEYWORDS = 6; // 64 variants, all of them are compiled
+
+        ShaderVariants()  = default;
+        ~ShaderVariants() = default;
+
+        // keywords in the order of declaration, the bit of a keyword in a variant key is its index.
+        // false if there are more than MAX_KEYWORDS or one is declared twice
+        FORR_NODISCARD static bool ParseKeywords(std::string_view source, std::vector<std::string>& keywords);
+
+        FORR_NODISCARD static size_t GetVariantCount(size_t keyword_count) noexcept { return size_t{ 1 } << keyword_count; }
+
+        // macros defined in the variant
+        FORR_NODISCARD static std::vector<std::string> GetDefines(std::span<const std::string> keywords, uint64_t variant_key);
+
+    private:
+    };
+} // namespace fe
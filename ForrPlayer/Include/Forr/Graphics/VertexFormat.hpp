@@ -0,0 +1,137 @@
+/*===============================================
+
+    Forr Engine
+
+    File : VertexFormat.hpp
+    Role : quantization of fe::Vertex and the layout of vertex and index buffers
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "GPUTypes.hpp"
+
+namespace fe {
+    // the value is the location of the attribute in shaders
+    enum class VertexAttribute : uint8_t {
+        POSITION,
+        NORMAL,
+        TANGENT,
+        TEXTURE_COORD,
+        JOINTS,
+        WEIGHTS,
+
+        COUNT
+    };
+
+    using VertexAttributes = uint8_t; // mask of vertex_attribute_bit()
+
+    FORR_NODISCARD constexpr VertexAttributes vertex_attribute_bit(VertexAttribute attribute) noexcept {
+        return static_cast<VertexAttributes>(1u << static_cast<uint32_t>(attribute));
+    }
+
+    inline constexpr VertexAttributes ALL_VERTEX_ATTRIBUTES = static_cast<VertexAttributes>((1u << static_cast<uint32_t>(VertexAttribute::COUNT)) - 1);
+
+    // what a mesh has in its vertices. the fields of fe::Vertex that aren't in 'attributes' are zero
+    struct VertexFormat {
+        VertexAttributes attributes{ vertex_attribute_bit(VertexAttribute::POSITION) }; // the position is always there
+        bool             unorm_texture_coords{};                                        // every UV is in [0, 1], they are unorm16 instead of half floats
+
+        FORR_NODISCARD constexpr bool has(VertexAttribute attribute) const noexcept { return (attributes & vertex_attribute_bit(attribute)) != 0; }
+
+        // different keys - different vertex input state of pipelines
+        FORR_NODISCARD constexpr uint32_t key() const noexcept { return attributes | (unorm_texture_coords ? 1u << 8 : 0u); }
+
+        VertexFormat()  = default;
+        ~VertexFormat() = default;
+    };
+
+    // positions are unorm16 in the box [bias, bias + scale]. the renderers apply dequantization_matrix() before the model matrix,
+    // so shaders read them as ordinary positions
+    struct VertexQuantization {
+        glm::vec3 scale{ 1.0f };
+        glm::vec3 bias{ 0.0f };
+
+        FORR_NODISCARD glm::mat4 dequantization_matrix() const noexcept {
+            return glm::scale(glm::translate(glm::mat4(1.0f), bias), scale);
+        }
+
+        VertexQuantization()  = default;
+        ~VertexQuantization() = default;
+    };
+
+    // the smallest box around [min, max]. a flat side gets a scale of 1, so nothing is divided by zero
+    FORR_NODISCARD VertexQuantization FORR_API vertex_quantization(const glm::vec3& min, const glm::vec3& max) noexcept;
+
+    // a vertex before quantization
+    struct VertexData {
+        glm::vec3    position{};
+        glm::vec3    normal{ 0.0f, 0.0f, 1.0f };
+        glm::vec4    tangent{ 1.0f, 0.0f, 0.0f, 1.0f }; // w is the handedness
+        glm::vec2    texture_coord{};
+        glm::u16vec4 joints{};
+        glm::vec4    weights{};
+
+        VertexData()  = default;
+        ~VertexData() = default;
+    };
+
+    // the attributes that 'format' doesn't have are left zero. joints over 255 are clamped
+    FORR_NODISCARD Vertex FORR_API encode_vertex(const VertexData& data, const VertexQuantization& quantization, const VertexFormat& format) noexcept;
+    FORR_NODISCARD VertexData FORR_API decode_vertex(const Vertex& vertex, const VertexQuantization& quantization, const VertexFormat& format) noexcept;
+
+    FORR_NODISCARD glm::u16vec4 FORR_API quantize_position(const glm::vec3& position, const VertexQuantization& quantization) noexcept;
+    FORR_NODISCARD glm::vec3 FORR_API dequantize_position(const glm::u16vec4& position, const VertexQuantization& quantization) noexcept;
+
+    // octahedral mapping of a unit vector to 2 snorm16
+    FORR_NODISCARD glm::i16vec2 FORR_API encode_octahedral(const glm::vec3& direction) noexcept;
+    FORR_NODISCARD glm::vec3 FORR_API decode_octahedral(const glm::i16vec2& encoded) noexcept;
+
+    // how the GPU reads an attribute
+    enum class VertexAttributeFormat : uint8_t {
+        UNORM16x4,
+        SNORM16x2,
+        FLOAT16x2,
+        UNORM16x2,
+        UINT8x4,
+        UNORM8x4,
+    };
+
+    // an attribute in a vertex buffer. the sizes of all formats are a multiple of 4 bytes
+    struct VertexAttributeLayout {
+        bool                  enabled{};
+        uint32_t              offset{};        // in bytes, from the start of the vertex
+        uint32_t              source_offset{}; // of the field in fe::Vertex
+        uint32_t              size{};          // in bytes
+        VertexAttributeFormat format{};
+
+        VertexAttributeLayout()  = default;
+        ~VertexAttributeLayout() = default;
+    };
+
+    // vertex buffers are interleaved and have only the attributes of the mesh, in the order of VertexAttribute
+    struct VertexLayout {
+        uint32_t stride{};
+
+        std::array<VertexAttributeLayout, static_cast<size_t>(VertexAttribute::COUNT)> attributes{};
+
+        VertexLayout()  = default;
+        ~VertexLayout() = default;
+    };
+
+    FORR_NODISCARD VertexLayout FORR_API vertex_layout(const VertexFormat& format) noexcept;
+
+    // writes 'count' vertices with 'layout' to 'destination', which has 'count * layout.stride' bytes
+    void FORR_API pack_vertices(const Vertex* vertices, size_t count, const VertexLayout& layout, void* destination) noexcept;
+
+    // writes 'indices' as 'type' to 'destination', which has 'indices.size() * index_size(type)' bytes. they have to fit in 'type'
+    void FORR_API pack_indices(std::span<const Index> indices, RenderIndexType type, void* destination) noexcept;
+} // namespace fe
@@ -0,0 +1,126 @@
+/*===============================================
+
+    Forr Engine
+
+    File : AsyncResource.hpp
+    Role : handle of a resource that is being imported on the job system
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Core/pointer.hpp"
+#include "Core/job_system.hpp"
+#include "Resources.hpp"
+
+namespace fe {
+    enum class ResourceLoadState {
+        QUEUED,
+        LOADING,
+        READY,
+        FAILED
+    };
+
+    class ResourceImporter; // forward declaration
+
+    // returned by ImportResourceAsync() right away. cheap to copy, all copies share the same state
+    template <resource::resource_t T>
+    class AsyncResource {
+    public:
+        // called on the main thread ( from JobSystem::process_main_thread_jobs() )
+        using Callback = std::function<void(fe::pointer<T>, ResourceLoadState)>;
+
+        AsyncResource()  = default;
+        ~AsyncResource() = default;
+
+        FORR_NODISCARD ResourceLoadState GetState() const noexcept {
+            return m_State ? m_State->state.load(std::memory_order_acquire) : ResourceLoadState::FAILED;
+        }
+
+        FORR_NODISCARD bool IsReady() const noexcept { return this->GetState() == ResourceLoadState::READY; }
+        FORR_NODISCARD bool IsDone() const noexcept { return this->GetState() >= ResourceLoadState::READY; }
+
+        // invalid until the resource is ready. use ResourceManager::GetResourceOrFallback() to draw something meanwhile
+        FORR_NODISCARD fe::pointer<T> GetPointer() const noexcept {
+            return this->IsReady() ? m_State->pointer : fe::pointer<T>{};
+        }
+
+        FORR_NODISCARD const std::filesystem::path& GetPath() const noexcept {
+            static const std::filesystem::path empty{};
+            return m_State ? m_State->path : empty;
+        }
+
+        // if the import is already done, the callback is scheduled right away
+        void OnComplete(Callback callback) {
+            if (!m_State) return;
+
+            {
+                std::lock_guard<std::mutex> lock_guard(m_State->mutex);
+                if (m_State->state.load(std::memory_order_acquire) < ResourceLoadState::READY) {
+                    m_State->callbacks.emplace_back(std::move(callback));
+                    return;
+                }
+            }
+
+            JOBS.run_on_main_thread([callback = std::move(callback), state = m_State] {
+                callback(state->pointer, state->state.load(std::memory_order_acquire));
+            });
+        }
+
+        // blocks until the import is done. runs other jobs meanwhile
+        void Wait() const {
+            if (m_State) JOBS.wait(m_State->counter);
+        }
+
+    private:
+        friend class ResourceImporter;
+
+        struct State {
+            std::filesystem::path path{};
+
+            std::atomic<ResourceLoadState> state{ ResourceLoadState::QUEUED };
+            fe::pointer<T>                 pointer{}; // written once, before 'state' becomes READY
+
+            std::mutex            mutex{};
+            std::vector<Callback> callbacks{};
+
+            JobCounter counter{};
+        };
+
+        explicit AsyncResource(const std::filesystem::path& path) : m_State(std::make_shared<State>()) {
+            m_State->path = path;
+        }
+
+        // called by the importing job
+        static void complete(const std::shared_ptr<State>& state, fe::pointer<T> pointer, bool success) {
+            std::vector<Callback> callbacks{};
+            {
+                std::lock_guard<std::mutex> lock_guard(state->mutex);
+
+                state->pointer = pointer;
+                state->state.store(success ? ResourceLoadState::READY : ResourceLoadState::FAILED, std::memory_order_release);
+
+                callbacks.swap(state->callbacks);
+            }
+
+            if (callbacks.empty()) return;
+
+            JOBS.run_on_main_thread([callbacks = std::move(callbacks), state] {
+                for (const Callback& callback : callbacks) {
+                    callback(state->pointer, state->state.load(std::memory_order_acquire));
+                }
+            });
+        }
+
+    private:
+        std::shared_ptr<State> m_State{};
+    };
+} // namespace fe
@@ -0,0 +1,111 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ResourceCooker.hpp
+    Role : offline conversion of resources to runtime formats
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/types.hpp"
+#include "Core/job_system.hpp"
+#include "Graphics/VertexFormat.hpp"
+#include "Graphics/LevelOfDetail.hpp"
+
+namespace fe {
+    enum class TextureCompression : uint8_t {
+        NONE,    // textures are cooked as they are decoded
+        FAST,    // BC1 / BC3 / BC4 / BC5
+        QUALITY, // like FAST, but RGBA is BC7. slower to cook
+    };
+
+    struct FORR_API ResourceCookerDesc {
+        std::vector<const char*> args; // args[0] is used to find the assets folder, like in ApplicationDesc
+
+        bool force = false; // cook everything again, even if nothing was changed
+
+        TextureCompression texture_compression{ TextureCompression::QUALITY };
+
+        VertexAttributes vertex_attributes{ ALL_VERTEX_ATTRIBUTES }; // cooked meshes keep only these of their attributes
+        LodSettings      lod_settings{};                             // levels of detail of cooked meshes
+
+        JobSystemDesc job_system_desc{};
+
+        ResourceCookerDesc()  = default;
+        ~ResourceCookerDesc() = default;
+    };
+
+    struct FORR_API ResourceCookerStats {
+        size_t cooked{};
+        size_t up_to_date{};
+        size_t failed{};
+
+        double milliseconds{};
+
+        ResourceCookerStats()  = default;
+        ~ResourceCookerStats() = default;
+    };
+
+    // walks the assets folder, runs the importers and writes cooked files to PATH.getCookedAssetsPath() :
+    // .png -> .forr_texture, .gltf/.glb -> .forr_model ( only the geometry ), .vert/.frag -> .forr_shader ( one for every graphics backend ).
+    // a resource is cooked again only if the content of it or of its dependencies ( .bin, images ) or VERSION was changed.
+    // resources are cooked in parallel on the job system
+    class FORR_API ResourceCooker {
+    public:
+        inline static constexpr uint32_t VERSION = 12; // increase it when output of any importer is changed
+
+        ResourceCooker(const ResourceCookerDesc& desc);
+        ~ResourceCooker();
+
+        FORR_CLASS_NONCOPYABLE(ResourceCooker)
+
+        ResourceCookerStats Cook();
+
+        // the cooked file of the resource. empty if this resource is never cooked or it's not in the assets folder
+        FORR_NODISCARD static std::filesystem::path GetCookedPath(const std::filesystem::path& resource_full_path, GraphicsBackend graphics_backend);
+
+        // files that cooked resources read besides themselves, from the manifest. by the path of the resource relative to the assets folder,
+        // dependencies are relative to it too. resources that failed to cook or were never cooked aren't there
+        FORR_NODISCARD static std::unordered_map<std::string, std::vector<std::string>> ReadDependencies();
+
+    private:
+        struct ManifestEntry {
+            uint64_t                 hash{};         // of the content of the resource, its dependencies, VERSION and the settings
+            std::vector<std::string> dependencies{}; // relative to the assets folder
+
+            ManifestEntry()  = default;
+            ~ManifestEntry() = default;
+        };
+
+        static void readManifest(std::unordered_map<std::string, ManifestEntry>& manifest);
+
+        void loadManifest();
+        void saveManifest() const;
+
+        FORR_NODISCARD bool isUpToDate(const std::filesystem::path& resource_full_path, const std::string& relative_path) const;
+
+        // 'dependencies' gets files that the resource reads besides itself
+        FORR_NODISCARD bool cookResource(const std::filesystem::path& resource_full_path, std::vector<std::filesystem::path>& dependencies) const;
+
+        // the settings that change the cooked file are hashed too
+        FORR_NODISCARD bool hashInputs(const std::filesystem::path& resource_full_path, const std::vector<std::string>& dependencies, uint64_t& hash) const;
+
+    private:
+        bool m_Force{};
+
+        TextureCompression m_TextureCompression{};
+        VertexAttributes   m_VertexAttributes{};
+        LodSettings        m_LodSettings{};
+
+        std::unordered_map<std::string, ManifestEntry> m_Manifest{}; // by relative path of the resource
+    };
+} // namespace fe
@@ -58,6 +58,7 @@ namespace fe {
     private:
         void createDefaultShaders();
         void createDefaultMaterials();
+        void createFallbackResources();
 
     private:
         ResourceManagementContext& m_Context;
@@ -11,25 +11,146 @@
 ===============================================*/
 
 #pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
 #include "ResourceManagementContext.hpp"
 #include "ResourceStorage.hpp"
+#include "AsyncResource.hpp"
 
 namespace fe {
+    // resources that still have to be created on the GPU
+    struct ResourceUploadQueue {
+        std::vector<fe::pointer<resource::Texture>>  textures{};
+        std::vector<fe::pointer<resource::Material>> materials{};
+        std::vector<fe::pointer<resource::Model>>    models{};
+
+        // hot-reloaded resources. they have new data in the same slots, their GPU objects have to be made again in the same GPU slots
+        std::vector<fe::pointer<resource::Texture>>  reloaded_textures{};
+        std::vector<fe::pointer<resource::Material>> reloaded_materials{}; // their shaders were reloaded
+        std::vector<fe::pointer<resource::Model>>    reloaded_models{};
+        std::vector<fe::pointer<resource::Shader>>   reloaded_shaders{}; // base variants, for pipelines that are made from shaders directly
+
+        // textures that reloaded files don't have anymore. the renderer frees their GPU objects and destroys them
+        std::vector<fe::pointer<resource::Texture>> destroyed_textures{};
+
+        ResourceUploadQueue()  = default;
+        ~ResourceUploadQueue() = default;
+    };
+
+    struct GLTFImportResult; // forward declaration
+
+    // what was imported from a file. only these resources can be reloaded
+    using ImportedResource = std::variant<std::monostate, fe::pointer<resource::Texture>, fe::pointer<resource::Model>, fe::pointer<resource::Shader>>;
+
     class ResourceImporter {
     public:
-        ResourceImporter(ResourceManagementContext& context, ResourceStorage& storage) 
-            : m_Context(context), m_Storage(storage) {}
-        ~ResourceImporter() = default;
+        ResourceImporter(ResourceManagementContext& context, ResourceStorage& storage); // in the .cpp, PendingReload is complete only there
+        ~ResourceImporter();
 
         // upload resource to the storage
         void ImportResource(const std::filesystem::path& resource_full_path);
 
+        // loads all files in parallel on the job system and uploads them to the storage in the order of 'resource_full_paths'.
+        // waits until everything is uploaded
+        void ImportResources(const std::vector<std::filesystem::path>& resource_full_paths);
+
+        // shaders that aren't cooked or cached are compiled in parallel, one shaderc compiler per worker.
+        // the pointers are to the base variants in the order of 'resource_full_paths', a failed shader gets an empty pointer
+        std::vector<fe::pointer<resource::Shader>> ImportShaders(const std::vector<std::filesystem::path>& resource_full_paths);
+
         // upload resource to the storage and get its pointer
         template<typename T>
         fe::pointer<T> ImportResource(const std::filesystem::path& resource_full_path);
 
+        // returns right away, the resource is imported on the job system
+        template <resource::resource_t T>
+        FORR_NODISCARD AsyncResource<T> ImportResourceAsync(const std::filesystem::path& resource_full_path) {
+            AsyncResource<T> handle{ resource_full_path };
+
+            auto state = handle.m_State;
+            JOBS.run([this, state] {
+                state->state.store(ResourceLoadState::LOADING, std::memory_order_release);
+
+                fe::pointer<T> pointer = this->ImportResource<T>(state->path);
+
+                AsyncResource<T>::complete(state, pointer, m_Storage.GetResource(pointer) != nullptr);
+            }, &state->counter);
+
+            return handle;
+        }
+
+        // starts loading an imported file again on the job system. false if the file was never imported
+        bool ReloadResource(const std::filesystem::path& resource_full_path);
+
+        // starts importing an evicted texture or model again from the file it came from. it keeps its materials.
+        // a texture of a glTF file is loaded alone from it. false if the resource wasn't imported from a file
+        template <typename T>
+        bool RestoreResource(fe::pointer<T> ptr);
+
+        // false for resources that weren't imported from a file ( created in code, fallbacks of glTF textures, ... )
+        template <typename T>
+        FORR_NODISCARD bool CanRestoreResource(fe::pointer<T> ptr) const;
+
+        // the resource that was imported from the file, an invalid pointer if the file wasn't imported ( or not as T )
+        template <typename T>
+        FORR_NODISCARD fe::pointer<T> GetImportedResource(const std::filesystem::path& resource_full_path) const;
+
+        // textures that the import of a glTF file created, empty for other files. failed ones are the fallback
+        FORR_NODISCARD std::vector<fe::pointer<resource::Texture>> GetImportedTextures(const std::filesystem::path& resource_full_path) const;
+
+        // main thread only. puts finished reloads into the slots of the old resources, so every fe::pointer<T> to them stays valid,
+        // and adds what has to be made again on the GPU to 'queue'. if a reload fails, the old resource is kept
+        void ApplyReloads(ResourceUploadQueue& queue);
+
+    private:
+        struct PendingReload; // a file that is being loaded again
+
+        // the cooked file of the resource if it's in the cook manifest and isn't older than the resource and its dependencies,
+        // otherwise the resource itself. glTF files are never resolved, their cooked models don't have materials and textures
+        FORR_NODISCARD std::filesystem::path resolvePath(const std::filesystem::path& resource_full_path) const;
+
+        // remembers where the resource came from, so it can be reloaded. returns 'ptr'
+        template <typename T>
+        fe::pointer<T> registerImport(const std::filesystem::path& resource_full_path, fe::pointer<T> ptr);
+
+        // GLTFImporter::Import() that remembers the textures of the file, a reload puts the new ones into their slots
+        fe::pointer<resource::Model> importGLTF(const std::filesystem::path& source_full_path, const std::filesystem::path& resource_full_path);
+        fe::pointer<resource::Model> publishGLTF(const std::filesystem::path& source_full_path, GLTFImportResult& result);
+
+        // the file the resource was imported from, empty if there is none
+        template <typename T>
+        FORR_NODISCARD std::filesystem::path findSourcePath(fe::pointer<T> ptr) const;
+        // the glTF file that created the texture and its tinygltf texture index. false if no glTF file has it
+        FORR_NODISCARD bool findGLTFTexture(fe::pointer<resource::Texture> ptr, std::filesystem::path& source_full_path, uint32_t& texture_index) const;
+
+        // 'gltf_texture_index' - only this texture of the glTF file is loaded, -1 for the whole file
+        void startReload(const std::filesystem::path& resource_full_path, const ImportedResource& target, bool restore, int gltf_texture_index = -1);
+
+        FORR_NODISCARD bool reloadTexture(const ImportedResource& target, resource::Texture& texture, ResourceUploadQueue& queue);
+        // queues textures of a reloaded glTF file. 'previous_textures' are of the previous version of the file
+        void reloadTextures(const std::vector<fe::pointer<resource::Texture>>& previous_textures, const std::vector<fe::pointer<resource::Texture>>& textures,
+                            ResourceUploadQueue& queue);
+        // 'keep_materials' - the primitives keep the materials and the model keeps the textures of the old model, false if the meshes don't match
+        FORR_NODISCARD bool reloadModel(const ImportedResource& target, resource::Model& model, ResourceUploadQueue& queue, bool keep_materials = false);
+        FORR_NODISCARD bool reloadShader(const ImportedResource& target, std::vector<resource::Shader>& variants, ResourceUploadQueue& queue);
+
     private:
         ResourceManagementContext& m_Context;
         ResourceStorage& m_Storage;
+
+        std::unordered_map<std::string, std::vector<std::string>> m_CookedDependencies{}; // ResourceCooker::ReadDependencies(), read once
+
+        mutable std::mutex                                m_ImportedMutex;
+        std::unordered_map<std::string, ImportedResource> m_Imported{}; // by the normalized path of the source file
+
+        // textures of glTF files by tinygltf texture index, by the same keys. guarded by m_ImportedMutex
+        std::unordered_map<std::string, std::vector<fe::pointer<resource::Texture>>> m_ImportedTextures{};
+
+        std::vector<std::unique_ptr<PendingReload>> m_PendingReloads{}; // in the order of the changes
     };
 } // namespace fe
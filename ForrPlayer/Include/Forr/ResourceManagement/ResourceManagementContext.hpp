@@ -19,10 +19,31 @@ namespace fe {
     struct ResourceManagementContext {
         GraphicsBackend graphics_backend{};
 
+        uint32_t texture_quality_tier{}; // top mips dropped when textures are loaded. see ResourceManagerDesc
+
+        VertexAttributes vertex_attributes{ ALL_VERTEX_ATTRIBUTES }; // kept in loaded meshes. see ResourceManagerDesc
+        LodSettings      lod_settings{};                             // of imported meshes. see ResourceManagerDesc
+
         fe::pointer<resource::Shader>   default_gltf_vertex_shader_ptr{};
         fe::pointer<resource::Shader>   default_gltf_fragment_shader_ptr{};
         fe::pointer<resource::Material> default_gltf_material_ptr{};
 
+        // used while the real resource is loading ( or if it failed )
+        fe::pointer<resource::Texture> fallback_texture_ptr{};
+        fe::pointer<resource::Model>   fallback_model_ptr{}; // empty model, nothing is drawn
+
+        template <typename T>
+        FORR_NODISCARD fe::pointer<T> GetFallback() const noexcept {
+            if constexpr (std::is_same_v<T, resource::Texture>)
+                return fallback_texture_ptr;
+            else if constexpr (std::is_same_v<T, resource::Material>)
+                return default_gltf_material_ptr;
+            else if constexpr (std::is_same_v<T, resource::Model>)
+                return fallback_model_ptr;
+            else
+                return {}; // shaders have no fallback
+        }
+
         ResourceManagementContext()  = default;
         ~ResourceManagementContext() = default;
     };
@@ -12,15 +12,34 @@
 
 #pragma once
 #include <filesystem>
+#include "Core/file_watcher.hpp"
 #include "ResourceManagementContext.hpp"
 #include "ResourceStorage.hpp"
 #include "ResourceImporter.hpp"
 #include "ResourceCreator.hpp"
+#include "ResourceResidency.hpp"
+#include "AsyncResource.hpp"
 
 namespace fe {
     struct ResourceManagerDesc {
         GraphicsBackend graphics_backend{};
 
+        // changed files of the assets folder are imported again into the slots of their resources
+        bool            hot_reload_enabled{};
+        FileWatcherDesc hot_reload_desc{};
+
+        ResidencyDesc residency_desc{};
+
+        // 0 - full resolution. every tier drops one more top mip of loaded textures ( 4096 -> 2048 -> 1024 ),
+        // cooked and cached textures keep the full chain, so the tier can be changed without cooking again
+        uint32_t texture_quality_tier{};
+
+        // loaded meshes keep only these of their attributes, the rest isn't uploaded. the position is always kept
+        VertexAttributes vertex_attributes{ ALL_VERTEX_ATTRIBUTES };
+
+        // levels of detail made for imported meshes. cooked models have the ones of ResourceCookerDesc
+        LodSettings lod_settings{};
+
         ResourceManagerDesc()  = default;
         ~ResourceManagerDesc() = default;
     };
@@ -38,6 +57,44 @@ namespace fe {
             return m_Importer.ImportResource<T>(resource_full_path);
         }
 
+        // returns right away. when the resource is ready, it goes to the upload queue of the renderer
+        template <resource::resource_t T>
+        FORR_NODISCARD AsyncResource<T> ImportResourceAsync(const std::filesystem::path& resource_full_path) {
+            AsyncResource<T> handle = m_Importer.ImportResourceAsync<T>(resource_full_path);
+
+            handle.OnComplete([this, path = resource_full_path](fe::pointer<T> ptr, ResourceLoadState state) {
+                if (state != ResourceLoadState::READY) {
+                    fe::logging::warning("Failed to import a resource asynchronously. Fallback is used\nPath : %s", path.string().c_str());
+                    return;
+                }
+
+                if constexpr (std::is_same_v<T, resource::Texture>)
+                    m_UploadQueue.textures.emplace_back(ptr);
+                else if constexpr (std::is_same_v<T, resource::Material>)
+                    m_UploadQueue.materials.emplace_back(ptr);
+                else if constexpr (std::is_same_v<T, resource::Model>) {
+                    // textures of a glTF file are created by its import, the renderer doesn't find them through the model
+                    for (auto texture_ptr : m_Importer.GetImportedTextures(path)) m_UploadQueue.textures.emplace_back(texture_ptr);
+                    m_UploadQueue.models.emplace_back(ptr);
+                }
+            });
+
+            return handle;
+        }
+
+        // the resource that was imported from the file, an invalid pointer if the file wasn't imported ( or not as T )
+        template <typename T>
+        FORR_NODISCARD fe::pointer<T> GetImportedResource(const std::filesystem::path& resource_full_path) const {
+            return m_Importer.GetImportedResource<T>(resource_full_path);
+        }
+
+        // main thread only. the renderer takes it once per frame
+        FORR_NODISCARD ResourceUploadQueue TakeUploadQueue() { return std::exchange(m_UploadQueue, {}); }
+
+        // main thread only, once per frame before the renderer takes the upload queue.
+        // starts reloading files that were changed and puts finished reloads into the upload queue
+        void UpdateHotReload();
+
         template <typename T>
         FORR_NODISCARD fe::pointer<T> CreateResource(const T& value) {
             return m_Storage.CreateResource(value);
@@ -55,17 +112,67 @@ namespace fe {
             return m_Storage.CreateResource();
         }
 
+        template <typename T, typename... Args>
+        FORR_NODISCARD fe::pointer<T> EmplaceResource(Args&&... args) {
+            return m_Storage.EmplaceResource<T>(std::forward<Args>(args)...);
+        }
+
+        template <typename T>
+        void ReserveResources(size_t count) { m_Storage.ReserveResources<T>(count); }
+
+        // the pointer is safe to keep while the resource is alive ( at least for the whole frame )
         template <typename T>
         FORR_NODISCARD T* GetResource(fe::pointer<T> ptr) { return m_Storage.GetResource(ptr); }
 
+        // the fallback resource if the pointer is invalid ( not loaded yet, failed or destroyed )
+        template <typename T>
+        FORR_NODISCARD T* GetResourceOrFallback(fe::pointer<T> ptr) {
+            if (T* resource = m_Storage.GetResource(ptr)) return resource;
+            return m_Storage.GetResource(m_Context.GetFallback<T>());
+        }
+
+        template <typename T>
+        void DestroyResource(fe::pointer<T> ptr) {
+            if constexpr (residency_t<T>) m_Residency.Forget(ptr);
+            m_Storage.DestroyResource(ptr);
+        }
+
+        // frees destroyed resources. call it once per frame from the main thread
+        void ReclaimResources() { m_Storage.ReclaimResources(); }
+
         template <typename T, typename Func>
         void RunForEach(Func&& func) { m_Storage.RunForEach<T>(func); }
 
+        const ResourceManagementContext& GetContext() const noexcept { return m_Context; }
+
+        // the renderer calls it when a texture or a model is on the GPU. its CPU copy is freed if the residency allows it
+        template <residency_t T>
+        void MarkUploaded(fe::pointer<T> ptr);
+
+        // the resource is used this frame. an evicted one is imported again, false until it's back on the GPU
+        template <residency_t T>
+        bool TouchResource(fe::pointer<T> ptr);
+
+        // main thread only, once per frame. 'gpu_budget_bytes' is the budget reported by the device, 0 if it's unknown.
+        // the renderer frees GPU objects of the returned resources and calls EvictResource() for each of them
+        FORR_NODISCARD ResidencyEvictions UpdateResidency(size_t gpu_budget_bytes) { return m_Residency.Update(gpu_budget_bytes); }
+
+        // frees the CPU data of a resource whose GPU objects were freed. it stays in the storage and keeps its pointer
+        template <residency_t T>
+        void EvictResource(fe::pointer<T> ptr);
+
+        FORR_NODISCARD const ResidencyStats& GetResidencyStats() const noexcept { return m_Residency.GetStats(); }
+
     private:
         ResourceManagementContext m_Context{};
 
         ResourceImporter m_Importer{ m_Context, m_Storage };
         ResourceCreator  m_Creator{ m_Context, m_Storage, m_Importer };
         ResourceStorage  m_Storage{ m_Context };
+
+        ResourceUploadQueue m_UploadQueue{};
+        ResourceResidency   m_Residency{};
+
+        FileWatcher m_Watcher{}; // watches nothing if hot reload is disabled
     };
 } // namespace fe
@@ -0,0 +1,184 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ResourceResidency.hpp
+    Role : tracks memory of resources and picks the ones to evict under a budget
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/pointer.hpp"
+#include "Resources.hpp"
+
+namespace fe {
+    struct ResidencyDesc {
+        size_t cpu_budget_bytes{}; // CPU copies of textures and meshes. 0 - no budget
+        size_t gpu_budget_bytes{}; // 0 - no budget. on Vulkan the smaller of this and the budget of the device heaps is used
+
+        // a resource is evicted only if it wasn't used for this many frames. it must be more than the frames in flight
+        uint32_t min_unused_frames{ 300 };
+
+        bool release_cpu_copies{ true }; // free bytes of textures and vertices of meshes when they are on the GPU
+
+        ResidencyDesc()  = default;
+        ~ResidencyDesc() = default;
+    };
+
+    enum class ResidencyState : uint8_t {
+        RESIDENT,  // on the GPU
+        EVICTED,   // the GPU and CPU data are freed, it's imported again when it's used
+        RESTORING, // it's being imported again
+    };
+
+    struct ResidencyStats {
+        size_t cpu_bytes{};
+        size_t gpu_bytes{};
+        size_t resident_count{};
+        size_t evicted_count{};
+
+        ResidencyStats()  = default;
+        ~ResidencyStats() = default;
+    };
+
+    // the least recently used resources that have to go for the usage to fit the budgets
+    struct ResidencyEvictions {
+        std::vector<fe::pointer<resource::Texture>> textures{};
+        std::vector<fe::pointer<resource::Model>>   models{};
+
+        ResidencyEvictions()  = default;
+        ~ResidencyEvictions() = default;
+    };
+
+    template <typename T>
+    concept residency_t = std::is_same_v<T, resource::Texture> || std::is_same_v<T, resource::Model>;
+
+    // textures and models are tracked from the moment they are on the GPU. main thread only
+    class ResourceResidency {
+    public:
+        ResourceResidency()  = default;
+        ~ResourceResidency() = default;
+
+        FORR_CLASS_NONCOPYABLE(ResourceResidency)
+
+        void Init(const ResidencyDesc& desc) { m_Desc = desc; }
+
+        FORR_NODISCARD const ResidencyDesc&  GetDesc() const noexcept { return m_Desc; }
+        FORR_NODISCARD const ResidencyStats& GetStats() const noexcept { return m_Stats; }
+        FORR_NODISCARD uint64_t              GetFrame() const noexcept { return m_Frame; }
+
+        // the resource is on the GPU and 'cpu_bytes' of it are still in RAM. a pinned resource is never evicted
+        template <residency_t T>
+        void MarkResident(fe::pointer<T> ptr, size_t cpu_bytes, size_t gpu_bytes, bool pinned) {
+            auto [it, inserted] = this->getEntries<T>().try_emplace(ptr.packed());
+            if (!inserted) this->untrack(it->second);
+
+            Entry& entry = it->second;
+
+            entry.last_used_frame = m_Frame;
+            entry.cpu_bytes       = cpu_bytes;
+            entry.gpu_bytes       = gpu_bytes;
+            entry.state           = ResidencyState::RESIDENT;
+            entry.pinned          = pinned;
+
+            this->track(entry);
+        }
+
+        // the CPU copy was freed
+        template <residency_t T>
+        void SetCPUBytes(fe::pointer<T> ptr, size_t cpu_bytes) {
+            auto& entries = this->getEntries<T>();
+
+            auto it = entries.find(ptr.packed());
+            if (it == entries.end()) return;
+
+            m_Stats.cpu_bytes -= it->second.cpu_bytes;
+            it->second.cpu_bytes = cpu_bytes;
+            m_Stats.cpu_bytes += cpu_bytes;
+        }
+
+        template <residency_t T>
+        void MarkEvicted(fe::pointer<T> ptr) { this->setState<T>(ptr, ResidencyState::EVICTED); }
+
+        template <residency_t T>
+        void MarkRestoring(fe::pointer<T> ptr) { this->setState<T>(ptr, ResidencyState::RESTORING); }
+
+        // the resource was destroyed
+        template <residency_t T>
+        void Forget(fe::pointer<T> ptr) {
+            auto& entries = this->getEntries<T>();
+
+            auto it = entries.find(ptr.packed());
+            if (it == entries.end()) return;
+
+            this->untrack(it->second);
+            entries.erase(it);
+        }
+
+        // the resource is used this frame. untracked resources are RESIDENT, they aren't on the GPU yet or aren't managed
+        template <residency_t T>
+        ResidencyState Touch(fe::pointer<T> ptr) {
+            auto& entries = this->getEntries<T>();
+
+            auto it = entries.find(ptr.packed());
+            if (it == entries.end()) return ResidencyState::RESIDENT;
+
+            it->second.last_used_frame = m_Frame;
+            return it->second.state;
+        }
+
+        // starts a new frame and returns what has to be evicted for the usage to fit the budgets.
+        // 'gpu_budget_bytes' is the budget reported by the device, 0 if it's unknown
+        FORR_NODISCARD ResidencyEvictions Update(size_t gpu_budget_bytes);
+
+    private:
+        struct Entry {
+            uint64_t       last_used_frame{};
+            size_t         cpu_bytes{};
+            size_t         gpu_bytes{};
+            ResidencyState state{ ResidencyState::RESIDENT };
+            bool           pinned{};
+        };
+
+        using entries_t = std::unordered_map<uint64_t, Entry>; // by packed pointer
+
+        template <residency_t T>
+        entries_t& getEntries() {
+            if constexpr (std::is_same_v<T, resource::Texture>)
+                return m_Textures;
+            else
+                return m_Models;
+        }
+
+        template <residency_t T>
+        void setState(fe::pointer<T> ptr, ResidencyState state) {
+            auto& entries = this->getEntries<T>();
+
+            auto it = entries.find(ptr.packed());
+            if (it == entries.end()) return;
+
+            this->untrack(it->second);
+            it->second.state = state;
+            if (state != ResidencyState::RESIDENT) it->second.cpu_bytes = it->second.gpu_bytes = 0; // both were freed
+            this->track(it->second);
+        }
+
+        void track(const Entry& entry);
+        void untrack(const Entry& entry);
+
+    private:
+        ResidencyDesc  m_Desc{};
+        ResidencyStats m_Stats{};
+        uint64_t       m_Frame{};
+
+        entries_t m_Textures{};
+        entries_t m_Models{};
+    };
+} // namespace fe
@@ -19,8 +19,12 @@
 namespace fe {
     class ResourceImporter; // forward declaration
 
+    // all functions here are thread-safe, so importers can create resources from worker threads
     class ResourceStorage {
     public:
+        template <typename T>
+        using storage_t = fe::concurrent_pointer_storage<T>;
+
         ResourceStorage(ResourceManagementContext& context) : m_Context(context) {}
         ~ResourceStorage() = default;
 
@@ -38,11 +42,41 @@ namespace fe {
             return storage.create();
         }
 
+        // constructs the resource directly in the storage
+        template <typename T, typename... Args>
+        FORR_NODISCARD fe::pointer<T> EmplaceResource(Args&&... args) {
+            auto& storage = this->GetStorage<T>();
+            return storage.emplace(std::forward<Args>(args)...);
+        }
+
+        // allocates storage pages to hold at least 'count' resources of type T
+        template <typename T>
+        void ReserveResources(size_t count) {
+            auto& storage = this->GetStorage<T>();
+            storage.reserve(count);
+        }
+
+        // the returned pointer stays valid until the resource is destroyed and ReclaimResources() is called,
+        // the storage never moves its resources when it grows
         template <typename T>
         FORR_NODISCARD T* GetResource(fe::pointer<T> ptr) {
             auto& storage = this->GetStorage<T>();
-            if (!storage.is_valid(ptr)) return nullptr; // TODO : provide fallbacks
-            return storage.get(ptr);
+            return storage.get(ptr); // nullptr if the pointer is invalid. see ResourceManager::GetResourceOrFallback()
+        }
+
+        // the resource becomes invalid immediately but its memory is freed only in ReclaimResources()
+        template <typename T>
+        void DestroyResource(fe::pointer<T> ptr) {
+            auto& storage = this->GetStorage<T>();
+            storage.destroy(ptr);
+        }
+
+        // frees destroyed resources. call it from one thread, when nobody holds 'T*' of destroyed resources
+        void ReclaimResources() {
+            m_Textures.reclaim();
+            m_Materials.reclaim();
+            m_Models.reclaim();
+            m_Shader.reclaim();
         }
 
         template <typename T, typename Func>
@@ -53,7 +87,7 @@ namespace fe {
 
         // unsafe helper function
         template <typename T>
-        fe::typed_pointer_storage<T>& GetStorage() {
+        storage_t<T>& GetStorage() {
             if constexpr (std::is_same_v<T, fe::resource::Texture>)
                 return m_Textures;
             else if constexpr (std::is_same_v<T, fe::resource::Material>)
@@ -69,9 +103,9 @@ namespace fe {
     private:
         ResourceManagementContext& m_Context;
 
-        fe::typed_pointer_storage<fe::resource::Texture>  m_Textures{};
-        fe::typed_pointer_storage<fe::resource::Material> m_Materials{};
-        fe::typed_pointer_storage<fe::resource::Model>    m_Models{};
-        fe::typed_pointer_storage<fe::resource::Shader>   m_Shader{};
+        storage_t<fe::resource::Texture>  m_Textures{};
+        storage_t<fe::resource::Material> m_Materials{};
+        storage_t<fe::resource::Model>    m_Models{};
+        storage_t<fe::resource::Shader>   m_Shader{};
     };
 } // namespace fe
@@ -21,8 +21,12 @@
 #include <vector>
 #include "Core/types.hpp"
 #include "Core/guid.hpp"
+#include "Core/memory_tracking.hpp"
 
 #include "Graphics/GPUTypes.hpp"
+#include "Graphics/VertexFormat.hpp"
+#include "Graphics/LevelOfDetail.hpp"
+#include "Graphics/ClusterCulling.hpp"
 
 // namespace fe::resource:: means that the class is a
 //  DOD structure, not a high level resource
@@ -43,7 +47,17 @@ namespace fe::resource {
             RG8,
             R8,
             SRGB8_ALPHA8,
-            SRGB8
+            SRGB8,
+
+            // block compressed, made by the cooker. 'components' keeps the number of channels of the source
+            BC1_RGB,
+            BC1_SRGB,
+            BC3_RGBA,
+            BC3_SRGB_ALPHA,
+            BC4_RED,
+            BC5_RG,
+            BC7_RGBA,
+            BC7_SRGB_ALPHA
         };
         enum class DataFormat {
             RGBA,
@@ -79,6 +93,7 @@ namespace fe::resource {
         uint8_t      components{};
         unsigned int width{};
         unsigned int height{};
+        uint32_t     mip_count{ 1 }; // levels in 'bytes', see fe::texture_mip_level(). 1 - the GPU makes the rest
 
         MinFilter min_filter{ MinFilter::LINEAR_MIPMAP_LINEAR };
         MagFilter mag_filter{ MagFilter::LINEAR };
@@ -90,7 +105,7 @@ namespace fe::resource {
 
         Target target{ Target::TEXTURE_2D };
 
-        std::unique_ptr<unsigned char[]> bytes{};
+        fe::tagged_unique_array<unsigned char, MemoryTag::Textures> bytes{}; // the mip chain, the largest level first
         //fe::ArenaMarker offset{}; // TODO : think about using this instead of std::unique_ptr<>
 
         Texture()  = default;
@@ -106,6 +121,8 @@ namespace fe::resource {
             FRAGMENT
             // add more later...
         };
+        using SourceCode = fe::tagged_vector<uint32_t, MemoryTag::Shaders>; // SPIR-V
+
         struct FORR_API Property {
         public:
             enum class Type {
@@ -128,9 +145,26 @@ namespace fe::resource {
             ~Property() = default;
         };
 
-        Type                                      type{};
-        std::vector<uint32_t>                     source_code{};
-        std::unordered_map<std::string, Property> properties{};
+        // 'layout(constant_id = N) const ...' in the source. it's set when the program is created, without compiling again
+        struct FORR_API SpecializationConstant {
+        public:
+            uint32_t constant_id{};
+            uint32_t value{}; // the default one. bits of a bool, int, uint or float
+
+            SpecializationConstant()  = default;
+            ~SpecializationConstant() = default;
+        };
+
+        Type                                                    type{};
+        SourceCode                                              source_code{};
+        std::unordered_map<std::string, Property>               properties{};
+        std::unordered_map<std::string, SpecializationConstant> specialization_constants{};
+
+        // keywords are declared in the source by '#pragma forr_keywords NAME ...' and every permutation of them is compiled.
+        // bit i of 'variant_key' means that keywords[i] was defined in this variant
+        std::vector<std::string>         keywords{};
+        uint64_t                         variant_key{};
+        std::vector<fe::pointer<Shader>> variants{}; // by variant key. only the base variant ( key 0 ) has them, importers return it
 
         Shader()  = default;
         ~Shader() = default;
@@ -146,7 +180,9 @@ namespace fe::resource {
         fe::pointer<fe::resource::Shader> fragment_shader_ptr{};
         // add more later...
 
-        std::vector<uint8_t> buffer{};
+        std::unordered_map<std::string, uint32_t> specialization_values{}; // by constant name, for both shaders
+
+        fe::tagged_vector<uint8_t, MemoryTag::Materials> buffer{};
 
         Material()  = default;
         ~Material() = default;
@@ -161,9 +197,25 @@ namespace fe::resource {
 
                 RenderMode render_mode{ RenderMode::TRIANGLES }; // triangles by default
 
-                RenderIndexType index_type{ RenderIndexType::UNSIGNED_INT }; // this should be removed
-                int             index_count{};
-                int             index_offset{};
+                int index_count{};
+                int index_offset{};
+
+                int meshlet_offset{}; // in Mesh::meshlets. only triangle lists have them
+                int meshlet_count{};
+
+                std::vector<MeshLod> lods{}; // coarser levels of detail, each one after the previous. only triangle lists have them
+
+                // level 0 is the full primitive
+                FORR_NODISCARD MeshLod lod(uint32_t level) const noexcept {
+                    if (level > 0 && level <= lods.size()) return lods[level - 1];
+
+                    MeshLod full{};
+                    full.index_offset   = index_offset;
+                    full.index_count    = index_count;
+                    full.meshlet_offset = meshlet_offset;
+                    full.meshlet_count  = meshlet_count;
+                    return full;
+                }
 
                 Primitive()  = default;
                 ~Primitive() = default;
@@ -173,11 +225,15 @@ namespace fe::resource {
 
             std::string name{};
 
-            Vertices vertices{};
-            Indices  indices{};
+            Vertices        vertices{};
+            Indices         indices{};
+            RenderIndexType index_type{ RenderIndexType::UNSIGNED_INT }; // of the GPU buffer and the file, see index_type_for()
+            VertexFormat    vertex_format{};                             // positions are quantized with Model::vertex_quantization
+            BoundingSphere  bounds{};                                    // of the vertices, LODs are selected by its size on the screen
 
             std::vector<Primitive> primitives{};
-            std::vector<float>     weights{}; // weights to be applied to the Morph Targets
+            std::vector<Meshlet>   meshlets{}; // of every level of every primitive. they stay on the CPU for culling
+            std::vector<float>     weights{};  // weights to be applied to the Morph Targets
 
             Mesh()  = default;
             ~Mesh() = default;
@@ -206,9 +262,9 @@ namespace fe::resource {
                 CUBICSPLINE
             };
 
-            std::vector<float>     times{};
-            std::vector<glm::vec4> values{}; // rotation as quat, translation/scale as vec3
-            InterpolationMode      interpolation{ InterpolationMode::LINEAR };
+            fe::tagged_vector<float, MemoryTag::Animation>     times{};
+            fe::tagged_vector<glm::vec4, MemoryTag::Animation> values{}; // rotation as quat, translation/scale as vec3
+            InterpolationMode                                  interpolation{ InterpolationMode::LINEAR };
 
             AnimationSampler()  = default;
             ~AnimationSampler() = default;
@@ -265,6 +321,12 @@ namespace fe::resource {
         std::vector<Mesh>      meshes{};
         std::vector<Animation> animations{};
 
+        // textures of the file the model came from, by tinygltf texture index. they are touched with the model, so they stay resident while it's drawn
+        std::vector<fe::pointer<Texture>> textures{};
+
+        // one box for all meshes, so a draw of the model needs one matrix
+        VertexQuantization vertex_quantization{};
+
         Model()  = default;
         ~Model() = default;
 
@@ -0,0 +1,59 @@
+/*===============================================
+
+    Forr Engine
+
+    File : TextureLayout.hpp
+    Role : how the mip chain of fe::resource::Texture is laid out in its bytes
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+#include "Core/image_mips.hpp"
+#include "Resources.hpp"
+
+namespace fe {
+    FORR_NODISCARD constexpr bool is_block_compressed(resource::Texture::InternalFormat format) noexcept {
+        using InternalFormat = resource::Texture::InternalFormat;
+
+        switch (format) {
+            case InternalFormat::BC1_RGB:
+            case InternalFormat::BC1_SRGB:
+            case InternalFormat::BC3_RGBA:
+            case InternalFormat::BC3_SRGB_ALPHA:
+            case InternalFormat::BC4_RED:
+            case InternalFormat::BC5_RG:
+            case InternalFormat::BC7_RGBA:
+            case InternalFormat::BC7_SRGB_ALPHA: return true;
+            default: return false;
+        }
+    }
+
+    FORR_NODISCARD constexpr bool is_srgb(resource::Texture::InternalFormat format) noexcept {
+        using InternalFormat = resource::Texture::InternalFormat;
+
+        return format == InternalFormat::SRGB8_ALPHA8 || format == InternalFormat::SRGB8 || format == InternalFormat::BC1_SRGB ||
+               format == InternalFormat::BC3_SRGB_ALPHA || format == InternalFormat::BC7_SRGB_ALPHA;
+    }
+
+    // BC1 and BC4 are 8 bytes per 4x4 block, the rest of BC formats are 16
+    FORR_NODISCARD constexpr MipFormat texture_mip_format(resource::Texture::InternalFormat format, uint32_t components) noexcept {
+        using InternalFormat = resource::Texture::InternalFormat;
+
+        if (!is_block_compressed(format)) return MipFormat{ 1, components };
+
+        bool half_block = format == InternalFormat::BC1_RGB || format == InternalFormat::BC1_SRGB || format == InternalFormat::BC4_RED;
+        return MipFormat{ 4, half_block ? 8u : 16u };
+    }
+
+    FORR_NODISCARD constexpr MipLevel texture_mip_level(const resource::Texture& texture, uint32_t level) noexcept {
+        return mip_level(texture.width, texture.height, texture_mip_format(texture.internal_format, texture.components), level);
+    }
+
+    // bytes of the whole chain
+    FORR_NODISCARD constexpr size_t texture_byte_size(const resource::Texture& texture) noexcept {
+        return mip_chain_size(texture.width, texture.height, texture_mip_format(texture.internal_format, texture.components), texture.mip_count);
+    }
+} // namespace fe
@@ -13,7 +13,9 @@
 #pragma once
 
 #include "Core/attributes.hpp"
+#include "Core/memory_tracking.hpp"
 #include "Core/custom_allocators.hpp"
+#include "Core/job_system.hpp"
 #include "Core/logging.hpp"
 #include "Core/pointer.hpp"
 #include "Core/types.hpp"
@@ -3,35 +3,40 @@
 
 fe::Application::Application(const ApplicationDesc& desc) {
     PATH.init(desc.args[0], true);
+    JOBS.init(desc.job_system_desc);
+    DDC.init(PATH.getDerivedDataPath(), desc.derived_data_cache_desc);
 
     this->InitializePlatformSystem(desc);
     this->InitializeResourceManager(desc);
     this->InitializePrimaryWindow(desc);
     this->InitializeRenderer(desc);
 
-    size_t i = 0; // temp
-
-    m_ResourceManager->RunForEach<resource::Model>([&](fe::pointer<resource::Model> model_ptr, const resource::Model& model) { // temp
-        switch (i) {
-            case 0:
-                m_Object.mesh_component.model_ptr      = model_ptr;
-                m_Object.mesh_component.mesh_id        = ~0;
-                m_Object.transform_component.transform = glm::translate(glm::mat4(1.0f), glm::vec3(50, 0, 0));
-                break;
-            case 1:
-                m_Object2.mesh_component.model_ptr      = model_ptr;
-                m_Object2.mesh_component.mesh_id        = ~0;
-                m_Object2.transform_component.transform = glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0));
-                break;
-        }
-        i++;
-    });
+    // temp. the models are found by their files, the storage order isn't the import order ( the fallbacks come first )
+    m_Object.mesh_component.model_ptr      = m_ResourceManager->GetImportedResource<resource::Model>(PATH.getModelsPath() / "StatueOfLiberty/statue_of_liberty.glb");
+    m_Object.mesh_component.mesh_id        = ~0;
+    m_Object.transform_component.transform = glm::translate(glm::mat4(1.0f), glm::vec3(50, 0, 0));
+
+    m_Object2.mesh_component.model_ptr      = m_ResourceManager->GetImportedResource<resource::Model>(PATH.getModelsPath() / "PirateRoom/PirateRoom.gltf");
+    m_Object2.mesh_component.mesh_id        = ~0;
+    m_Object2.transform_component.transform = glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0));
+}
+
+fe::Application::~Application() {
+    // workers can touch resources, so they have to stop first
+    JOBS.shutdown();
+    DDC.shutdown();
 }
 
 void fe::Application::Run() {
     while (m_PrimaryWindow->IsOpen()) {
+        m_ResourceManager->UpdateHotReload(); // before the renderer takes the upload queue
+
         m_Renderer->BeginFrame();
 
+        // the draw list lives in the frame arena, it's reset when the GPU is done with the frame
+        fe::ArenaResource                 frame_resource{ m_Renderer->GetFrameArena() };
+        std::pmr::vector<DrawMeshCommand> draw_list(&frame_resource);
+
         { // temp
             DrawMeshCommand command{};
             command.model_ptr  = m_Object.mesh_component.model_ptr;
@@ -40,18 +45,24 @@ void fe::Application::Run() {
 
             m_Object.transform_component.transform = glm::rotate(m_Object.transform_component.transform, 0.01f, glm::vec3(0, 1, 0));
 
-            m_Renderer->Draw(command);
+            draw_list.emplace_back(command);
 
             DrawMeshCommand command2{};
             command2.model_ptr  = m_Object2.mesh_component.model_ptr;
             command2.mesh_index = m_Object2.mesh_component.mesh_id;
             command2.transform  = m_Object2.transform_component.transform;
 
-            m_Renderer->Draw(command2);
+            draw_list.emplace_back(command2);
         }
 
+        for (const DrawMeshCommand& command : draw_list) m_Renderer->Draw(command);
+
         m_Renderer->EndFrame();
 
+        m_ResourceManager->ReclaimResources();
+
+        JOBS.process_main_thread_jobs();
+
         m_PrimaryWindow->PollEvents();
     }
 }
@@ -71,11 +82,16 @@ void fe::Application::InitializeResourceManager(const ApplicationDesc& desc) {
     paths.emplace_back(PATH.getModelsPath() / "PirateRoom/PirateRoom.gltf");
 
     ResourceManagerDesc resource_manager_desc{};
-    resource_manager_desc.graphics_backend = desc.graphics_backend;
+    resource_manager_desc.graphics_backend     = desc.graphics_backend;
+    resource_manager_desc.hot_reload_enabled   = desc.hot_reload_enabled;
+    resource_manager_desc.hot_reload_desc      = desc.hot_reload_desc;
+    resource_manager_desc.texture_quality_tier = desc.texture_quality_tier;
 
     m_ResourceManager = std::make_unique<ResourceManager>(resource_manager_desc);
     m_ResourceManager->CreateDefaultResources();
     m_ResourceManager->SetupSceneResources(paths); // TODO : rewrite this
+
+    fe::memory::dump();
 }
 
 void fe::Application::InitializePrimaryWindow(const ApplicationDesc& desc) {
@@ -0,0 +1,84 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ClusterCulling.cpp
+    Role : meshlets and their culling by the frustum and normal cones
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Graphics/ClusterCulling.hpp"
+#include "Graphics/Camera.hpp"
+
+#include <array>
+
+namespace fe {
+    using FrustumPlanes = std::array<glm::vec4, 6>;
+
+    // planes of the clip space ( Gribb, Hartmann ) in the space that 'clip' takes to it, facing inwards. not normalized.
+    // the near plane is the OpenGL one ( -w <= z ), it holds the Vulkan one ( 0 <= z ) too, so it's right for both depth ranges
+    static FrustumPlanes frustumPlanes(const glm::mat4& clip) {
+        const glm::vec4 row_x(clip[0][0], clip[1][0], clip[2][0], clip[3][0]);
+        const glm::vec4 row_y(clip[0][1], clip[1][1], clip[2][1], clip[3][1]);
+        const glm::vec4 row_z(clip[0][2], clip[1][2], clip[2][2], clip[3][2]);
+        const glm::vec4 row_w(clip[0][3], clip[1][3], clip[2][3], clip[3][3]);
+
+        return { row_w + row_x, row_w - row_x, row_w + row_y, row_w - row_y, row_w + row_z, row_w - row_z };
+    }
+
+    static bool sphereInFrustum(const FrustumPlanes& planes, const glm::vec3& center, float radius) {
+        for (const glm::vec4& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius * glm::length(glm::vec3(plane))) return false;
+        }
+        return true;
+    }
+
+    // the corner of the box that is the furthest along the normal of every plane
+    static bool boxInFrustum(const FrustumPlanes& planes, const glm::vec3& min, const glm::vec3& max) {
+        for (const glm::vec4& plane : planes) {
+            const glm::vec3 corner = glm::mix(min, max, glm::greaterThanEqual(glm::vec3(plane), glm::vec3(0.0f)));
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) return false;
+        }
+        return true;
+    }
+} // namespace fe
+
+void fe::ClusterCuller::beginFrame(const Camera& camera) {
+    m_ViewProjection = camera.getPerspectiveMatrix() * camera.getViewMatrix();
+    m_EyePosition    = glm::vec3(glm::inverse(camera.getViewMatrix())[3]);
+}
+
+bool fe::ClusterCuller::isVisible(const glm::mat4& transform, const BoundingSphere& bounds) const {
+    return sphereInFrustum(frustumPlanes(m_ViewProjection * transform), bounds.center, bounds.radius);
+}
+
+void fe::ClusterCuller::cull(const glm::mat4& transform, std::span<const Meshlet> meshlets, std::pmr::vector<IndexRange>& ranges) const {
+    const FrustumPlanes planes = frustumPlanes(m_ViewProjection * transform);
+    const auto          eye    = glm::vec3(glm::inverse(transform) * glm::vec4(m_EyePosition, 1.0f));
+
+    // a mirroring transform turns back faces to the camera
+    const bool cones_enabled = glm::determinant(glm::mat3(transform)) > 0.0f;
+
+    for (const Meshlet& meshlet : meshlets) {
+        if (!boxInFrustum(planes, meshlet.aabb_min, meshlet.aabb_max)) continue;
+
+        // every triangle is back-facing if every direction from the eye to the sphere is within 90 degrees minus the half angle of the cone
+        if (cones_enabled && meshlet.cone_cutoff < 1.0f) {
+            const glm::vec3 to_center = meshlet.bounds.center - eye;
+            const float     margin    = meshlet.bounds.radius * (1.0f + meshlet.cone_cutoff);
+
+            if (glm::dot(to_center, meshlet.cone_axis) >= (meshlet.cone_cutoff * glm::length(to_center)) + margin) continue;
+        }
+
+        if (!ranges.empty() && ranges.back().index_offset + ranges.back().index_count == meshlet.index_offset) {
+            ranges.back().index_count += meshlet.index_count;
+        }
+        else {
+            ranges.emplace_back(IndexRange{ meshlet.index_offset, meshlet.index_count });
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/*===============================================
+
+    Forr Engine
+
+    File : LevelOfDetail.cpp
+    Role : levels of detail of meshes and their selection by the error on the screen
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Graphics/LevelOfDetail.hpp"
+#include "Graphics/Camera.hpp"
+
+#include <algorithm>
+#include <limits>
+
+void fe::LodSelector::beginFrame(const Camera& camera, float viewport_height) {
+    m_Frame++;
+    std::erase_if(m_Entries, [this](const auto& entry) { return entry.second.frame + 1 < m_Frame; });
+    std::erase_if(m_Occurrences, [this](const auto& occurrence) { return occurrence.second.frame + 1 < m_Frame; });
+
+    m_EyePosition = glm::vec3(glm::inverse(camera.getViewMatrix())[3]);
+    m_NearClip    = camera.getNearClip();
+
+    // [1][1] is 1 / tan(fov / 2), it's negative if Y is flipped
+    m_PixelsPerUnit = viewport_height * 0.5f * std::abs(camera.getPerspectiveMatrix()[1][1]);
+}
+
+uint64_t fe::LodSelector::instanceKey(uint64_t object) {
+    Occurrence& occurrence = m_Occurrences[object];
+    if (occurrence.frame != m_Frame) occurrence = Occurrence{ 0, m_Frame };
+
+    return hash_combine(object, occurrence.count++);
+}
+
+uint32_t fe::LodSelector::select(uint64_t key, const BoundingSphere& bounds, const glm::mat4& transform, std::span<const MeshLod> lods) {
+    if (lods.empty() || m_PixelError <= 0.0f) return 0;
+
+    const float scale  = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+    const auto  center = glm::vec3(transform * glm::vec4(bounds.center, 1.0f));
+
+    // the nearest point of the sphere. the camera inside of it gets the full mesh
+    const float distance        = std::max(glm::length(center - m_EyePosition) - (bounds.radius * scale), m_NearClip);
+    const float pixels_per_unit = m_PixelsPerUnit * scale / std::max(distance, std::numeric_limits<float>::min());
+
+    auto projected_error = [&](uint32_t lod) { return lod == 0 ? 0.0f : lods[lod - 1].error * pixels_per_unit; };
+
+    // errors of levels grow with them
+    uint32_t fitting_lod = 0;
+    while (fitting_lod < lods.size() && projected_error(fitting_lod + 1) <= m_PixelError) fitting_lod++;
+
+    auto [it, inserted] = m_Entries.try_emplace(key, Entry{ fitting_lod, m_Frame });
+    Entry& entry        = it->second;
+
+    if (!inserted) {
+        uint32_t lod = std::min(entry.lod, static_cast<uint32_t>(lods.size())); // the model could be imported again with other levels
+
+        if (fitting_lod > lod) {
+            while (lod < fitting_lod && projected_error(lod + 1) <= m_PixelError * (1.0f - m_Hysteresis)) lod++;
+        }
+        else if (fitting_lod < lod && projected_error(lod) > m_PixelError * (1.0f + m_Hysteresis)) {
+            lod = fitting_lod;
+        }
+
+        entry.lod   = lod;
+        entry.frame = m_Frame;
+    }
+
+    return entry.lod;
+}
@@ -0,0 +1,743 @@
+/*===============================================
+
+    Forr Engine
+
+    File : MeshOptimization.cpp
+    Role : reordering of indices and vertices for the post-transform cache, overdraw and vertex fetch. simplification, meshlets
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Graphics/MeshOptimization.hpp"
+
+#include <bit>
+#include <memory_resource>
+#include <unordered_map>
+
+#include "Core/custom_allocators.hpp"
+#include "Core/hash.hpp"
+
+namespace fe {
+    static constexpr size_t G_NO_VERTEX = std::numeric_limits<size_t>::max();
+
+    // FIFO cache of 'cache_size' entries on timestamps : a vertex is in the cache while fewer than 'cache_size' misses happened since it was loaded.
+    // timestamps start at 0 and the time at 'cache_size + 1', so every vertex misses first. adding 'cache_size + 1' to the time empties the cache
+    class VertexCacheTimestamps {
+    public:
+        VertexCacheTimestamps(size_t vertex_count, uint32_t cache_size, std::pmr::memory_resource* resource)
+            : m_timestamps(vertex_count, 0, resource), m_cache_size(cache_size), m_time(cache_size + 1) {}
+
+        // true on a miss, the vertex is loaded then
+        bool load(Index vertex) noexcept {
+            if (m_time - m_timestamps[vertex] <= m_cache_size) return false;
+
+            m_timestamps[vertex] = m_time++;
+            return true;
+        }
+
+        // how long ago the vertex was loaded, in misses
+        FORR_NODISCARD uint32_t age(Index vertex) const noexcept { return m_time - m_timestamps[vertex]; }
+
+        void flush() noexcept { m_time += m_cache_size + 1; }
+
+    private:
+        std::pmr::vector<uint32_t> m_timestamps;
+        uint32_t                   m_cache_size{};
+        uint32_t                   m_time{};
+    };
+
+    static uint32_t triangleMisses(VertexCacheTimestamps& cache, std::span<const Index> indices, size_t triangle) {
+        uint32_t misses = 0;
+        for (size_t k = 0; k < 3; k++) misses += cache.load(indices[triangle * 3 + k]) ? 1 : 0;
+        return misses;
+    }
+
+    // sum of squared distances to planes, weighted by the areas of their triangles. symmetric 4x4, only the upper half is kept
+    struct Quadric {
+        float a2{}, b2{}, c2{}, ab{}, ac{}, bc{}, ad{}, bd{}, cd{}, d2{};
+        float weight{};
+
+        Quadric& operator+=(const Quadric& other) noexcept {
+            a2 += other.a2, b2 += other.b2, c2 += other.c2;
+            ab += other.ab, ac += other.ac, bc += other.bc;
+            ad += other.ad, bd += other.bd, cd += other.cd;
+            d2 += other.d2;
+            weight += other.weight;
+            return *this;
+        }
+
+        // the plane through 'p0' with unit 'normal'
+        static Quadric plane(const glm::vec3& p0, const glm::vec3& normal, float weight) noexcept {
+            const float a = normal.x, b = normal.y, c = normal.z, d = -glm::dot(normal, p0);
+
+            Quadric quadric{};
+            quadric.a2 = a * a * weight, quadric.b2 = b * b * weight, quadric.c2 = c * c * weight;
+            quadric.ab = a * b * weight, quadric.ac = a * c * weight, quadric.bc = b * c * weight;
+            quadric.ad = a * d * weight, quadric.bd = b * d * weight, quadric.cd = c * d * weight;
+            quadric.d2     = d * d * weight;
+            quadric.weight = weight;
+            return quadric;
+        }
+
+        // average squared distance from 'p' to the planes
+        FORR_NODISCARD float error(const glm::vec3& p) const noexcept {
+            float sum = a2 * p.x * p.x + b2 * p.y * p.y + c2 * p.z * p.z;
+            sum += 2.0f * (ab * p.x * p.y + ac * p.x * p.z + bc * p.y * p.z);
+            sum += 2.0f * (ad * p.x + bd * p.y + cd * p.z) + d2;
+
+            return weight > 0.0f ? std::max(sum, 0.0f) / weight : 0.0f;
+        }
+    };
+
+    struct EdgeCollapse {
+        Index from{};
+        Index to{};
+        float error{}; // squared distance
+    };
+} // namespace fe
+
+fe::VertexCacheStatistics fe::analyze_vertex_cache(std::span<const Index> indices, size_t vertex_count, uint32_t cache_size) {
+    fe::ArenaScope    arena_scope{ fe::thread_arena() };
+    fe::ArenaResource arena_resource{ fe::thread_arena() };
+
+    VertexCacheTimestamps     cache(vertex_count, cache_size, &arena_resource);
+    std::pmr::vector<uint8_t> used(vertex_count, 0, &arena_resource);
+
+    VertexCacheStatistics statistics{};
+    statistics.triangles = indices.size() / 3;
+
+    for (size_t i = 0; i < statistics.triangles * 3; i++) {
+        Index vertex = indices[i];
+
+        if (!used[vertex]) {
+            used[vertex] = 1;
+            statistics.vertices++;
+        }
+
+        if (cache.load(vertex)) statistics.transformed++;
+    }
+
+    return statistics;
+}
+
+size_t fe::generate_vertex_remap(const void* vertices, size_t vertex_count, size_t vertex_size, std::span<Index> remap) {
+    if (vertex_count == 0) return 0;
+
+    fe::ArenaScope    arena_scope{ fe::thread_arena() };
+    fe::ArenaResource arena_resource{ fe::thread_arena() };
+
+    const auto* bytes = static_cast<const std::byte*>(vertices);
+
+    // open addressing with linear probing, the table is at most half full
+    const size_t            mask = std::bit_ceil(vertex_count * 2) - 1;
+    std::pmr::vector<Index> table(mask + 1, UNUSED_VERTEX, &arena_resource);
+
+    size_t unique_count = 0;
+
+    for (size_t i = 0; i < vertex_count; i++) {
+        const std::byte* vertex = bytes + (i * vertex_size);
+
+        for (size_t slot = hash_bytes(vertex, vertex_size) & mask;; slot = (slot + 1) & mask) {
+            Index entry = table[slot];
+
+            if (entry == UNUSED_VERTEX) {
+                table[slot] = static_cast<Index>(i);
+                remap[i]    = static_cast<Index>(unique_count++);
+                break;
+            }
+            if (memcmp(bytes + (entry * vertex_size), vertex, vertex_size) == 0) {
+                remap[i] = remap[entry];
+                break;
+            }
+        }
+    }
+
+    return unique_count;
+}
+
+size_t fe::generate_vertex_fetch_remap(std::span<const Index> indices, size_t vertex_count, std::span<Index> remap) {
+    std::fill_n(remap.begin(), vertex_count, UNUSED_VERTEX);
+
+    size_t used_count = 0;
+    for (Index index : indices) {
+        if (remap[index] == UNUSED_VERTEX) remap[index] = static_cast<Index>(used_count++);
+    }
+
+    return used_count;
+}
+
+void fe::remap_indices(std::span<Index> indices, std::span<const Index> remap) noexcept {
+    for (Index& index : indices) index = remap[index];
+}
+
+void fe::optimize_vertex_cache(std::span<Index> indices, size_t vertex_count, std::vector<uint32_t>* clusters, uint32_t cache_size) {
+    if (clusters) clusters->clear();
+
+    const size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) return;
+
+    fe::ArenaScope    arena_scope{ fe::thread_arena() };
+    fe::ArenaResource arena_resource{ fe::thread_arena() };
+
+    // triangles of every vertex. 'live' is how many of them aren't emitted yet
+    std::pmr::vector<uint32_t> live(vertex_count, 0, &arena_resource);
+    for (size_t i = 0; i < triangle_count * 3; i++) live[indices[i]]++;
+
+    std::pmr::vector<uint32_t> offsets(vertex_count + 1, 0, &arena_resource);
+    for (size_t v = 0; v < vertex_count; v++) offsets[v + 1] = offsets[v] + live[v];
+
+    std::pmr::vector<uint32_t> adjacency(triangle_count * 3, &arena_resource);
+    std::pmr::vector<uint32_t> filled(offsets.begin(), offsets.end() - 1, &arena_resource);
+    for (size_t t = 0; t < triangle_count; t++) {
+        for (size_t k = 0; k < 3; k++) adjacency[filled[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+    }
+
+    VertexCacheTimestamps     cache(vertex_count, cache_size, &arena_resource);
+    std::pmr::vector<uint8_t> emitted(triangle_count, 0, &arena_resource);
+    std::pmr::vector<Index>   dead_ends(&arena_resource); // vertices of emitted triangles, the latest on top
+    std::pmr::vector<Index>   candidates(&arena_resource);
+    std::pmr::vector<Index>   result(&arena_resource);
+
+    dead_ends.reserve(triangle_count * 3);
+    result.reserve(triangle_count * 3);
+
+    size_t cursor = 0; // the lowest vertex that may still have live triangles
+
+    // the latest vertex that still has live triangles, or the first one in the input order
+    auto skip_dead_end = [&]() -> size_t {
+        while (!dead_ends.empty()) {
+            Index vertex = dead_ends.back();
+            dead_ends.pop_back();
+
+            if (live[vertex] > 0) return vertex;
+        }
+
+        for (; cursor < vertex_count; cursor++) {
+            if (live[cursor] > 0) return cursor;
+        }
+
+        return G_NO_VERTEX;
+    };
+
+    if (clusters) clusters->emplace_back(0);
+
+    for (size_t fanning = skip_dead_end(); fanning != G_NO_VERTEX;) {
+        candidates.clear();
+
+        // every live triangle around the fanning vertex
+        for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; a++) {
+            uint32_t triangle = adjacency[a];
+            if (emitted[triangle]) continue;
+
+            for (size_t k = 0; k < 3; k++) {
+                Index vertex = indices[triangle * 3 + k];
+
+                result.emplace_back(vertex);
+                dead_ends.emplace_back(vertex);
+                candidates.emplace_back(vertex);
+
+                live[vertex]--;
+                (void)cache.load(vertex);
+            }
+
+            emitted[triangle] = 1;
+        }
+
+        // the oldest vertex in the cache that stays there while its triangles are fanned out. a vertex that would be evicted
+        // in the middle goes last, and if no candidate has live triangles, the cache is cold for the next one
+        size_t  next          = G_NO_VERTEX;
+        int64_t best_priority = -1;
+
+        for (Index vertex : candidates) {
+            if (live[vertex] == 0) continue;
+
+            int64_t age      = cache.age(vertex);
+            int64_t priority = age + (2 * static_cast<int64_t>(live[vertex])) <= cache_size ? age : 0;
+
+            if (priority > best_priority) {
+                best_priority = priority;
+                next          = vertex;
+            }
+        }
+
+        if (next == G_NO_VERTEX) {
+            next = skip_dead_end();
+
+            uint32_t emitted_triangles = static_cast<uint32_t>(result.size() / 3);
+            if (clusters && next != G_NO_VERTEX && clusters->back() != emitted_triangles) clusters->emplace_back(emitted_triangles);
+        }
+
+        fanning = next;
+    }
+
+    std::copy(result.begin(), result.end(), indices.begin());
+}
+
+void fe::optimize_overdraw(std::span<Index> indices, std::span<const glm::vec3> positions, std::span<const uint32_t> clusters, float threshold, uint32_t cache_size) {
+    const size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0 || clusters.empty()) return;
+
+    fe::ArenaScope    arena_scope{ fe::thread_arena() };
+    fe::ArenaResource arena_resource{ fe::thread_arena() };
+
+    // a hard cluster is cut where its ACMR, counted from its start, is already close to the ACMR of the whole cluster.
+    // the next part starts with a cold cache, so the cut costs little
+    VertexCacheTimestamps      cache(positions.size(), cache_size, &arena_resource);
+    std::pmr::vector<uint32_t> starts(&arena_resource);
+
+    for (size_t c = 0; c < clusters.size(); c++) {
+        size_t start = clusters[c];
+        size_t end   = c + 1 < clusters.size() ? clusters[c + 1] : triangle_count;
+
+        cache.flush();
+
+        size_t cluster_misses = 0;
+        for (size_t t = start; t < end; t++) cluster_misses += triangleMisses(cache, indices, t);
+
+        float split_acmr = threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - start);
+
+        cache.flush();
+        starts.emplace_back(static_cast<uint32_t>(start));
+
+        size_t run_start  = start;
+        size_t run_misses = 0;
+
+        for (size_t t = start; t < end; t++) {
+            run_misses += triangleMisses(cache, indices, t);
+
+            if (t + 1 < end && static_cast<float>(run_misses) / static_cast<float>(t + 1 - run_start) <= split_acmr) {
+                cache.flush();
+                starts.emplace_back(static_cast<uint32_t>(t + 1));
+
+                run_start  = t + 1;
+                run_misses = 0;
+            }
+        }
+    }
+
+    // area weighted centroids and normals
+    struct Cluster {
+        glm::vec3 centroid{};
+        glm::vec3 normal{}; // sum of cross products, its length is twice the area
+        float     area{};
+        float     sort_key{};
+        uint32_t  start{};
+        uint32_t  end{};
+    };
+
+    std::pmr::vector<Cluster> soft_clusters(starts.size(), &arena_resource);
+
+    glm::vec3 mesh_centroid{};
+    float     mesh_area = 0.0f;
+
+    for (size_t c = 0; c < starts.size(); c++) {
+        Cluster& cluster = soft_clusters[c];
+        cluster.start    = starts[c];
+        cluster.end      = c + 1 < starts.size() ? starts[c + 1] : static_cast<uint32_t>(triangle_count);
+
+        for (uint32_t t = cluster.start; t < cluster.end; t++) {
+            const glm::vec3& p0 = positions[indices[t * 3 + 0]];
+            const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+            const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float     area   = glm::length(normal) * 0.5f;
+
+            cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+
+        mesh_centroid += cluster.centroid;
+        mesh_area += cluster.area;
+    }
+
+    if (mesh_area > 0.0f) mesh_centroid /= mesh_area;
+
+    for (Cluster& cluster : soft_clusters) {
+        glm::vec3 centroid = cluster.area > 0.0f ? cluster.centroid / cluster.area : mesh_centroid;
+        float     length   = glm::length(cluster.normal);
+        glm::vec3 normal   = length > 0.0f ? cluster.normal / length : glm::vec3(0.0f);
+
+        // the further a cluster is from the center along its own normal, the more it hides
+        cluster.sort_key = glm::dot(centroid - mesh_centroid, normal);
+    }
+
+    std::ranges::stable_sort(soft_clusters, std::ranges::greater{}, &Cluster::sort_key);
+
+    std::pmr::vector<Index> result(&arena_resource);
+    result.reserve(triangle_count * 3);
+
+    for (const Cluster& cluster : soft_clusters) {
+        result.insert(result.end(), indices.begin() + (cluster.start * 3), indices.begin() + (cluster.end * 3));
+    }
+
+    std::copy(result.begin(), result.end(), indices.begin());
+}
+
+void fe::build_meshlets(std::span<Index> indices, std::span<const glm::vec3> positions, std::vector<Meshlet>& meshlets, uint32_t max_vertices, uint32_t max_triangles) {
+    const size_t triangle_count = indices.size() / 3;
+    const size_t vertex_count   = positions.size();
+    if (triangle_count == 0 || max_vertices < 3 || max_triangles == 0) return;
+
+    fe::ArenaScope    arena_scope{ fe::thread_arena() };
+    fe::ArenaResource arena_resource{ fe::thread_arena() };
+
+    // triangles of every vertex
+    std::pmr::vector<uint32_t> offsets(vertex_count + 1, 0, &arena_resource);
+    for (size_t i = 0; i < triangle_count * 3; i++) offsets[indices[i] + 1]++;
+    for (size_t v = 0; v < vertex_count; v++) offsets[v + 1] += offsets[v];
+
+    std::pmr::vector<uint32_t> adjacency(triangle_count * 3, &arena_resource);
+    std::pmr::vector<uint32_t> filled(offsets.begin(), offsets.end() - 1, &arena_resource);
+    for (size_t t = 0; t < triangle_count; t++) {
+        for (size_t k = 0; k < 3; k++) adjacency[filled[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+    }
+
+    // unit normals, zero for degenerate triangles
+    std::pmr::vector<glm::vec3> normals(triangle_count, &arena_resource);
+    std::pmr::vector<glm::vec3> centroids(triangle_count, &arena_resource);
+    for (size_t t = 0; t < triangle_count; t++) {
+        const glm::vec3& p0 = positions[indices[t * 3 + 0]];
+        const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+        const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float     length = glm::length(normal);
+
+        normals[t]   = length > 0.0f ? normal / length : glm::vec3(0.0f);
+        centroids[t] = (p0 + p1 + p2) / 3.0f;
+    }
+
+    constexpr uint32_t NO_MESHLET  = std::numeric_limits<uint32_t>::max();
+    constexpr uint32_t NO_TRIANGLE = std::numeric_limits<uint32_t>::max();
+
+    std::pmr::vector<uint8_t>  emitted(triangle_count, 0, &arena_resource);
+    std::pmr::vector<uint32_t> vertex_meshlet(vertex_count, NO_MESHLET, &arena_resource);      // the last meshlet that has the vertex
+    std::pmr::vector<uint32_t> candidate_meshlet(triangle_count, NO_MESHLET, &arena_resource); // the last meshlet the triangle was a candidate of
+
+    std::pmr::vector<uint32_t> meshlet_triangles(&arena_resource);
+    std::pmr::vector<Index>    meshlet_vertices(&arena_resource);
+    std::pmr::vector<uint32_t> candidates(&arena_resource); // triangles that share a vertex with the meshlet
+    std::pmr::vector<Index>    result(&arena_resource);
+
+    result.reserve(triangle_count * 3);
+
+    size_t cursor = 0; // the lowest triangle that may be left
+
+    for (uint32_t meshlet_id = 0;; meshlet_id++) {
+        while (cursor < triangle_count && emitted[cursor]) cursor++;
+        if (cursor == triangle_count) break;
+
+        meshlet_triangles.clear();
+        meshlet_vertices.clear();
+        candidates.clear();
+
+        glm::vec3 normal_sum{};
+        glm::vec3 box_min(std::numeric_limits<float>::max());
+        glm::vec3 box_max(std::numeric_limits<float>::lowest());
+
+        auto new_vertices = [&](uint32_t triangle) {
+            uint32_t count = 0;
+            for (size_t k = 0; k < 3; k++) count += vertex_meshlet[indices[triangle * 3 + k]] != meshlet_id ? 1 : 0;
+            return count;
+        };
+
+        auto add = [&](uint32_t triangle) {
+            emitted[triangle] = 1;
+            meshlet_triangles.emplace_back(triangle);
+            normal_sum += normals[triangle];
+
+            for (size_t k = 0; k < 3; k++) {
+                Index vertex = indices[triangle * 3 + k];
+                if (vertex_meshlet[vertex] == meshlet_id) continue;
+
+                vertex_meshlet[vertex] = meshlet_id;
+                meshlet_vertices.emplace_back(vertex);
+                box_min = glm::min(box_min, positions[vertex]);
+                box_max = glm::max(box_max, positions[vertex]);
+
+                for (uint32_t a = offsets[vertex]; a < offsets[vertex + 1]; a++) {
+                    uint32_t neighbour = adjacency[a];
+                    if (emitted[neighbour] || candidate_meshlet[neighbour] == meshlet_id) continue;
+
+                    candidate_meshlet[neighbour] = meshlet_id;
+                    candidates.emplace_back(neighbour);
+                }
+            }
+        };
+
+        add(static_cast<uint32_t>(cursor));
+
+        while (meshlet_triangles.size() < max_triangles) {
+            const float     normal_length = glm::length(normal_sum);
+            const glm::vec3 axis          = normal_length > 0.0f ? normal_sum / normal_length : glm::vec3(0.0f);
+            const glm::vec3 center        = (box_min + box_max) * 0.5f;
+            const float     radius        = std::max(glm::distance(box_min, box_max) * 0.5f, std::numeric_limits<float>::min());
+
+            uint32_t best          = NO_TRIANGLE;
+            uint32_t best_vertices = 4;
+            float    best_cost     = std::numeric_limits<float>::max();
+
+            size_t kept = 0;
+            for (uint32_t triangle : candidates) {
+                if (emitted[triangle]) continue;
+                candidates[kept++] = triangle;
+
+                uint32_t vertices = new_vertices(triangle);
+                if (meshlet_vertices.size() + vertices > max_vertices) continue;
+
+                // fewer new vertices first, then the triangle that keeps the meshlet flat and round
+                float cost = (1.0f - glm::dot(normals[triangle], axis)) + (glm::distance(centroids[triangle], center) / radius);
+
+                if (vertices < best_vertices || (vertices == best_vertices && cost < best_cost)) {
+                    best          = triangle;
+                    best_vertices = vertices;
+                    best_cost     = cost;
+                }
+            }
+            candidates.resize(kept);
+
+            // a part without neighbours left continues with the next triangle in the order, it's near in an optimized list
+            if (best == NO_TRIANGLE && candidates.empty()) {
+                while (cursor < triangle_count && emitted[cursor]) cursor++;
+                if (cursor < triangle_count && meshlet_vertices.size() + new_vertices(static_cast<uint32_t>(cursor)) <= max_vertices) best = static_cast<uint32_t>(cursor);
+            }
+
+            if (best == NO_TRIANGLE) break;
+
+            add(best);
+        }
+
+        // the order of the input is kept inside of the meshlet, it's already good for the vertex cache
+        std::ranges::sort(meshlet_triangles);
+
+        Meshlet& meshlet     = meshlets.emplace_back();
+        meshlet.index_offset = static_cast<uint32_t>(result.size());
+        meshlet.index_count  = static_cast<uint32_t>(meshlet_triangles.size() * 3);
+        meshlet.vertex_count = static_cast<uint32_t>(meshlet_vertices.size());
+        meshlet.aabb_min     = box_min;
+        meshlet.aabb_max     = box_max;
+
+        meshlet.bounds.center = (box_min + box_max) * 0.5f;
+        for (Index vertex : meshlet_vertices) meshlet.bounds.radius = std::max(meshlet.bounds.radius, glm::distance(positions[vertex], meshlet.bounds.center));
+
+        for (uint32_t triangle : meshlet_triangles) result.insert(result.end(), indices.begin() + (triangle * 3), indices.begin() + (triangle * 3) + 3);
+
+        // the cone is too wide to be culled past ~84 degrees of its half angle
+        const float normal_length = glm::length(normal_sum);
+        if (normal_length > 0.0f) {
+            const glm::vec3 axis = normal_sum / normal_length;
+
+            float min_dot = 1.0f;
+            for (uint32_t triangle : meshlet_triangles) {
+                if (normals[triangle] != glm::vec3(0.0f)) min_dot = std::min(min_dot, glm::dot(normals[triangle], axis));
+            }
+
+            if (min_dot > 0.1f) {
+                meshlet.cone_axis   = axis;
+                meshlet.cone_cutoff = std::sqrt(1.0f - (min_dot * min_dot));
+            }
+        }
+    }
+
+    std::copy(result.begin(), result.end(), indices.begin());
+}
+
+size_t fe::simplify(std::span<const Index> indices, std::span<const glm::vec3> positions, size_t target_index_count, float target_error,
+                    std::span<Index> destination, float* result_error) {
+    const size_t vertex_count = positions.size();
+    size_t       index_count  = indices.size() / 3 * 3;
+
+    std::copy_n(indices.begin(), index_count, destination.begin());
+    if (result_error) *result_error = 0.0f;
+
+    if (index_count <= target_index_count || vertex_count == 0) return index_count;
+
+    fe::ArenaScope    arena_scope{ fe::thread_arena() };
+    fe::ArenaResource arena_resource{ fe::thread_arena() };
+
+    std::span<Index> result = destination.first(index_count);
+
+    // vertices at one position share an id, so seams and borders are found by positions and not by attributes
+    std::pmr::vector<Index> position_ids(vertex_count, &arena_resource);
+    const size_t            position_count = generate_vertex_remap(positions.data(), vertex_count, sizeof(glm::vec3), position_ids);
+
+    // a position is locked when it's on an attribute seam, on a border or on a non-manifold edge
+    std::pmr::vector<Index>   position_vertex(position_count, UNUSED_VERTEX, &arena_resource);
+    std::pmr::vector<uint8_t> locked(position_count, 0, &arena_resource);
+
+    for (Index vertex : result) {
+        Index& first = position_vertex[position_ids[vertex]];
+
+        if (first == UNUSED_VERTEX) first = vertex;
+        else if (first != vertex) locked[position_ids[vertex]] = 1;
+    }
+
+    {
+        std::pmr::unordered_map<uint64_t, uint32_t> edges(&arena_resource); // directed, by positions
+        edges.reserve(index_count);
+
+        auto edge_key = [](Index a, Index b) { return (static_cast<uint64_t>(a) << 32) | b; };
+
+        for (size_t i = 0; i < index_count; i += 3) {
+            for (size_t k = 0; k < 3; k++) edges[edge_key(position_ids[result[i + k]], position_ids[result[i + (k + 1) % 3]])]++;
+        }
+
+        for (const auto& [key, count] : edges) {
+            auto a = static_cast<Index>(key >> 32);
+            auto b = static_cast<Index>(key & 0xFFFFFFFF);
+
+            auto opposite = edges.find(edge_key(b, a));
+            if (count != 1 || opposite == edges.end() || opposite->second != 1) locked[a] = locked[b] = 1;
+        }
+    }
+
+    std::pmr::vector<Quadric> quadrics(position_count, &arena_resource);
+
+    for (size_t i = 0; i < index_count; i += 3) {
+        const glm::vec3& p0 = positions[result[i + 0]];
+        const glm::vec3& p1 = positions[result[i + 1]];
+        const glm::vec3& p2 = positions[result[i + 2]];
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float     length = glm::length(normal);
+        if (length <= 0.0f) continue;
+
+        Quadric quadric = Quadric::plane(p0, normal / length, length * 0.5f);
+        for (size_t k = 0; k < 3; k++) quadrics[position_ids[result[i + k]]] += quadric;
+    }
+
+    const float error_limit = target_error * target_error;
+    float       max_error   = 0.0f;
+
+    std::pmr::vector<uint32_t>     offsets(&arena_resource);
+    std::pmr::vector<uint32_t>     adjacency(&arena_resource);
+    std::pmr::vector<EdgeCollapse> collapses(&arena_resource);
+    std::pmr::vector<uint8_t>      pass_locked(vertex_count, 0, &arena_resource);
+    std::pmr::vector<Index>        collapse_to(vertex_count, UNUSED_VERTEX, &arena_resource);
+
+    // every pass collapses the cheapest edges that don't touch each other, then the list is rebuilt
+    while (index_count > target_index_count) {
+        const size_t triangle_count = index_count / 3;
+
+        offsets.assign(vertex_count + 1, 0);
+        for (size_t i = 0; i < index_count; i++) offsets[result[i] + 1]++;
+        for (size_t v = 0; v < vertex_count; v++) offsets[v + 1] += offsets[v];
+
+        adjacency.resize(index_count);
+        {
+            std::pmr::vector<uint32_t> filled(offsets.begin(), offsets.end() - 1, &arena_resource);
+            for (size_t t = 0; t < triangle_count; t++) {
+                for (size_t k = 0; k < 3; k++) adjacency[filled[result[t * 3 + k]]++] = static_cast<uint32_t>(t);
+            }
+        }
+
+        // the cheapest collapse of every free vertex to one of its neighbours
+        collapses.clear();
+
+        for (size_t v = 0; v < vertex_count; v++) {
+            if (offsets[v] == offsets[v + 1] || locked[position_ids[v]]) continue;
+
+            EdgeCollapse best{ static_cast<Index>(v), UNUSED_VERTEX, std::numeric_limits<float>::max() };
+
+            for (uint32_t a = offsets[v]; a < offsets[v + 1]; a++) {
+                for (size_t k = 0; k < 3; k++) {
+                    Index to = result[adjacency[a] * 3 + k];
+                    if (position_ids[to] == position_ids[v]) continue;
+
+                    Quadric quadric = quadrics[position_ids[v]];
+                    quadric += quadrics[position_ids[to]];
+
+                    float error = quadric.error(positions[to]);
+                    if (error < best.error) best = EdgeCollapse{ static_cast<Index>(v), to, error };
+                }
+            }
+
+            if (best.to != UNUSED_VERTEX) collapses.emplace_back(best);
+        }
+
+        if (collapses.empty()) break;
+
+        std::ranges::sort(collapses, {}, &EdgeCollapse::error);
+
+        std::ranges::fill(pass_locked, 0);
+
+        size_t removed_triangles   = 0;
+        size_t triangles_to_remove = (index_count - target_index_count + 2) / 3;
+        bool   collapsed           = false;
+
+        for (const EdgeCollapse& collapse : collapses) {
+            if (collapse.error > error_limit || removed_triangles >= triangles_to_remove) break;
+            if (pass_locked[collapse.from] || pass_locked[collapse.to]) continue;
+
+            const glm::vec3& from_position = positions[collapse.from];
+            const glm::vec3& to_position   = positions[collapse.to];
+
+            size_t degenerate = 0;
+            bool   flips      = false;
+
+            for (uint32_t a = offsets[collapse.from]; a < offsets[collapse.from + 1] && !flips; a++) {
+                const Index* triangle = &result[adjacency[a] * 3];
+
+                if (position_ids[triangle[0]] == position_ids[collapse.to] || position_ids[triangle[1]] == position_ids[collapse.to] ||
+                    position_ids[triangle[2]] == position_ids[collapse.to]) {
+                    degenerate++;
+                    continue;
+                }
+
+                glm::vec3 p[3]{ positions[triangle[0]], positions[triangle[1]], positions[triangle[2]] };
+                glm::vec3 old_normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+
+                for (glm::vec3& point : p) {
+                    if (point == from_position) point = to_position;
+                }
+                glm::vec3 new_normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+
+                // turning by more than ~75 degrees counts as a flip too, thin triangles turn over in the next passes
+                flips = glm::dot(old_normal, new_normal) < 0.25f * glm::length(old_normal) * glm::length(new_normal);
+            }
+
+            if (flips) continue;
+
+            collapse_to[collapse.from] = collapse.to;
+            quadrics[position_ids[collapse.to]] += quadrics[position_ids[collapse.from]];
+
+            max_error = std::max(max_error, collapse.error);
+            removed_triangles += degenerate;
+            collapsed = true;
+
+            // the triangles around are changed, their vertices wait for the next pass
+            for (uint32_t a = offsets[collapse.from]; a < offsets[collapse.from + 1]; a++) {
+                for (size_t k = 0; k < 3; k++) pass_locked[result[adjacency[a] * 3 + k]] = 1;
+            }
+        }
+
+        if (!collapsed) break;
+
+        // the triangles that had both ends of a collapsed edge are gone
+        size_t written = 0;
+        for (size_t i = 0; i < index_count; i += 3) {
+            Index triangle[3]{};
+            for (size_t k = 0; k < 3; k++) {
+                Index vertex = result[i + k];
+                triangle[k]  = collapse_to[vertex] != UNUSED_VERTEX ? collapse_to[vertex] : vertex;
+            }
+
+            Index p0 = position_ids[triangle[0]], p1 = position_ids[triangle[1]], p2 = position_ids[triangle[2]];
+            if (p0 == p1 || p1 == p2 || p2 == p0) continue;
+
+            for (size_t k = 0; k < 3; k++) result[written++] = triangle[k];
+        }
+
+        std::ranges::fill(collapse_to, UNUSED_VERTEX);
+
+        index_count = written;
+    }
+
+    if (result_error) *result_error = std::sqrt(max_error);
+    return index_count;
+}
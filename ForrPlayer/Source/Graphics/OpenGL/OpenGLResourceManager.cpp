@@ -13,16 +13,41 @@
 #include "pch.hpp"
 #include "OpenGLResourceManager.hpp"
 
+#include "ResourceManagement/TextureLayout.hpp"
+
 using namespace fe::resource;
 
+namespace fe {
+    // the attribute of the bound VAO and GL_ARRAY_BUFFER
+    static void setVertexAttribute(GLuint location, const VertexAttributeLayout& attribute, GLsizei stride) {
+        const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(attribute.offset));
+
+        // clang-format off
+        switch (attribute.format) {
+            case VertexAttributeFormat::UNORM16x4: glVertexAttribPointer(location, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, offset); break;
+            case VertexAttributeFormat::SNORM16x2: glVertexAttribPointer(location, 2, GL_SHORT, GL_TRUE, stride, offset); break;
+            case VertexAttributeFormat::FLOAT16x2: glVertexAttribPointer(location, 2, GL_HALF_FLOAT, GL_FALSE, stride, offset); break;
+            case VertexAttributeFormat::UNORM16x2: glVertexAttribPointer(location, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, offset); break;
+            case VertexAttributeFormat::UINT8x4  : glVertexAttribIPointer(location, 4, GL_UNSIGNED_BYTE, stride, offset); break; // integers in shaders
+            case VertexAttributeFormat::UNORM8x4 : glVertexAttribPointer(location, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, offset); break;
+        }
+        // clang-format on
+
+        glEnableVertexAttribArray(location);
+    }
+} // namespace fe
+
 template <>
 void fe::OpenGLResourceManager::CreateResource(Material& material) {
     OpenGLMaterial opengl_material{};
 
+    // a reloaded material links its program again in the same slot
+    if (material.gpu_handle.is_valid()) opengl_material.shader_program_handle = m_StorageMaterials[material.gpu_handle.index].shader_program_handle;
+
     auto vertex_shader   = m_ResourceManager.GetResource(material.vertex_shader_ptr);
     auto fragment_shader = m_ResourceManager.GetResource(material.fragment_shader_ptr);
 
-    this->createShaderProgram(opengl_material, { vertex_shader, fragment_shader });
+    this->createShaderProgram(opengl_material, material, { vertex_shader, fragment_shader });
 
     this->storeResource(material.gpu_handle, opengl_material, m_StorageMaterials);
 }
@@ -33,6 +58,8 @@ template void fe::OpenGLResourceManager::CreateResource(Material& material);
 template <>
 void fe::OpenGLResourceManager::CreateResource(Model& model) {
     for (auto& mesh : model.meshes) {
+        if (mesh.gpu_handle.is_valid()) continue; // already on the GPU
+
         this->createMesh(mesh);
     }
 }
@@ -106,6 +133,15 @@ void fe::OpenGLResourceManager::CreateResource(Texture& texture) {
         case Texture::InternalFormat::R8          : internal_format = GL_R8          ; break;
         case Texture::InternalFormat::SRGB8_ALPHA8: internal_format = GL_SRGB8_ALPHA8; break;
         case Texture::InternalFormat::SRGB8       : internal_format = GL_SRGB8       ; break;
+
+        case Texture::InternalFormat::BC1_RGB       : internal_format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT       ; break;
+        case Texture::InternalFormat::BC1_SRGB      : internal_format = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT      ; break;
+        case Texture::InternalFormat::BC3_RGBA      : internal_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT      ; break;
+        case Texture::InternalFormat::BC3_SRGB_ALPHA: internal_format = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT; break;
+        case Texture::InternalFormat::BC4_RED       : internal_format = GL_COMPRESSED_RED_RGTC1               ; break;
+        case Texture::InternalFormat::BC5_RG        : internal_format = GL_COMPRESSED_RG_RGTC2                ; break;
+        case Texture::InternalFormat::BC7_RGBA      : internal_format = GL_COMPRESSED_RGBA_BPTC_UNORM         ; break;
+        case Texture::InternalFormat::BC7_SRGB_ALPHA: internal_format = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM   ; break;
         default:
             fe::logging::warning("Unified -> OpenGL. Unsupported internal format %i. Using GL_RGBA8 as default", texture.internal_format);
             internal_format = GL_RGBA8;
@@ -124,6 +160,17 @@ void fe::OpenGLResourceManager::CreateResource(Texture& texture) {
     }
     // clang-format on
 
+    const bool compressed = is_block_compressed(texture.internal_format);
+
+    // RGTC and BPTC are core since 3.0 and 4.2, S3TC is still an extension
+    bool s3tc = internal_format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || internal_format == GL_COMPRESSED_SRGB_S3TC_DXT1_EXT ||
+                internal_format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT || internal_format == GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+
+    if (s3tc && !GLAD_GL_EXT_texture_compression_s3tc) {
+        fe::logging::error("Unified -> OpenGL. BC1 and BC3 textures need GL_EXT_texture_compression_s3tc");
+        return;
+    }
+
     glCreateTextures(GL_TEXTURE_2D, 1, &opengl_texture.id);
     glBindTexture(GL_TEXTURE_2D, opengl_texture.id);
 
@@ -133,17 +180,76 @@ void fe::OpenGLResourceManager::CreateResource(Texture& texture) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_s);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_t);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, texture.width, texture.height, 0, data_format, GL_UNSIGNED_BYTE, texture.bytes.get());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // rows of RGB8 mips aren't 4 byte aligned
+
+    // the importers make the mip chain on the CPU. textures made in code only have the top mip
+    for (uint32_t level = 0; level < texture.mip_count; level++) {
+        MipLevel mip = texture_mip_level(texture, level);
+
+        if (compressed)
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, internal_format, mip.width, mip.height, 0, static_cast<GLsizei>(mip.size), texture.bytes.get() + mip.offset);
+        else
+            glTexImage2D(GL_TEXTURE_2D, level, internal_format, mip.width, mip.height, 0, data_format, GL_UNSIGNED_BYTE, texture.bytes.get() + mip.offset);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // blocks can't be rendered to, compressed textures are always cooked with their chain
+    if (texture.mip_count == 1 && !compressed)
+        glGenerateMipmap(GL_TEXTURE_2D);
+    else
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.mip_count - 1);
 
-    glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    this->storeResource(texture.gpu_handle, opengl_texture, m_StorageTextures);
+    this->storeResource(texture.gpu_handle, opengl_texture, m_StorageTextures, &m_FreeTextures);
 }
 template void fe::OpenGLResourceManager::CreateResource(Texture& texture);
 
 ///
 
+template <>
+void fe::OpenGLResourceManager::UpdateResource(Material& material) {
+    this->CreateResource(material);
+}
+template void fe::OpenGLResourceManager::UpdateResource(Material& material);
+
+template <>
+void fe::OpenGLResourceManager::UpdateResource(Model& model) {
+    for (auto& mesh : model.meshes) {
+        this->createMesh(mesh); // the old buffers are deleted when the slot is replaced
+    }
+}
+template void fe::OpenGLResourceManager::UpdateResource(Model& model);
+
+template <>
+void fe::OpenGLResourceManager::UpdateResource(Texture& texture) {
+    // OpenGLTexture doesn't own its id
+    if (texture.gpu_handle.is_valid()) glDeleteTextures(1, &m_StorageTextures[texture.gpu_handle.index].id);
+
+    this->CreateResource(texture);
+}
+template void fe::OpenGLResourceManager::UpdateResource(Texture& texture);
+
+///
+
+template <>
+void fe::OpenGLResourceManager::DestroyResource(Model& model) {
+    for (auto& mesh : model.meshes) this->releaseResource(mesh.gpu_handle, m_StorageMeshes, m_FreeMeshes);
+}
+template void fe::OpenGLResourceManager::DestroyResource(Model& model);
+
+template <>
+void fe::OpenGLResourceManager::DestroyResource(Texture& texture) {
+    if (!texture.gpu_handle.is_valid()) return;
+
+    glDeleteTextures(1, &m_StorageTextures[texture.gpu_handle.index].id); // OpenGLTexture doesn't own its id
+    this->releaseResource(texture.gpu_handle, m_StorageTextures, m_FreeTextures);
+}
+template void fe::OpenGLResourceManager::DestroyResource(Texture& texture);
+
+///
+
 template<>
 const fe::OpenGLMaterial& fe::OpenGLResourceManager::GetResource(GPUHandle<resource::Material> handle) const {
     return m_StorageMaterials[handle.index];
@@ -178,10 +284,12 @@ fe::GPUHandle<Model::Mesh> fe::OpenGLResourceManager::createMesh(resource::Model
     glCreateBuffers(1, &vbo);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-    constexpr GLsizei stride = sizeof(Vertex);
+    // only the attributes of the mesh are in the buffer. the location is VertexAttribute
+    const VertexLayout layout = vertex_layout(mesh.vertex_format);
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*) offsetof(Vertex, position));
-    glEnableVertexAttribArray(0);
+    for (size_t i = 0; i < layout.attributes.size(); i++) {
+        if (layout.attributes[i].enabled) setVertexAttribute(static_cast<GLuint>(i), layout.attributes[i], static_cast<GLsizei>(layout.stride));
+    }
 
     glCreateBuffers(1, &ebo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
@@ -210,8 +318,29 @@ fe::GPUHandle<Model::Mesh> fe::OpenGLResourceManager::createMesh(resource::Model
         // clang-format on
     }
 
-    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(Vertex), mesh.vertices.data(), GL_STATIC_DRAW);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(GLuint), mesh.indices.data(), GL_STATIC_DRAW);
+    const size_t vertex_buffer_size = mesh.vertices.size() * layout.stride;
+
+    glBufferData(GL_ARRAY_BUFFER, vertex_buffer_size, nullptr, GL_STATIC_DRAW);
+    if (vertex_buffer_size != 0) {
+        void* vertex_data = glMapBufferRange(GL_ARRAY_BUFFER, 0, vertex_buffer_size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (vertex_data) pack_vertices(mesh.vertices.data(), mesh.vertices.size(), layout, vertex_data);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    // 16-bit indices are narrowed while writing, the mesh keeps fe::Index. importers don't make 8-bit ones
+    const RenderIndexType index_type = mesh.index_type == RenderIndexType::UNSIGNED_SHORT ? RenderIndexType::UNSIGNED_SHORT : RenderIndexType::UNSIGNED_INT;
+
+    opengl_mesh.index_type = index_type == RenderIndexType::UNSIGNED_SHORT ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    opengl_mesh.index_size = static_cast<uint32_t>(index_size(index_type));
+
+    const size_t index_buffer_size = mesh.indices.size() * opengl_mesh.index_size;
+
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_size, nullptr, GL_STATIC_DRAW);
+    if (index_buffer_size != 0) {
+        void* index_data = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, index_buffer_size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (index_data) pack_indices(mesh.indices, index_type, index_data);
+        glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    }
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
@@ -221,10 +350,10 @@ fe::GPUHandle<Model::Mesh> fe::OpenGLResourceManager::createMesh(resource::Model
     opengl_mesh.vbo.attach(vbo);
     opengl_mesh.ebo.attach(ebo);
 
-    return GPUHandle<Model::Mesh>(this->storeResource(mesh.gpu_handle, opengl_mesh, m_StorageMeshes));
+    return GPUHandle<Model::Mesh>(this->storeResource(mesh.gpu_handle, opengl_mesh, m_StorageMeshes, &m_FreeMeshes));
 }
 
-fe::GPUHandle<fe::OpenGLShaderProgram> fe::OpenGLResourceManager::createShaderProgram(OpenGLMaterial& opengl_material, std::vector<resource::Shader*> shaders) {
+fe::GPUHandle<fe::OpenGLShaderProgram> fe::OpenGLResourceManager::createShaderProgram(OpenGLMaterial& opengl_material, const resource::Material& material, std::vector<resource::Shader*> shaders) {
     OpenGLShaderProgram opengl_shader_program_raii{};
     GLuint              opengl_shader_program = glCreateProgram();
 
@@ -243,8 +372,20 @@ fe::GPUHandle<fe::OpenGLShaderProgram> fe::OpenGLResourceManager::createShaderPr
 
         opengl_shader = glCreateShader(opengl_type);
 
+        // only the constants that this shader declares, OpenGL fails on unknown ones
+        std::vector<GLuint> constant_ids{};
+        std::vector<GLuint> constant_values{};
+
+        for (const auto& [name, value] : material.specialization_values) {
+            auto it = shader->specialization_constants.find(name);
+            if (it == shader->specialization_constants.end()) continue;
+
+            constant_ids.emplace_back(it->second.constant_id);
+            constant_values.emplace_back(value);
+        }
+
         glShaderBinary(1, &opengl_shader, GL_SHADER_BINARY_FORMAT_SPIR_V, shader->source_code.data(), shader->source_code.size() * sizeof(uint32_t));
-        glSpecializeShader(opengl_shader, "main", 0, nullptr, nullptr);
+        glSpecializeShader(opengl_shader, "main", static_cast<GLuint>(constant_ids.size()), constant_ids.data(), constant_values.data());
 
         glCompileShader(opengl_shader);
 
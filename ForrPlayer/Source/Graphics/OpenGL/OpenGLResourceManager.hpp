@@ -28,6 +28,14 @@ namespace fe {
         template <resource::resource_t T>
         void CreateResource(T& resource);
 
+        // makes the GPU resource of a reloaded resource again in the same GPU slots, so nothing that refers to them has to change
+        template <resource::resource_t T>
+        void UpdateResource(T& resource);
+
+        // frees the GPU objects of an evicted resource and makes its GPU handles invalid. the GPU must not use them anymore
+        template <resource::resource_t T>
+        void DestroyResource(T& resource);
+
         // here used 'typename T' instead of 'resource::resource_t T' because this function can be called by GPU types too
         // for example : 'typename T = OpenGLShaderProgram', which is called by 'OpenGLMaterial'
         template <typename T>
@@ -37,18 +45,40 @@ namespace fe {
              // The functions return 'GPUHandle<>' but you DON'T have to set 'GPUHandle<> gpu_handle' in the resources, the functions does it by themselves
 
         fe::GPUHandle<fe::resource::Model::Mesh> createMesh(resource::Model::Mesh& mesh);
-        GPUHandle<OpenGLShaderProgram>           createShaderProgram(OpenGLMaterial& opengl_material, std::vector<resource::Shader*> shaders);
+        GPUHandle<OpenGLShaderProgram>           createShaderProgram(OpenGLMaterial& opengl_material, const resource::Material& material, std::vector<resource::Shader*> shaders);
 
     private:
         // this function returns the index of the resource ( GPUHandle<>::index )
         // you DON'T have to set 'GPUHandle<> gpu_handle' in the resources by yourself, the function does it by itself
+        // a valid 'gpu_handle_dst' means that the resource is made again ( hot reload ), it keeps its slot.
+        // otherwise a slot freed by releaseResource() is taken first
         template <typename T, typename GPU_T>
-        size_t storeResource(GPUHandle<T>& gpu_handle_dst, GPU_T& gpu_resource, std::vector<GPU_T>& storage) {
+        size_t storeResource(GPUHandle<T>& gpu_handle_dst, GPU_T& gpu_resource, std::vector<GPU_T>& storage, std::vector<size_t>* free_slots = nullptr) {
+            if (!gpu_handle_dst.is_valid() && free_slots && !free_slots->empty()) {
+                gpu_handle_dst.index = free_slots->back();
+                free_slots->pop_back();
+            }
+
+            if (gpu_handle_dst.is_valid() && gpu_handle_dst.index < storage.size()) {
+                storage[gpu_handle_dst.index] = std::move(gpu_resource);
+                return gpu_handle_dst.index;
+            }
+
             storage.emplace_back(std::move(gpu_resource));
             gpu_handle_dst.index = storage.size() - 1;
             return gpu_handle_dst.index;
         }
 
+        // destroys the GPU resource in the slot and gives the slot to the next storeResource()
+        template <typename T, typename GPU_T>
+        void releaseResource(GPUHandle<T>& gpu_handle, std::vector<GPU_T>& storage, std::vector<size_t>& free_slots) {
+            if (!gpu_handle.is_valid() || gpu_handle.index >= storage.size()) return;
+
+            storage[gpu_handle.index] = GPU_T{};
+            free_slots.emplace_back(gpu_handle.index);
+            gpu_handle = {};
+        }
+
     private:
         ResourceManager& m_ResourceManager;
 
@@ -56,5 +86,8 @@ namespace fe {
         std::vector<OpenGLShaderProgram> m_StorageShaderPrograms{};
         std::vector<OpenGLMesh>          m_StorageMeshes{};
         std::vector<OpenGLTexture>       m_StorageTextures{};
+
+        std::vector<size_t> m_FreeMeshes{};   // slots of evicted meshes
+        std::vector<size_t> m_FreeTextures{}; // slots of evicted textures
     };
 } // namespace fe
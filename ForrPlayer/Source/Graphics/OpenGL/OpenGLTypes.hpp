@@ -66,6 +66,9 @@ namespace fe {
         fe::gl::Buffer      vbo{};
         fe::gl::Buffer      ebo{};
 
+        GLenum   index_type{ GL_UNSIGNED_INT };
+        uint32_t index_size{ sizeof(GLuint) }; // in bytes, index_offset of primitives is in indices
+
         std::vector<OpenGLPrimitive> primitives{};
 
         OpenGLMesh()  = default;
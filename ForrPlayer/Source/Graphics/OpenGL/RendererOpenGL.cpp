@@ -53,6 +53,9 @@ fe::RendererOpenGL::RendererOpenGL(const RendererDesc& desc,
         m_Camera.setMovementSpeed(speed);
     }
 
+    m_LodSelector.setPixelError(desc.lod_pixel_error);
+    m_ClusterCuller.setEnabled(desc.cluster_culling_enabled);
+
     this->createSceneDataSSBO();
 }
 
@@ -65,6 +68,11 @@ void fe::RendererOpenGL::SetClearColor(float red, float green, float blue, float
 }
 
 void fe::RendererOpenGL::BeginFrame() {
+    m_FrameArena.begin_frame(0);
+
+    this->uploadPendingResources();
+    this->updateResidency();
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     { // temp
@@ -81,23 +89,63 @@ void fe::RendererOpenGL::BeginFrame() {
 
     m_SceneData.projection_matrix = m_Camera.getPerspectiveMatrix();
     m_SceneData.view_matrix       = m_Camera.getViewMatrix();
+
+    m_LodSelector.beginFrame(m_Camera, static_cast<float>(m_PrimaryWindow.getHeight()));
+    m_ClusterCuller.beginFrame(m_Camera);
 }
 
 void fe::RendererOpenGL::Draw(DrawMeshCommand command) {
-    const auto& model = *m_ResourceManager.GetResource(command.model_ptr);
+    m_ResourceManager.TouchResource(command.model_ptr); // an evicted model is imported again, it has no meshes on the GPU until then
+
+    const auto& model = *m_ResourceManager.GetResourceOrFallback(command.model_ptr); // the fallback model is empty
+
+    // textures of the file of the model. evicted ones are imported again
+    for (auto texture_ptr : model.textures) m_ResourceManager.TouchResource(texture_ptr);
+
+    // positions are quantized, the model matrix takes them back to the space of the model
+    const glm::mat4 model_matrix = command.transform * model.vertex_quantization.dequantization_matrix();
+
+    const uint64_t instance_key = m_LodSelector.instanceKey(command.model_ptr.packed());
+
+    // scratch memory for the visible index ranges. returned to the thread's arena at the end of the function
+    fe::ArenaScope               arena_scope{ fe::thread_arena() };
+    fe::ArenaResource            arena_resource{ fe::thread_arena() };
+    std::pmr::vector<IndexRange> ranges(&arena_resource);
+
+    for (size_t mesh_index = 0; mesh_index < model.meshes.size(); mesh_index++) {
+        const auto& mesh = model.meshes[mesh_index];
+        if (!mesh.gpu_handle.is_valid()) continue; // not uploaded yet
+
+        // skinned vertices leave the bounds
+        const bool cull_clusters = m_ClusterCuller.isEnabled() && !mesh.vertex_format.has(VertexAttribute::JOINTS);
+        if (cull_clusters && !m_ClusterCuller.isVisible(command.transform, mesh.bounds)) continue;
 
-    for (const auto& mesh : model.meshes) {
         const auto& opengl_mesh = m_OpenGLResourceManager.GetResource(mesh.gpu_handle);
 
         for (size_t i = 0; i < mesh.primitives.size(); i++) {
-            const auto& primitive        = mesh.primitives[i];
-            const auto& opengl_primitive = opengl_mesh.primitives[i];
-
-            const auto& material              = *m_ResourceManager.GetResource(primitive.material_ptr);
-            const auto& opengl_material       = m_OpenGLResourceManager.GetResource(material.gpu_handle);
+            const auto& primitive = mesh.primitives[i];
+
+            const uint64_t lod_key = hash_combine(hash_combine(instance_key, mesh_index), i);
+            const MeshLod  lod     = primitive.lod(m_LodSelector.select(lod_key, mesh.bounds, command.transform, primitive.lods));
+
+            ranges.clear();
+            if (cull_clusters && lod.meshlet_count > 0) {
+                m_ClusterCuller.cull(command.transform, std::span(mesh.meshlets).subspan(lod.meshlet_offset, lod.meshlet_count), ranges);
+                if (ranges.empty()) continue;
+            }
+            else {
+                ranges.emplace_back(IndexRange{ static_cast<uint32_t>(lod.index_offset), static_cast<uint32_t>(lod.index_count) });
+            }
+
+            const auto* material = m_ResourceManager.GetResourceOrFallback(primitive.material_ptr);
+            if (!material->gpu_handle.is_valid()) {
+                material = m_ResourceManager.GetResourceOrFallback(fe::pointer<resource::Material>{});
+            }
+
+            const auto& opengl_material       = m_OpenGLResourceManager.GetResource(material->gpu_handle);
             const auto& opengl_shader_program = m_OpenGLResourceManager.GetResource(opengl_material.shader_program_handle);
 
-            m_SceneData.model_matrices[m_MeshIndex] = command.transform; // TODO : check "Docs/not-now-but.md" 30.04.2026 - add sorting
+            m_SceneData.model_matrices[m_MeshIndex] = model_matrix; // TODO : check "Docs/not-now-but.md" 30.04.2026 - add sorting
             glNamedBufferSubData(m_SceneSSBO, 0, sizeof(m_SceneData), &m_SceneData);
 
             glUseProgram(opengl_shader_program.shader_program);
@@ -107,7 +155,10 @@ void fe::RendererOpenGL::Draw(DrawMeshCommand command) {
             auto location = glGetUniformLocation(opengl_shader_program.shader_program, "model_index");
             glUniform1i(location, m_MeshIndex);
 
-            glDrawElements(GL_TRIANGLES, primitive.index_count, GL_UNSIGNED_INT, (void*) primitive.index_offset);
+            for (const IndexRange& range : ranges) {
+                const auto index_byte_offset = static_cast<uintptr_t>(range.index_offset) * opengl_mesh.index_size;
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(range.index_count), opengl_mesh.index_type, reinterpret_cast<const void*>(index_byte_offset));
+            }
 
             glBindVertexArray(0);
             glUseProgram(0);
@@ -123,23 +174,114 @@ void fe::RendererOpenGL::EndFrame() {
 }
 
 void fe::RendererOpenGL::InitializeGPUResources() {
-    m_ResourceManager.RunForEach<resource::Texture>([&](resource::Texture& texture) {
+    m_ResourceManager.RunForEach<resource::Texture>([&](fe::pointer<resource::Texture> texture_ptr, resource::Texture& texture) {
+        if (texture.gpu_handle.is_valid()) return;
+
         m_OpenGLResourceManager.CreateResource(texture);
 
         fe::logging::info("Loaded texture's size : %i %i", texture.width, texture.height);
+
+        m_ResourceManager.MarkUploaded(texture_ptr);
     });
 
     m_ResourceManager.RunForEach<resource::Material>([&](resource::Material& material) {
+        if (material.gpu_handle.is_valid()) return;
+
         m_OpenGLResourceManager.CreateResource(material);
     });
 
-    m_ResourceManager.RunForEach<resource::Model>([&](resource::Model& model) {
+    m_ResourceManager.RunForEach<resource::Model>([&](fe::pointer<resource::Model> model_ptr, resource::Model& model) {
         m_OpenGLResourceManager.CreateResource(model);
 
         fe::logging::info("Loaded model's mesh count %i", model.meshes.size());
+
+        m_ResourceManager.MarkUploaded(model_ptr);
     });
 }
 
+void fe::RendererOpenGL::uploadPendingResources() {
+    ResourceUploadQueue queue = m_ResourceManager.TakeUploadQueue();
+
+    for (auto texture_ptr : queue.textures) {
+        auto* texture = m_ResourceManager.GetResource(texture_ptr);
+        if (!texture || texture->gpu_handle.is_valid()) continue;
+
+        m_OpenGLResourceManager.CreateResource(*texture);
+        m_ResourceManager.MarkUploaded(texture_ptr);
+    }
+
+    for (auto material_ptr : queue.materials) {
+        auto* material = m_ResourceManager.GetResource(material_ptr);
+        if (material && !material->gpu_handle.is_valid()) m_OpenGLResourceManager.CreateResource(*material);
+    }
+
+    for (auto model_ptr : queue.models) {
+        auto* model = m_ResourceManager.GetResource(model_ptr);
+        if (!model) continue;
+
+        this->uploadModel(*model);
+        m_ResourceManager.MarkUploaded(model_ptr);
+    }
+
+    // hot-reloaded and restored resources keep their GPU slots
+    for (auto texture_ptr : queue.reloaded_textures) {
+        auto* texture = m_ResourceManager.GetResource(texture_ptr);
+        if (!texture) continue;
+
+        m_OpenGLResourceManager.UpdateResource(*texture);
+        m_ResourceManager.MarkUploaded(texture_ptr);
+    }
+
+    for (auto material_ptr : queue.reloaded_materials) {
+        if (auto* material = m_ResourceManager.GetResource(material_ptr)) m_OpenGLResourceManager.UpdateResource(*material);
+    }
+
+    for (auto texture_ptr : queue.destroyed_textures) {
+        if (auto* texture = m_ResourceManager.GetResource(texture_ptr)) m_OpenGLResourceManager.DestroyResource(*texture);
+        m_ResourceManager.DestroyResource(texture_ptr);
+    }
+
+    for (auto model_ptr : queue.reloaded_models) {
+        auto* model = m_ResourceManager.GetResource(model_ptr);
+        if (!model) continue;
+
+        m_OpenGLResourceManager.UpdateResource(*model);
+        this->uploadModel(*model); // materials of a reloaded glTF are new
+        m_ResourceManager.MarkUploaded(model_ptr);
+    }
+}
+
+void fe::RendererOpenGL::updateResidency() {
+    ResidencyEvictions evictions = m_ResourceManager.UpdateResidency(0); // OpenGL doesn't report a memory budget
+    if (evictions.textures.empty() && evictions.models.empty()) return;
+
+    for (auto texture_ptr : evictions.textures) {
+        if (auto* texture = m_ResourceManager.GetResource(texture_ptr)) m_OpenGLResourceManager.DestroyResource(*texture);
+        m_ResourceManager.EvictResource(texture_ptr);
+    }
+
+    for (auto model_ptr : evictions.models) {
+        if (auto* model = m_ResourceManager.GetResource(model_ptr)) m_OpenGLResourceManager.DestroyResource(*model);
+        m_ResourceManager.EvictResource(model_ptr);
+    }
+
+    const ResidencyStats& stats = m_ResourceManager.GetResidencyStats();
+    fe::logging::info("Evicted %zu textures and %zu models. CPU : %.2f MB, GPU : %.2f MB",
+                      evictions.textures.size(), evictions.models.size(), stats.cpu_bytes / (1024.0 * 1024.0), stats.gpu_bytes / (1024.0 * 1024.0));
+}
+
+void fe::RendererOpenGL::uploadModel(resource::Model& model) {
+    // materials of the model were created by the importer, so they aren't in the upload queue
+    for (auto& mesh : model.meshes) {
+        for (auto& primitive : mesh.primitives) {
+            auto* material = m_ResourceManager.GetResource(primitive.material_ptr);
+            if (material && !material->gpu_handle.is_valid()) m_OpenGLResourceManager.CreateResource(*material);
+        }
+    }
+
+    m_OpenGLResourceManager.CreateResource(model);
+}
+
 void fe::RendererOpenGL::createSceneDataSSBO() {
     GLuint opengl_scene_data_ssbo{};
 
@@ -13,6 +13,8 @@
 #pragma once
 #include "Graphics/IRenderer.hpp"
 #include "Graphics/Camera.hpp"
+#include "Graphics/LevelOfDetail.hpp"
+#include "Graphics/ClusterCulling.hpp"
 
 #include "OpenGLResourceManager.hpp"
 
@@ -31,10 +33,15 @@ namespace fe {
         void Draw(DrawMeshCommand command) override;
         void EndFrame() override;
 
+        fe::Arena& GetFrameArena() override { return m_FrameArena.get(); }
+
         void InitializeGPUResources() override;
 
     private:
         void createSceneDataSSBO();
+        void uploadPendingResources(); // creates GPU resources of asynchronously imported resources
+        void uploadModel(resource::Model& model);
+        void updateResidency(); // frees GPU objects of resources that weren't used for long, when a budget is exceeded
         void increaseMeshIndex() noexcept { m_MeshIndex++; }
         void resetMeshIndex() noexcept { m_MeshIndex = 0; }
 
@@ -50,8 +57,13 @@ namespace fe {
 
         Camera m_Camera{}; // temp
 
+        LodSelector   m_LodSelector{};
+        ClusterCuller m_ClusterCuller{};
+
         size_t          m_MeshIndex{};
         GlobalSceneData m_SceneData{};
         fe::gl::Buffer  m_SceneSSBO{};
+
+        fe::FrameArena<1> m_FrameArena{}; // OpenGL syncs implicitly, one frame is enough
     };
 } // namespace fe
@@ -12,58 +12,130 @@
 
 #include "pch.hpp"
 #include "Graphics/Shaders/ShaderCompiler.hpp"
+#include "Graphics/Shaders/ShaderReflector.hpp"
 
 #include "shaderc/shaderc.hpp"
 
+#include "Core/hash.hpp"
+#include "Core/job_system.hpp"
+
 #include <fstream>
+#include <vector>
 
-void fe::ShaderCompiler::Compile(std::vector<uint32_t>& dst, std::string_view src, resource::Shader::Type shader_type, GraphicsBackend graphics_backend) {
-    static shaderc::Compiler compiler{};
+namespace fe {
+    // every option that changes SPIR-V. Compile() and Hash() both take it from here, so the hash can't miss an option
+    struct ShaderCompileSettings {
+        shaderc_shader_kind   kind{ shaderc_glsl_vertex_shader };
+        shaderc_target_env    target_environment{ shaderc_target_env_opengl };
+        shaderc_env_version   target_environment_version{ shaderc_env_version_opengl_4_5 };
+        int                   version{ 450 };
+        shaderc_profile       profile{ shaderc_profile_core };
 
-    shaderc::CompileOptions options{};
-    shaderc_shader_kind     kind{};
+        std::vector<std::string> macro_definitions{};
+    };
 
-    switch (graphics_backend) {
-        case GraphicsBackend::OpenGL:
+    static ShaderCompileSettings makeSettings(resource::Shader::Type shader_type, GraphicsBackend graphics_backend, std::span<const std::string> defines, bool report) {
+        ShaderCompileSettings settings{};
 
-            options.AddMacroDefinition("FORR_USE_OPENGL");
-            options.SetTargetEnvironment(shaderc_target_env_opengl, shaderc_env_version_opengl_4_5);
+        switch (graphics_backend) {
+            case GraphicsBackend::OpenGL:
 
-            break;
-        case GraphicsBackend::Vulkan:
+                settings.macro_definitions.emplace_back("FORR_USE_OPENGL");
+                settings.target_environment         = shaderc_target_env_opengl;
+                settings.target_environment_version = shaderc_env_version_opengl_4_5;
 
-            options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+                break;
+            case GraphicsBackend::Vulkan:
 
-            break;
-        default:
-            fe::logging::warning("The selected graphics backend %i for shader was not found. Using the default one", graphics_backend);
+                settings.target_environment         = shaderc_target_env_vulkan;
+                settings.target_environment_version = shaderc_env_version_vulkan_1_2;
 
-            options.AddMacroDefinition("FORR_USE_OPENGL");
-            options.SetTargetEnvironment(shaderc_target_env_opengl, shaderc_env_version_opengl_4_5);
+                break;
+            default:
+                if (report) fe::logging::warning("The selected graphics backend %i for shader was not found. Using the default one", graphics_backend);
 
-            break;
-    }
+                settings.macro_definitions.emplace_back("FORR_USE_OPENGL");
+                settings.target_environment         = shaderc_target_env_opengl;
+                settings.target_environment_version = shaderc_env_version_opengl_4_5;
 
-    options.SetForcedVersionProfile(450, shaderc_profile_core);
+                break;
+        }
 
-    // clang-format off
-    switch (shader_type) {
-        case resource::Shader::Type::VERTEX  : kind = shaderc_shader_kind::shaderc_glsl_vertex_shader  ; break;
-        case resource::Shader::Type::FRAGMENT: kind = shaderc_shader_kind::shaderc_glsl_fragment_shader; break;
-        default:
-            fe::logging::warning("The selected shader type %i was not found. Using the default one", shader_type);
-            kind = shaderc_shader_kind::shaderc_glsl_vertex_shader;
-            break;
+        // clang-format off
+        switch (shader_type) {
+            case resource::Shader::Type::VERTEX  : settings.kind = shaderc_shader_kind::shaderc_glsl_vertex_shader  ; break;
+            case resource::Shader::Type::FRAGMENT: settings.kind = shaderc_shader_kind::shaderc_glsl_fragment_shader; break;
+            default:
+                if (report) fe::logging::warning("The selected shader type %i was not found. Using the default one", shader_type);
+                settings.kind = shaderc_shader_kind::shaderc_glsl_vertex_shader;
+                break;
+        }
+        // clang-format on
+
+        settings.macro_definitions.insert(settings.macro_definitions.end(), defines.begin(), defines.end());
+
+        return settings;
     }
-    // clang-format on
+} // namespace fe
+
+void fe::ShaderCompiler::Compile(resource::Shader::SourceCode& dst, std::string_view src, resource::Shader::Type shader_type, GraphicsBackend graphics_backend, std::span<const std::string> defines) {
+    thread_local shaderc::Compiler compiler{}; // a compiler per worker, they don't share any state
 
-    auto result = compiler.CompileGlslToSpv(src.data(), src.size(), kind, "shader", options);
+    ShaderCompileSettings settings = makeSettings(shader_type, graphics_backend, defines, true);
+
+    shaderc::CompileOptions options{};
+
+    for (const std::string& macro_definition : settings.macro_definitions) options.AddMacroDefinition(macro_definition);
+
+    options.SetTargetEnvironment(settings.target_environment, settings.target_environment_version);
+    options.SetForcedVersionProfile(settings.version, settings.profile);
+
+    auto result = compiler.CompileGlslToSpv(src.data(), src.size(), settings.kind, "shader", options);
 
     if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
-        fe::logging::error("Failed to compile a shader\nShader Type : %i\n///\n%s\n///\n%s", shader_type, src.data(), result.GetErrorMessage().c_str());
+        // 'src' isn't null-terminated when it's a part of a bigger buffer
+        fe::logging::error("Failed to compile a shader\nShader Type : %i\n///\n%.*s\n///\n%s", static_cast<int>(shader_type), static_cast<int>(src.size()), src.data(),
+                           result.GetErrorMessage().c_str());
         dst.clear();
         return;
     }
 
     dst.assign(result.cbegin(), result.cend());
 }
+
+void fe::ShaderCompiler::CompileBatch(std::span<const ShaderCompileRequest> requests, std::span<resource::Shader> shaders) {
+    if (requests.size() != shaders.size()) {
+        fe::logging::error("Failed to compile a batch of shaders. There are %zu requests for %zu shaders", requests.size(), shaders.size());
+        return;
+    }
+
+    // one shader per job, compiling takes much longer than scheduling
+    JOBS.parallel_for(0, requests.size(), 1, [&](size_t index) {
+        const ShaderCompileRequest& request = requests[index];
+        resource::Shader&           shader  = shaders[index];
+
+        shader.type = request.type;
+
+        ShaderCompiler::Compile(shader.source_code, request.source, request.type, request.graphics_backend, request.defines);
+        if (shader.source_code.empty()) return; // the compiler has already reported why
+
+        ShaderReflector::Reflect(shader, request.name);
+    });
+}
+
+uint64_t fe::ShaderCompiler::Hash(std::string_view src, resource::Shader::Type shader_type, GraphicsBackend graphics_backend, std::span<const std::string> defines) {
+    ShaderCompileSettings settings = makeSettings(shader_type, graphics_backend, defines, false);
+
+    uint64_t hash = hash_string("ShaderCompiler");
+    hash          = hash_combine(hash, ShaderCompiler::VERSION);
+    hash          = hash_combine(hash, static_cast<uint64_t>(settings.kind));
+    hash          = hash_combine(hash, static_cast<uint64_t>(settings.target_environment));
+    hash          = hash_combine(hash, static_cast<uint64_t>(settings.target_environment_version));
+    hash          = hash_combine(hash, static_cast<uint64_t>(settings.version));
+    hash          = hash_combine(hash, static_cast<uint64_t>(settings.profile));
+
+    for (const std::string& macro_definition : settings.macro_definitions) hash = hash_string(macro_definition, hash);
+    hash = hash_combine(hash, settings.macro_definitions.size());
+
+    return hash_string(src, hash);
+}
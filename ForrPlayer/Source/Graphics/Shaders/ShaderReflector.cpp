@@ -56,6 +56,27 @@ void fe::ShaderReflector::Reflect(resource::Shader& shader, const std::filesyste
         }
     }
 
+    count = 0;
+    spvReflectEnumerateSpecializationConstants(&module, &count, nullptr);
+
+    std::vector<SpvReflectSpecializationConstant*> constants(count);
+    spvReflectEnumerateSpecializationConstants(&module, &count, constants.data());
+
+    shader.specialization_constants.clear();
+
+    for (const auto* constant : constants) {
+        if (constant->name == nullptr || constant->default_value_size != sizeof(uint32_t)) {
+            fe::logging::warning("Specialization constant %u is skipped. It has no name or it's not 32-bit. Path : %s", constant->constant_id, resource_full_path.string().c_str());
+            continue;
+        }
+
+        Shader::SpecializationConstant specialization_constant{};
+        specialization_constant.constant_id = constant->constant_id;
+        memcpy(&specialization_constant.value, constant->default_value, sizeof(uint32_t));
+
+        shader.specialization_constants.insert({ constant->name, specialization_constant });
+    }
+
     spvReflectDestroyShaderModule(&module);
 
     if (!is_scene_data_ssbo_found) {
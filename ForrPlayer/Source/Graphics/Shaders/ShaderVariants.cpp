@@ -0,0 +1,85 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ShaderVariants.cpp
+    Role : compile-time permutations of shaders
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Graphics/Shaders/ShaderVariants.hpp"
+
+#include <algorithm>
+
+namespace fe {
+    static constexpr std::string_view G_KEYWORDS_PRAGMA = "forr_keywords";
+
+    static bool isSpace(char c) noexcept { return c == ' ' || c == '\t' || c == '\r'; }
+
+    static bool isIdentifier(std::string_view name) noexcept {
+        if (name.empty() || (name[0] >= '0' && name[0] <= '9')) return false;
+
+        return std::all_of(name.begin(), name.end(), [](char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        });
+    }
+
+    // the next word of the line, 'line' is moved after it
+    static std::string_view nextWord(std::string_view& line) noexcept {
+        size_t begin = 0;
+        while (begin < line.size() && isSpace(line[begin])) begin++;
+
+        size_t end = begin;
+        while (end < line.size() && !isSpace(line[end])) end++;
+
+        std::string_view word = line.substr(begin, end - begin);
+        line.remove_prefix(end);
+        return word;
+    }
+} // namespace fe
+
+bool fe::ShaderVariants::ParseKeywords(std::string_view source, std::vector<std::string>& keywords) {
+    keywords.clear();
+
+    while (!source.empty()) {
+        size_t           line_end = source.find('\n');
+        std::string_view line     = source.substr(0, line_end);
+        source.remove_prefix(line_end == std::string_view::npos ? source.size() : line_end + 1);
+
+        if (nextWord(line) != "#pragma" || nextWord(line) != G_KEYWORDS_PRAGMA) continue;
+
+        for (std::string_view keyword = nextWord(line); !keyword.empty(); keyword = nextWord(line)) {
+            if (!isIdentifier(keyword)) {
+                fe::logging::error("Failed to parse shader keywords. '%.*s' is not a valid macro name", static_cast<int>(keyword.size()), keyword.data());
+                return false;
+            }
+            if (std::find(keywords.begin(), keywords.end(), keyword) != keywords.end()) {
+                fe::logging::error("Failed to parse shader keywords. '%.*s' is declared twice", static_cast<int>(keyword.size()), keyword.data());
+                return false;
+            }
+
+            keywords.emplace_back(keyword);
+        }
+    }
+
+    if (keywords.size() > MAX_KEYWORDS) {
+        fe::logging::error("Failed to parse shader keywords. There are %zu keywords, the limit is %zu. Use specialization constants for the rest", keywords.size(), MAX_KEYWORDS);
+        return false;
+    }
+
+    return true;
+}
+
+std::vector<std::string> fe::ShaderVariants::GetDefines(std::span<const std::string> keywords, uint64_t variant_key) {
+    std::vector<std::string> defines{};
+
+    for (size_t i = 0; i < keywords.size(); i++) {
+        if (variant_key & (uint64_t{ 1 } << i)) defines.emplace_back(keywords[i]);
+    }
+
+    return defines;
+}
@@ -0,0 +1,249 @@
+/*===============================================
+
+    Forr Engine
+
+    File : VertexFormat.cpp
+    Role : quantization of fe::Vertex and the layout of vertex and index buffers
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Graphics/VertexFormat.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+namespace fe {
+    // the memcpy in pack_vertices() relies on this
+    static_assert(sizeof(Vertex) == 28 && offsetof(Vertex, weights) == 24, "fe::Vertex has to be tightly packed");
+
+    static constexpr float G_UNORM16_MAX = 65535.0f;
+    static constexpr float G_SNORM16_MAX = 32767.0f;
+
+    static uint16_t toUNorm16(float value) {
+        return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * G_UNORM16_MAX + 0.5f);
+    }
+
+    static int16_t toSNorm16(float value) {
+        return static_cast<int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * G_SNORM16_MAX));
+    }
+
+    static float fromSNorm16(int16_t value) {
+        return std::max(static_cast<float>(value) / G_SNORM16_MAX, -1.0f);
+    }
+
+    static glm::vec2 signNotZero(const glm::vec2& value) {
+        return glm::vec2(value.x >= 0.0f ? 1.0f : -1.0f, value.y >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    // rounds every weight down and gives the rest to the largest ones, so the sum is exactly 255
+    static glm::u8vec4 quantizeWeights(const glm::vec4& weights) {
+        glm::vec4 clamped = glm::max(weights, glm::vec4(0.0f));
+        float     sum     = clamped.x + clamped.y + clamped.z + clamped.w;
+        if (sum <= 0.0f) return glm::u8vec4(255, 0, 0, 0);
+
+        glm::vec4   scaled = clamped * (255.0f / sum);
+        glm::u8vec4 result{};
+        int         rest = 255;
+
+        for (int i = 0; i < 4; i++) {
+            result[i] = static_cast<uint8_t>(std::floor(scaled[i]));
+            rest -= result[i];
+        }
+
+        while (rest > 0) {
+            int largest = 0;
+            for (int i = 1; i < 4; i++) {
+                if (scaled[i] - result[i] > scaled[largest] - result[largest]) largest = i;
+            }
+
+            result[largest]++;
+            scaled[largest] = static_cast<float>(result[largest]); // this one has got its part
+            rest--;
+        }
+
+        return result;
+    }
+
+    static uint32_t attributeSize(VertexAttributeFormat format) {
+        return format == VertexAttributeFormat::UNORM16x4 ? 8 : 4;
+    }
+
+    template <typename T>
+    static void narrowIndices(std::span<const Index> indices, T* out) noexcept {
+        for (size_t i = 0; i < indices.size(); i++) out[i] = static_cast<T>(indices[i]);
+    }
+} // namespace fe
+
+fe::VertexQuantization fe::vertex_quantization(const glm::vec3& min, const glm::vec3& max) noexcept {
+    VertexQuantization quantization{};
+    quantization.bias  = min;
+    quantization.scale = max - min;
+
+    for (int i = 0; i < 3; i++) {
+        if (!(quantization.scale[i] > 0.0f)) quantization.scale[i] = 1.0f;
+    }
+
+    return quantization;
+}
+
+glm::u16vec4 fe::quantize_position(const glm::vec3& position, const VertexQuantization& quantization) noexcept {
+    glm::vec3 normalized = (position - quantization.bias) / quantization.scale;
+    return glm::u16vec4(toUNorm16(normalized.x), toUNorm16(normalized.y), toUNorm16(normalized.z), 65535);
+}
+
+glm::vec3 fe::dequantize_position(const glm::u16vec4& position, const VertexQuantization& quantization) noexcept {
+    return glm::vec3(position) / G_UNORM16_MAX * quantization.scale + quantization.bias;
+}
+
+glm::i16vec2 fe::encode_octahedral(const glm::vec3& direction) noexcept {
+    float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+    if (length <= 0.0f) return glm::i16vec2(0, 0);
+
+    glm::vec2 projected = glm::vec2(direction) / length;
+    if (direction.z < 0.0f) {
+        projected = (1.0f - glm::abs(glm::vec2(projected.y, projected.x))) * signNotZero(projected);
+    }
+
+    return glm::i16vec2(toSNorm16(projected.x), toSNorm16(projected.y));
+}
+
+glm::vec3 fe::decode_octahedral(const glm::i16vec2& encoded) noexcept {
+    glm::vec2 projected(fromSNorm16(encoded.x), fromSNorm16(encoded.y));
+
+    glm::vec3 direction(projected, 1.0f - std::abs(projected.x) - std::abs(projected.y));
+    if (direction.z < 0.0f) {
+        glm::vec2 folded = (1.0f - glm::abs(glm::vec2(direction.y, direction.x))) * signNotZero(projected);
+        direction.x      = folded.x;
+        direction.y      = folded.y;
+    }
+
+    float length = glm::length(direction);
+    return length > 0.0f ? direction / length : glm::vec3(0.0f, 0.0f, 1.0f);
+}
+
+fe::Vertex fe::encode_vertex(const VertexData& data, const VertexQuantization& quantization, const VertexFormat& format) noexcept {
+    Vertex vertex{};
+    vertex.position = quantize_position(data.position, quantization);
+
+    if (format.has(VertexAttribute::NORMAL)) {
+        vertex.normal = encode_octahedral(data.normal);
+    }
+    if (format.has(VertexAttribute::TANGENT)) {
+        vertex.tangent    = encode_octahedral(glm::vec3(data.tangent));
+        vertex.position.w = data.tangent.w < 0.0f ? 0 : 65535;
+    }
+    if (format.has(VertexAttribute::TEXTURE_COORD)) {
+        if (format.unorm_texture_coords) {
+            vertex.texture_coord = glm::u16vec2(toUNorm16(data.texture_coord.x), toUNorm16(data.texture_coord.y));
+        }
+        else {
+            vertex.texture_coord = glm::u16vec2(glm::packHalf1x16(data.texture_coord.x), glm::packHalf1x16(data.texture_coord.y));
+        }
+    }
+    if (format.has(VertexAttribute::JOINTS)) {
+        vertex.joints = glm::u8vec4(glm::min(data.joints, glm::u16vec4(255)));
+    }
+    if (format.has(VertexAttribute::WEIGHTS)) {
+        vertex.weights = quantizeWeights(data.weights);
+    }
+
+    return vertex;
+}
+
+fe::VertexData fe::decode_vertex(const Vertex& vertex, const VertexQuantization& quantization, const VertexFormat& format) noexcept {
+    VertexData data{};
+    data.position = dequantize_position(vertex.position, quantization);
+
+    if (format.has(VertexAttribute::NORMAL)) {
+        data.normal = decode_octahedral(vertex.normal);
+    }
+    if (format.has(VertexAttribute::TANGENT)) {
+        data.tangent = glm::vec4(decode_octahedral(vertex.tangent), vertex.position.w == 0 ? -1.0f : 1.0f);
+    }
+    if (format.has(VertexAttribute::TEXTURE_COORD)) {
+        if (format.unorm_texture_coords) {
+            data.texture_coord = glm::vec2(vertex.texture_coord) / G_UNORM16_MAX;
+        }
+        else {
+            data.texture_coord = glm::vec2(glm::unpackHalf1x16(vertex.texture_coord.x), glm::unpackHalf1x16(vertex.texture_coord.y));
+        }
+    }
+    if (format.has(VertexAttribute::JOINTS)) {
+        data.joints = glm::u16vec4(vertex.joints);
+    }
+    if (format.has(VertexAttribute::WEIGHTS)) {
+        data.weights = glm::vec4(vertex.weights) / 255.0f;
+    }
+
+    return data;
+}
+
+fe::VertexLayout fe::vertex_layout(const VertexFormat& format) noexcept {
+    // clang-format off
+    const std::array<VertexAttributeFormat, static_cast<size_t>(VertexAttribute::COUNT)> formats = {
+        VertexAttributeFormat::UNORM16x4,
+        VertexAttributeFormat::SNORM16x2,
+        VertexAttributeFormat::SNORM16x2,
+        format.unorm_texture_coords ? VertexAttributeFormat::UNORM16x2 : VertexAttributeFormat::FLOAT16x2,
+        VertexAttributeFormat::UINT8x4,
+        VertexAttributeFormat::UNORM8x4,
+    };
+
+    const std::array<uint32_t, static_cast<size_t>(VertexAttribute::COUNT)> source_offsets = {
+        offsetof(Vertex, position),
+        offsetof(Vertex, normal),
+        offsetof(Vertex, tangent),
+        offsetof(Vertex, texture_coord),
+        offsetof(Vertex, joints),
+        offsetof(Vertex, weights),
+    };
+    // clang-format on
+
+    VertexLayout layout{};
+
+    for (size_t i = 0; i < layout.attributes.size(); i++) {
+        if (!format.has(static_cast<VertexAttribute>(i)) && i != static_cast<size_t>(VertexAttribute::POSITION)) continue;
+
+        VertexAttributeLayout& attribute = layout.attributes[i];
+        attribute.enabled       = true;
+        attribute.offset        = layout.stride;
+        attribute.source_offset = source_offsets[i];
+        attribute.format        = formats[i];
+        attribute.size          = attributeSize(formats[i]);
+
+        layout.stride += attribute.size;
+    }
+
+    return layout;
+}
+
+void fe::pack_vertices(const Vertex* vertices, size_t count, const VertexLayout& layout, void* destination) noexcept {
+    auto* out = static_cast<std::byte*>(destination);
+
+    // the full set is fe::Vertex as it is
+    if (layout.stride == sizeof(Vertex)) {
+        memcpy(out, vertices, count * sizeof(Vertex));
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const auto* in = reinterpret_cast<const std::byte*>(vertices + i);
+
+        for (const VertexAttributeLayout& attribute : layout.attributes) {
+            if (attribute.enabled) memcpy(out + attribute.offset, in + attribute.source_offset, attribute.size);
+        }
+
+        out += layout.stride;
+    }
+}
+
+void fe::pack_indices(std::span<const Index> indices, RenderIndexType type, void* destination) noexcept {
+    switch (type) {
+        case RenderIndexType::UNSIGNED_BYTE: narrowIndices(indices, static_cast<uint8_t*>(destination)); break;
+        case RenderIndexType::UNSIGNED_SHORT: narrowIndices(indices, static_cast<uint16_t*>(destination)); break;
+        default: memcpy(destination, indices.data(), indices.size_bytes());
+    }
+}
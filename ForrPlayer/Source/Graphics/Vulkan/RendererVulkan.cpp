@@ -18,6 +18,66 @@
 
 #include "Tools.hpp"
 
+namespace fe {
+    // all of them have mandatory support for vertex buffers
+    static VkFormat toVkFormat(VertexAttributeFormat format) {
+        // clang-format off
+        switch (format) {
+            case VertexAttributeFormat::UNORM16x4: return VK_FORMAT_R16G16B16A16_UNORM;
+            case VertexAttributeFormat::SNORM16x2: return VK_FORMAT_R16G16_SNORM;
+            case VertexAttributeFormat::FLOAT16x2: return VK_FORMAT_R16G16_SFLOAT;
+            case VertexAttributeFormat::UNORM16x2: return VK_FORMAT_R16G16_UNORM;
+            case VertexAttributeFormat::UINT8x4  : return VK_FORMAT_R8G8B8A8_UINT;
+            case VertexAttributeFormat::UNORM8x4 : return VK_FORMAT_R8G8B8A8_UNORM;
+        }
+        // clang-format on
+
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    using SpecializationConstants = std::unordered_map<std::string, resource::Shader::SpecializationConstant>;
+
+    struct SpecializationData {
+        std::vector<VkSpecializationMapEntry> entries{};
+        std::vector<uint32_t>                 values{};
+        VkSpecializationInfo                  info{};
+    };
+
+    // only the values of the constants that the stage declares, the others keep their defaults
+    static void fillSpecialization(SpecializationData& data, const SpecializationConstants& constants, const resource::Material& material) {
+        for (const auto& [name, value] : material.specialization_values) {
+            auto it = constants.find(name);
+            if (it == constants.end()) continue;
+
+            VkSpecializationMapEntry& entry = data.entries.emplace_back();
+            entry.constantID                = it->second.constant_id;
+            entry.offset                    = static_cast<uint32_t>(data.values.size() * sizeof(uint32_t));
+            entry.size                      = sizeof(uint32_t); // bools are VkBool32
+
+            data.values.emplace_back(value);
+        }
+
+        data.info.mapEntryCount = static_cast<uint32_t>(data.entries.size());
+        data.info.pMapEntries   = data.entries.data();
+        data.info.dataSize      = data.values.size() * sizeof(uint32_t);
+        data.info.pData         = data.values.data();
+    }
+
+    // a sum, so the order of the material's map doesn't matter
+    static uint64_t specializationKey(const SpecializationConstants& constants, const resource::Material& material, VkShaderStageFlagBits stage) {
+        uint64_t key = 0;
+
+        for (const auto& [name, value] : material.specialization_values) {
+            auto it = constants.find(name);
+            if (it == constants.end()) continue;
+
+            key += hash_combine(hash_combine(stage, it->second.constant_id), value);
+        }
+
+        return key;
+    }
+} // namespace fe
+
 fe::RendererVulkan::RendererVulkan(const RendererDesc& desc,
                                    IPlatformSystem&    platform_system,
                                    size_t              primary_window_index,
@@ -28,6 +88,8 @@ fe::RendererVulkan::RendererVulkan(const RendererDesc& desc,
       m_ResourceManager(resource_manager) {
 
     this->configureCamera();
+    m_LodSelector.setPixelError(desc.lod_pixel_error);
+    m_ClusterCuller.setEnabled(desc.cluster_culling_enabled);
 
     this->InitializeBase();
     this->InitializeDevice();
@@ -58,6 +120,11 @@ void fe::RendererVulkan::BeginFrame() {
     vkWaitForFences(m_Device, fences.size(), fences.data(), VK_TRUE, UINT64_MAX);
     VK_CHECK_RESULT(vkResetFences(m_Device, fences.size(), fences.data()));
 
+    m_FrameArena.begin_frame(m_CurrentFrame); // the GPU is done with this frame, so is its memory
+
+    this->uploadPendingResources();
+    this->updateResidency(); // after the fence wait, the evicted resources weren't used for more frames than are in flight
+
     m_ImageIndex = 0;
 
     VkResult result = vkAcquireNextImageKHR(m_Device, m_Context.swapchain, UINT64_MAX, m_PresentCompleteSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &m_ImageIndex);
@@ -111,7 +178,7 @@ void fe::RendererVulkan::BeginFrame() {
 
     vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &m_StorageBuffers[m_CurrentFrame].descriptor_set, 0, nullptr);
 
-    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+    m_BoundPipeline = VK_NULL_HANDLE; // Draw() binds the pipeline of every mesh's vertex format
 
     { // temp
         auto glfw_window = (GLFWwindow*) m_PrimaryWindow.getNativeHandle();
@@ -131,27 +198,63 @@ void fe::RendererVulkan::BeginFrame() {
 
     m_SceneData.projection_matrix = m_Camera.getPerspectiveMatrix();
     m_SceneData.view_matrix       = m_Camera.getViewMatrix();
+
+    m_LodSelector.beginFrame(m_Camera, static_cast<float>(m_Context.swapchain_extent.height));
+    m_ClusterCuller.beginFrame(m_Camera);
 }
 
 void fe::RendererVulkan::Draw(DrawMeshCommand command) {
-    const auto& model = *m_ResourceManager.GetResource(command.model_ptr);
+    m_ResourceManager.TouchResource(command.model_ptr); // an evicted model is imported again, it has no meshes on the GPU until then
+
+    const auto& model = *m_ResourceManager.GetResourceOrFallback(command.model_ptr); // the fallback model is empty
+
+    // textures of the file of the model. evicted ones are imported again
+    for (auto texture_ptr : model.textures) m_ResourceManager.TouchResource(texture_ptr);
+
+    // positions are quantized, the model matrix takes them back to the space of the model.
+    // it's set before the draws, they read the storage buffer copied below
+    m_SceneData.model_matrices[m_MeshIndex] = command.transform * model.vertex_quantization.dequantization_matrix();
+
+    const uint64_t instance_key = m_LodSelector.instanceKey(command.model_ptr.packed());
+
+    // scratch memory for the visible index ranges. returned to the thread's arena at the end of the function
+    fe::ArenaScope               arena_scope{ fe::thread_arena() };
+    fe::ArenaResource            arena_resource{ fe::thread_arena() };
+    std::pmr::vector<IndexRange> ranges(&arena_resource);
+
+    for (size_t mesh_index = 0; mesh_index < model.meshes.size(); mesh_index++) {
+        const auto& mesh = model.meshes[mesh_index];
+        if (!mesh.gpu_handle.is_valid()) continue; // not uploaded yet
+
+        // skinned vertices leave the bounds
+        const bool cull_clusters = m_ClusterCuller.isEnabled() && !mesh.vertex_format.has(VertexAttribute::JOINTS);
+        if (cull_clusters && !m_ClusterCuller.isVisible(command.transform, mesh.bounds)) continue;
 
-    for (const auto& mesh : model.meshes) {
         const auto& vulkan_mesh = m_VulkanResourceManager.GetResource(mesh.gpu_handle);
 
         for (size_t i = 0; i < mesh.primitives.size(); i++) {
-            const auto& primitive        = mesh.primitives[i];
-            const auto& vulkan_primitive = vulkan_mesh.primitives[i];
+            const auto& primitive = mesh.primitives[i];
+
+            const auto& material = *m_ResourceManager.GetResourceOrFallback(primitive.material_ptr);
+            this->bindPipeline(mesh.vertex_format, material);
 
-            const auto& material = *m_ResourceManager.GetResource(primitive.material_ptr);
+            const uint64_t lod_key = hash_combine(hash_combine(instance_key, mesh_index), i);
+            const MeshLod  lod     = primitive.lod(m_LodSelector.select(lod_key, mesh.bounds, command.transform, primitive.lods));
+
+            ranges.clear();
+            if (cull_clusters && lod.meshlet_count > 0) {
+                m_ClusterCuller.cull(command.transform, std::span(mesh.meshlets).subspan(lod.meshlet_offset, lod.meshlet_count), ranges);
+                if (ranges.empty()) continue;
+            }
+            else {
+                ranges.emplace_back(IndexRange{ static_cast<uint32_t>(lod.index_offset), static_cast<uint32_t>(lod.index_count) });
+            }
 
             memcpy(m_StorageBuffers[m_CurrentFrame].mapped, &m_SceneData, sizeof(ShaderData));
 
-            this->DrawPrimitive(vulkan_mesh.vertex_buffer, vulkan_mesh.index_buffer, vulkan_primitive.index_offset, vulkan_primitive.index_count);
+            this->DrawPrimitive(vulkan_mesh.vertex_buffer, vulkan_mesh.index_buffer, ranges);
         }
     }
-    
-    m_SceneData.model_matrices[m_MeshIndex] = command.transform;
 
     this->increaseMeshIndex();
 }
@@ -206,21 +309,137 @@ void fe::RendererVulkan::EndFrame() {
 }
 
 void fe::RendererVulkan::InitializeGPUResources() {
-    m_ResourceManager.RunForEach<resource::Texture>([&](resource::Texture& texture) {
+    m_ResourceManager.RunForEach<resource::Texture>([&](fe::pointer<resource::Texture> texture_ptr, resource::Texture& texture) {
+        if (texture.gpu_handle.is_valid()) return;
+
         m_VulkanResourceManager.CreateResource(texture);
 
         fe::logging::info("VULKAN. Loaded texture's size : %i %i", texture.width, texture.height);
+
+        m_ResourceManager.MarkUploaded(texture_ptr);
     });
 
     m_ResourceManager.RunForEach<resource::Material>([&](const resource::Material& material) { // TODO : provide materials
         // ...
     });
 
-    m_ResourceManager.RunForEach<resource::Model>([&](resource::Model& model) {
+    m_ResourceManager.RunForEach<resource::Model>([&](fe::pointer<resource::Model> model_ptr, resource::Model& model) {
         m_VulkanResourceManager.CreateResource(model);
 
         fe::logging::info("VULKAN. Loaded model's mesh count %i", model.meshes.size());
+
+        m_ResourceManager.MarkUploaded(model_ptr);
+    });
+}
+
+void fe::RendererVulkan::uploadPendingResources() {
+    ResourceUploadQueue queue = m_ResourceManager.TakeUploadQueue();
+
+    for (auto texture_ptr : queue.textures) {
+        auto* texture = m_ResourceManager.GetResource(texture_ptr);
+        if (!texture || texture->gpu_handle.is_valid()) continue;
+
+        m_VulkanResourceManager.CreateResource(*texture);
+        m_ResourceManager.MarkUploaded(texture_ptr);
+    }
+
+    for (auto model_ptr : queue.models) {
+        auto* model = m_ResourceManager.GetResource(model_ptr);
+        if (!model) continue;
+
+        m_VulkanResourceManager.CreateResource(*model);
+        m_ResourceManager.MarkUploaded(model_ptr);
+    }
+
+    // hot-reloaded resources keep their GPU slots, but the previous frames may still use the old objects
+    if (queue.reloaded_textures.empty() && queue.reloaded_models.empty() && queue.reloaded_shaders.empty() && queue.destroyed_textures.empty()) return;
+
+    vkDeviceWaitIdle(m_Device);
+
+    for (auto texture_ptr : queue.destroyed_textures) {
+        if (auto* texture = m_ResourceManager.GetResource(texture_ptr)) m_VulkanResourceManager.DestroyResource(*texture);
+        m_ResourceManager.DestroyResource(texture_ptr);
+    }
+
+    for (auto texture_ptr : queue.reloaded_textures) {
+        auto* texture = m_ResourceManager.GetResource(texture_ptr);
+        if (!texture) continue;
+
+        m_VulkanResourceManager.UpdateResource(*texture);
+        m_ResourceManager.MarkUploaded(texture_ptr);
+    }
+
+    for (auto model_ptr : queue.reloaded_models) {
+        auto* model = m_ResourceManager.GetResource(model_ptr);
+        if (!model) continue;
+
+        m_VulkanResourceManager.UpdateResource(*model);
+        m_ResourceManager.MarkUploaded(model_ptr);
+    }
+
+    // the pipeline is made from the default glTF shaders
+    const ResourceManagementContext& context = m_ResourceManager.GetContext();
+
+    bool rebuild_pipeline = std::ranges::any_of(queue.reloaded_shaders, [&](fe::pointer<resource::Shader> shader_ptr) {
+        return shader_ptr == context.default_gltf_vertex_shader_ptr || shader_ptr == context.default_gltf_fragment_shader_ptr;
     });
+
+    if (rebuild_pipeline) {
+        auto* vertex_shader   = m_ResourceManager.GetResource(context.default_gltf_vertex_shader_ptr);
+        auto* fragment_shader = m_ResourceManager.GetResource(context.default_gltf_fragment_shader_ptr);
+
+        if (vertex_shader && fragment_shader) this->InitializePipeline(vertex_shader, fragment_shader);
+    }
+}
+
+void fe::RendererVulkan::updateResidency() {
+    ResidencyEvictions evictions = m_ResourceManager.UpdateResidency(this->queryMemoryBudget());
+    if (evictions.textures.empty() && evictions.models.empty()) return;
+
+    for (auto texture_ptr : evictions.textures) {
+        if (auto* texture = m_ResourceManager.GetResource(texture_ptr)) m_VulkanResourceManager.DestroyResource(*texture);
+        m_ResourceManager.EvictResource(texture_ptr);
+    }
+
+    for (auto model_ptr : evictions.models) {
+        if (auto* model = m_ResourceManager.GetResource(model_ptr)) m_VulkanResourceManager.DestroyResource(*model);
+        m_ResourceManager.EvictResource(model_ptr);
+    }
+
+    const ResidencyStats& stats = m_ResourceManager.GetResidencyStats();
+    fe::logging::info("VULKAN. Evicted %zu textures and %zu models. CPU : %.2f MB, GPU : %.2f MB",
+                      evictions.textures.size(), evictions.models.size(), stats.cpu_bytes / (1024.0 * 1024.0), stats.gpu_bytes / (1024.0 * 1024.0));
+}
+
+size_t fe::RendererVulkan::queryMemoryBudget() {
+    if (!m_Context.memory_budget_supported) return 0;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget_properties{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT
+    };
+
+    VkPhysicalDeviceMemoryProperties2 memory_properties{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+        .pNext = &budget_properties
+    };
+
+    vkGetPhysicalDeviceMemoryProperties2(m_PhysicalDevice, &memory_properties);
+
+    VkDeviceSize budget{};
+    VkDeviceSize usage{};
+
+    for (uint32_t i = 0; i < memory_properties.memoryProperties.memoryHeapCount; i++) {
+        if (!(memory_properties.memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)) continue;
+
+        budget += budget_properties.heapBudget[i];
+        usage += budget_properties.heapUsage[i];
+    }
+
+    // the heap usage includes the resources tracked by the residency, everything else ( swapchain, depth, other processes ) isn't ours to evict
+    const size_t tracked = m_ResourceManager.GetResidencyStats().gpu_bytes;
+    const size_t other   = usage > tracked ? static_cast<size_t>(usage) - tracked : 0;
+
+    return budget > other ? static_cast<size_t>(budget) - other : 1; // 1 - everything that can go has to
 }
 
 void fe::RendererVulkan::configureCamera() {
@@ -279,11 +498,21 @@ void fe::RendererVulkan::InitializeDevice() {
 
     // TODO : Add enabled features adding
 
+    // cooked textures are block compressed. without it they aren't uploaded
+    if (m_Context.physical_device_features.textureCompressionBC) m_Context.enabled_physical_device_features.textureCompressionBC = VK_TRUE;
+
     this->VKSetupQueueFamilyProperties();
     this->VKSetupSupportedExtensions();
 
     // TODO : Add enabled extensions adding
 
+    // optional, the residency uses the budget of the device heaps when it's there
+    auto& supported = m_Context.supported_device_extensions;
+    if (std::find(supported.begin(), supported.end(), VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) != supported.end()) {
+        m_Context.enabled_physical_device_extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        m_Context.memory_budget_supported = true;
+    }
+
     this->VKCreateDevice();
     this->VKCreateCommandPool();
     this->VKSetupQueues();
@@ -559,9 +788,40 @@ void fe::RendererVulkan::InitializeDescriptors() {
     this->VKSetupDescriptorSets();
 }
 
-void fe::RendererVulkan::InitializePipeline() {
+void fe::RendererVulkan::InitializePipeline(const resource::Shader* vertex_shader, const resource::Shader* fragment_shader) {
     this->VKSetupPipelineLayout();
 
+    m_VertexShaderModule = vertex_shader ? this->createShaderModule(*vertex_shader)
+                                         : this->createShaderModule(PATH.getDefaultShadersPath() / "gLTF" / "shader.vert.spv");
+
+    m_FragmentShaderModule = fragment_shader ? this->createShaderModule(*fragment_shader)
+                                             : this->createShaderModule(PATH.getDefaultShadersPath() / "gLTF" / "shader.frag.spv");
+
+    assert(m_VertexShaderModule != VK_NULL_HANDLE);
+    assert(m_FragmentShaderModule != VK_NULL_HANDLE);
+
+    m_VertexSpecializationConstants   = vertex_shader ? vertex_shader->specialization_constants : SpecializationConstants{};
+    m_FragmentSpecializationConstants = fragment_shader ? fragment_shader->specialization_constants : SpecializationConstants{};
+
+    m_Pipelines.clear(); // made again with the new shaders when they are bound
+}
+
+void fe::RendererVulkan::bindPipeline(const VertexFormat& vertex_format, const resource::Material& material) {
+    const uint64_t specialization_key = specializationKey(m_VertexSpecializationConstants, material, VK_SHADER_STAGE_VERTEX_BIT) +
+                                        specializationKey(m_FragmentSpecializationConstants, material, VK_SHADER_STAGE_FRAGMENT_BIT);
+    const uint64_t key = hash_combine(vertex_format.key(), specialization_key);
+
+    auto it = m_Pipelines.find(key);
+    if (it == m_Pipelines.end()) it = m_Pipelines.emplace(key, this->createPipeline(vertex_format, material)).first;
+
+    VkPipeline pipeline = it->second;
+    if (pipeline == m_BoundPipeline) return;
+
+    vkCmdBindPipeline(m_CommandBuffers[m_CurrentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    m_BoundPipeline = pipeline;
+}
+
+fe::vk::Pipeline fe::RendererVulkan::createPipeline(const VertexFormat& vertex_format, const resource::Material& material) {
     VkGraphicsPipelineCreateInfo graphics_pipeline_create_info{};
     graphics_pipeline_create_info.sType      = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
     graphics_pipeline_create_info.layout     = m_PipelineLayout;
@@ -620,45 +880,53 @@ void fe::RendererVulkan::InitializePipeline() {
     multisample_state_create_info.sType                = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
     multisample_state_create_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
+    // the mesh's buffer has only its attributes. the location is VertexAttribute, shaders may not read all of them
+    const VertexLayout layout = vertex_layout(vertex_format);
+
     VkVertexInputBindingDescription vertex_input_binding_description{};
     vertex_input_binding_description.binding   = 0;
-    vertex_input_binding_description.stride    = sizeof(Vertex);
+    vertex_input_binding_description.stride    = layout.stride;
     vertex_input_binding_description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
-    std::array<VkVertexInputAttributeDescription, 1> vertex_input_attributs{};
-    vertex_input_attributs[0].binding  = 0;
-    vertex_input_attributs[0].location = 0;
-    vertex_input_attributs[0].format   = VK_FORMAT_R32G32B32_SFLOAT;
-    vertex_input_attributs[0].offset   = offsetof(Vertex, position);
+    std::array<VkVertexInputAttributeDescription, static_cast<size_t>(VertexAttribute::COUNT)> vertex_input_attributs{};
+    uint32_t                                                                                   vertex_input_attributs_count = 0;
+
+    for (size_t i = 0; i < layout.attributes.size(); i++) {
+        const VertexAttributeLayout& attribute = layout.attributes[i];
+        if (!attribute.enabled) continue;
+
+        VkVertexInputAttributeDescription& description = vertex_input_attributs[vertex_input_attributs_count++];
+        description.binding  = 0;
+        description.location = static_cast<uint32_t>(i);
+        description.format   = toVkFormat(attribute.format);
+        description.offset   = attribute.offset;
+    }
 
     VkPipelineVertexInputStateCreateInfo vertex_input_state_create_info{};
     vertex_input_state_create_info.sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertex_input_state_create_info.vertexBindingDescriptionCount   = 1;
     vertex_input_state_create_info.pVertexBindingDescriptions      = &vertex_input_binding_description;
-    vertex_input_state_create_info.vertexAttributeDescriptionCount = vertex_input_attributs.size();
+    vertex_input_state_create_info.vertexAttributeDescriptionCount = vertex_input_attributs_count;
     vertex_input_state_create_info.pVertexAttributeDescriptions    = vertex_input_attributs.data();
 
-    std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages_create_info{};
-
-    // vertex shader
-    fe::vk::ShaderModule vertex_shader_module = this->createShaderModule(PATH.getDefaultShadersPath() / "gLTF" / "shader.vert.spv");
-
-    shader_stages_create_info[0].sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    shader_stages_create_info[0].stage  = VK_SHADER_STAGE_VERTEX_BIT;
-    shader_stages_create_info[0].module = vertex_shader_module;
-    shader_stages_create_info[0].pName  = "main";
+    SpecializationData vertex_specialization{};
+    SpecializationData fragment_specialization{};
+    fillSpecialization(vertex_specialization, m_VertexSpecializationConstants, material);
+    fillSpecialization(fragment_specialization, m_FragmentSpecializationConstants, material);
 
-    assert(shader_stages_create_info[0].module != VK_NULL_HANDLE);
-
-    // fragment shader
-    fe::vk::ShaderModule fragment_shader_module = this->createShaderModule(PATH.getDefaultShadersPath() / "gLTF" / "shader.frag.spv");
+    std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages_create_info{};
 
-    shader_stages_create_info[1].sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    shader_stages_create_info[1].stage  = VK_SHADER_STAGE_FRAGMENT_BIT;
-    shader_stages_create_info[1].module = fragment_shader_module;
-    shader_stages_create_info[1].pName  = "main";
+    shader_stages_create_info[0].sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shader_stages_create_info[0].stage               = VK_SHADER_STAGE_VERTEX_BIT;
+    shader_stages_create_info[0].module              = m_VertexShaderModule;
+    shader_stages_create_info[0].pName               = "main";
+    shader_stages_create_info[0].pSpecializationInfo = vertex_specialization.entries.empty() ? nullptr : &vertex_specialization.info;
 
-    assert(shader_stages_create_info[1].module != VK_NULL_HANDLE);
+    shader_stages_create_info[1].sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shader_stages_create_info[1].stage               = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shader_stages_create_info[1].module              = m_FragmentShaderModule;
+    shader_stages_create_info[1].pName               = "main";
+    shader_stages_create_info[1].pSpecializationInfo = fragment_specialization.entries.empty() ? nullptr : &fragment_specialization.info;
 
     graphics_pipeline_create_info.stageCount = static_cast<uint32_t>(shader_stages_create_info.size());
     graphics_pipeline_create_info.pStages    = shader_stages_create_info.data();
@@ -674,7 +942,10 @@ void fe::RendererVulkan::InitializePipeline() {
 
     VkPipeline pipeline_raw{};
     VK_CHECK_RESULT(vkCreateGraphicsPipelines(m_Device, m_PipelineCache, 1, &graphics_pipeline_create_info, nullptr, &pipeline_raw));
-    m_Pipeline.attach(m_Device, pipeline_raw); // pipeline
+
+    fe::vk::Pipeline pipeline{};
+    pipeline.attach(m_Device, pipeline_raw);
+    return pipeline;
 }
 
 void fe::RendererVulkan::VKCreateInstance() {
@@ -1191,6 +1462,26 @@ fe::vk::ShaderModule fe::RendererVulkan::createShaderModule(const std::filesyste
     return fe::vk::ShaderModule{ m_Device, VK_NULL_HANDLE };
 }
 
+fe::vk::ShaderModule fe::RendererVulkan::createShaderModule(const resource::Shader& shader) {
+    if (shader.source_code.empty()) {
+        fe::logging::error("Failed to create a shader module. The shader has no SPIR-V");
+        return fe::vk::ShaderModule{ m_Device, VK_NULL_HANDLE };
+    }
+
+    VkShaderModuleCreateInfo shader_module_create_info{};
+    shader_module_create_info.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    shader_module_create_info.codeSize = shader.source_code.size() * sizeof(uint32_t);
+    shader_module_create_info.pCode    = shader.source_code.data();
+
+    fe::vk::ShaderModule shader_module{};
+
+    VkShaderModule shader_module_raw{};
+    VK_CHECK_RESULT(vkCreateShaderModule(m_Device, &shader_module_create_info, nullptr, &shader_module_raw));
+    shader_module.attach(m_Device, shader_module_raw);
+
+    return shader_module;
+}
+
 VKAPI_ATTR VkBool32 VKAPI_CALL fe::RendererVulkan::debugUtilsMessageCallback(VkDebugUtilsMessageSeverityFlagBitsEXT      message_severity,
                                                                              VkDebugUtilsMessageTypeFlagsEXT             message_type,
                                                                              const VkDebugUtilsMessengerCallbackDataEXT* callback_data,
@@ -1225,7 +1516,7 @@ VKAPI_ATTR VkBool32 VKAPI_CALL fe::RendererVulkan::debugUtilsMessageCallback(VkD
     return VK_FALSE;
 }
 
-void fe::RendererVulkan::DrawPrimitive(const VulkanVertexBuffer& vertex_buffer, const VulkanIndexBuffer& index_buffer, uint32_t index_offset, uint32_t index_count) {
+void fe::RendererVulkan::DrawPrimitive(const VulkanVertexBuffer& vertex_buffer, const VulkanIndexBuffer& index_buffer, std::span<const IndexRange> ranges) {
     const VkCommandBuffer command_buffer = m_CommandBuffers[m_CurrentFrame];
 
     VkDeviceSize offsets[1]{ 0 };
@@ -1234,10 +1525,10 @@ void fe::RendererVulkan::DrawPrimitive(const VulkanVertexBuffer& vertex_buffer,
     vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer_raw, offsets);
 
     VkBuffer index_buffer_raw = index_buffer.buffer;
-    vkCmdBindIndexBuffer(command_buffer, index_buffer_raw, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdBindIndexBuffer(command_buffer, index_buffer_raw, 0, index_buffer.type);
 
     uint32_t constants = m_MeshIndex;
     vkCmdPushConstants(command_buffer, m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(uint32_t), &constants);
 
-    vkCmdDrawIndexed(command_buffer, index_count, 1, index_offset, 0, 0);
+    for (const IndexRange& range : ranges) vkCmdDrawIndexed(command_buffer, range.index_count, 1, range.index_offset, 0, 0);
 }
@@ -12,6 +12,7 @@
 
 #pragma once
 #include <array>
+#include <unordered_map>
 #include "Graphics/IRenderer.hpp"
 
 #define VK_NO_PROTOTYPES
@@ -21,6 +22,7 @@
 #include "Volk/volk.h"
 
 #include "Graphics/GPUTypes.hpp"
+#include "Graphics/VertexFormat.hpp"
 #include "VulkanRAII.hpp"
 
 #include "VulkanContext.hpp"
@@ -29,6 +31,8 @@
 #include "VulkanTypes.hpp"
 
 #include "Graphics/Camera.hpp"
+#include "Graphics/LevelOfDetail.hpp"
+#include "Graphics/ClusterCulling.hpp"
 #include "VulkanResourceManager.hpp"
 
 namespace fe {
@@ -43,6 +47,8 @@ namespace fe {
         void Draw(DrawMeshCommand command) override;
         void EndFrame() override;
 
+        fe::Arena& GetFrameArena() override { return m_FrameArena.get(); }
+
         void InitializeGPUResources() override;
 
     private: // Vulkan initialization queue
@@ -111,7 +117,9 @@ namespace fe {
         // Create Vulkan pipeline
         // - setup pipeline layout
         // - create pipeline
-        void InitializePipeline();
+        // the shaders are the default glTF .spv files, unless the shader resources are given ( hot reload )
+        // pipelines are made for every vertex format later, see bindPipeline()
+        void InitializePipeline(const resource::Shader* vertex_shader = nullptr, const resource::Shader* fragment_shader = nullptr);
 
     private: // Vulkan step-by-step initialization functions
         void VKCreateInstance();
@@ -131,6 +139,7 @@ namespace fe {
         // get queue family infos for logical device creation and setup m_Context.queue_family_indices
         std::vector<VkDeviceQueueCreateInfo> getQueueFamilyInfos(bool use_swapchain = true, VkQueueFlags requested_queue_types = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
         fe::vk::ShaderModule                 createShaderModule(const std::filesystem::path& path);
+        fe::vk::ShaderModule                 createShaderModule(const resource::Shader& shader);
 
     private: // static functions
         static VKAPI_ATTR VkBool32 VKAPI_CALL debugUtilsMessageCallback(VkDebugUtilsMessageSeverityFlagBitsEXT      message_severity,
@@ -139,11 +148,19 @@ namespace fe {
                                                                         void*                                       user_data);
 
     private:
-        void DrawPrimitive(const VulkanVertexBuffer& vertex_buffer, const VulkanIndexBuffer& index_buffer, uint32_t index_offset, uint32_t index_count);
+        // the vertex input state depends on the attributes of the mesh and the specialization info on the material.
+        // a pipeline is made the first time they are drawn together
+        void             bindPipeline(const VertexFormat& vertex_format, const resource::Material& material);
+        fe::vk::Pipeline createPipeline(const VertexFormat& vertex_format, const resource::Material& material);
+
+        void DrawPrimitive(const VulkanVertexBuffer& vertex_buffer, const VulkanIndexBuffer& index_buffer, std::span<const IndexRange> ranges);
 
     private: // Others
         void configureCamera();
         void resizeWindow();
+        void uploadPendingResources(); // creates GPU resources of asynchronously imported resources
+        void updateResidency();        // frees GPU objects of resources that weren't used for long, when a budget is exceeded
+        size_t queryMemoryBudget();    // what the engine may still use of the device local heaps. 0 if it's unknown
         void increaseMeshIndex() noexcept { m_MeshIndex++; }
         void resetMeshIndex() noexcept { m_MeshIndex = 0; }
 
@@ -175,6 +192,8 @@ namespace fe {
         std::array<fe::vk::Semaphore, VulkanContext::max_concurrent_frames> m_PresentCompleteSemaphores{};
         std::vector<fe::vk::Semaphore>                                      m_RenderCompleteSemaphores{};
 
+        fe::FrameArena<VulkanContext::max_concurrent_frames> m_FrameArena{}; // reset when the frame's fence signals
+
         VulkanImage m_DepthStencil{};
 
         fe::vk::RenderPass m_RenderPass{};
@@ -189,10 +208,21 @@ namespace fe {
         fe::vk::DescriptorSetLayout m_DescriptorSetLayout{};
 
         fe::vk::PipelineLayout m_PipelineLayout{};
-        fe::vk::Pipeline       m_Pipeline{};
+        fe::vk::ShaderModule   m_VertexShaderModule{};
+        fe::vk::ShaderModule   m_FragmentShaderModule{};
+
+        // reflected from the shader resources, the default .spv files have none
+        std::unordered_map<std::string, resource::Shader::SpecializationConstant> m_VertexSpecializationConstants{};
+        std::unordered_map<std::string, resource::Shader::SpecializationConstant> m_FragmentSpecializationConstants{};
+
+        std::unordered_map<uint64_t, fe::vk::Pipeline> m_Pipelines{};     // by VertexFormat::key() and the specialization values
+        VkPipeline                                     m_BoundPipeline{}; // in the command buffer of the current frame
 
         Camera m_Camera{}; // temp
 
+        LodSelector   m_LodSelector{};
+        ClusterCuller m_ClusterCuller{};
+
         bool m_IsWindowResized{}; // temp
 
         uint32_t m_CurrentFrame{};
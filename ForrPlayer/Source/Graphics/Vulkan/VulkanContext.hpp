@@ -55,6 +55,8 @@ namespace fe {
 
         std::vector<VkLayerSettingEXT> enabled_layer_settings{};
 
+        bool memory_budget_supported{}; // VK_EXT_memory_budget is enabled
+
         void* physical_device_create_next_chain{}; // TODO : this is unused for now. Add adding extra features in the future
 
         std::vector<VkQueueFamilyProperties> queue_family_properties{};
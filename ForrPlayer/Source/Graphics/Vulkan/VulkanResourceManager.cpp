@@ -14,9 +14,69 @@
 #include "VulkanResourceManager.hpp"
 
 #include "Graphics/Vulkan/VKTools.hpp"
+#include "ResourceManagement/TextureLayout.hpp"
 
 using namespace fe::resource;
 
+namespace fe {
+    // RGB8 has almost no optimal tiling support, it's expanded to RGBA8 while it's copied to the staging buffer
+    static VkFormat toVkFormat(Texture::InternalFormat format) {
+        // clang-format off
+        switch (format) {
+            case Texture::InternalFormat::RGBA8         : return VK_FORMAT_R8G8B8A8_UNORM;
+            case Texture::InternalFormat::RGB8          : return VK_FORMAT_R8G8B8A8_UNORM;
+            case Texture::InternalFormat::RG8           : return VK_FORMAT_R8G8_UNORM;
+            case Texture::InternalFormat::R8            : return VK_FORMAT_R8_UNORM;
+            case Texture::InternalFormat::SRGB8_ALPHA8  : return VK_FORMAT_R8G8B8A8_SRGB;
+            case Texture::InternalFormat::SRGB8         : return VK_FORMAT_R8G8B8A8_SRGB;
+            case Texture::InternalFormat::BC1_RGB       : return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            case Texture::InternalFormat::BC1_SRGB      : return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+            case Texture::InternalFormat::BC3_RGBA      : return VK_FORMAT_BC3_UNORM_BLOCK;
+            case Texture::InternalFormat::BC3_SRGB_ALPHA: return VK_FORMAT_BC3_SRGB_BLOCK;
+            case Texture::InternalFormat::BC4_RED       : return VK_FORMAT_BC4_UNORM_BLOCK;
+            case Texture::InternalFormat::BC5_RG        : return VK_FORMAT_BC5_UNORM_BLOCK;
+            case Texture::InternalFormat::BC7_RGBA      : return VK_FORMAT_BC7_UNORM_BLOCK;
+            case Texture::InternalFormat::BC7_SRGB_ALPHA: return VK_FORMAT_BC7_SRGB_BLOCK;
+            default:
+                fe::logging::warning("Unified -> Vulkan. Unsupported internal format %i. Using VK_FORMAT_R8G8B8A8_UNORM as default", format);
+                return VK_FORMAT_R8G8B8A8_UNORM;
+        }
+        // clang-format on
+    }
+
+    static VkSamplerAddressMode toVkAddressMode(Texture::Wrap wrap) {
+        // clang-format off
+        switch (wrap) {
+            case Texture::Wrap::CLAMP_TO_EDGE  : return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            case Texture::Wrap::MIRRORED_REPEAT: return VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+            default                            : return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        }
+        // clang-format on
+    }
+
+    static void transitionImageLayout(VkCommandBuffer command_buffer, VkImage image, uint32_t mip_count, VkImageLayout old_layout, VkImageLayout new_layout,
+                                      VkAccessFlags src_access, VkAccessFlags dst_access, VkPipelineStageFlags src_stage, VkPipelineStageFlags dst_stage) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask       = src_access;
+        barrier.dstAccessMask       = dst_access;
+        barrier.oldLayout           = old_layout;
+        barrier.newLayout           = new_layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image               = image;
+        barrier.subresourceRange    = {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel   = 0,
+            .levelCount     = mip_count,
+            .baseArrayLayer = 0,
+            .layerCount     = 1,
+        };
+
+        vkCmdPipelineBarrier(command_buffer, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+} // namespace fe
+
 template <>
 void fe::VulkanResourceManager::CreateResource(Material& material) {
     
@@ -28,6 +88,8 @@ template void fe::VulkanResourceManager::CreateResource(Material& material);
 template <>
 void fe::VulkanResourceManager::CreateResource(Model& model) {
     for (auto& mesh : model.meshes) {
+        if (mesh.gpu_handle.is_valid()) continue; // already on the GPU
+
         this->createMesh(mesh);
     }
 }
@@ -35,14 +97,261 @@ template void fe::VulkanResourceManager::CreateResource(Model& model);
 
 ///
 
+// the mip chain is copied as it is, block compressed levels too. textures made in code only have the top mip,
+// there is no blit to make the rest on Vulkan
 template <>
 void fe::VulkanResourceManager::CreateResource(Texture& texture) {
-    
+    if (!texture.bytes) return; // evicted, it's uploaded again after the restore
+
+    if (is_block_compressed(texture.internal_format) && !m_Context.enabled_physical_device_features.textureCompressionBC) {
+        fe::logging::error("Vulkan. The device doesn't support BC textures. The texture isn't uploaded");
+        return;
+    }
+
+    VulkanTexture vulkan_texture{};
+    vulkan_texture.mip_count = texture.mip_count;
+
+    constexpr static VkDeviceSize     offset = 0;
+    constexpr static VkMemoryMapFlags flags  = 0;
+
+    const VkFormat format = toVkFormat(texture.internal_format);
+    const bool     expand = texture.internal_format == Texture::InternalFormat::RGB8 || texture.internal_format == Texture::InternalFormat::SRGB8;
+
+    // levels of an expanded chain are 4/3 of the source
+    auto staging_level = [&](uint32_t level) {
+        return expand ? mip_level(texture.width, texture.height, 4u, level) : texture_mip_level(texture, level);
+    };
+
+    MipLevel last_level   = staging_level(texture.mip_count - 1);
+    size_t   staging_size = last_level.offset + last_level.size;
+
+    /// staging buffer
+
+    VkDeviceMemory staging_memory{};
+    VkBuffer       staging_buffer{};
+
+    VkBufferCreateInfo buffer_create_info{};
+    buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_create_info.size  = staging_size;
+    buffer_create_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+    VK_CHECK_RESULT(vkCreateBuffer(m_Context.device, &buffer_create_info, nullptr, &staging_buffer));
+
+    VkMemoryRequirements memory_requirements{};
+    vkGetBufferMemoryRequirements(m_Context.device, staging_buffer, &memory_requirements);
+
+    VkMemoryAllocateInfo memory_allocate_info{};
+    memory_allocate_info.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memory_allocate_info.allocationSize  = memory_requirements.size;
+    memory_allocate_info.memoryTypeIndex = fe::getMemoryTypeIndex(m_Context, memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    VK_CHECK_RESULT(vkAllocateMemory(m_Context.device, &memory_allocate_info, nullptr, &staging_memory));
+
+    void* data{};
+    VK_CHECK_RESULT(vkMapMemory(m_Context.device, staging_memory, offset, memory_allocate_info.allocationSize, flags, &data));
+
+    if (expand) {
+        const size_t texel_count = staging_size / 4;
+
+        const unsigned char* source      = texture.bytes.get();
+        unsigned char*       destination = static_cast<unsigned char*>(data);
+
+        for (size_t i = 0; i < texel_count; i++) {
+            destination[i * 4 + 0] = source[i * 3 + 0];
+            destination[i * 4 + 1] = source[i * 3 + 1];
+            destination[i * 4 + 2] = source[i * 3 + 2];
+            destination[i * 4 + 3] = 255;
+        }
+    }
+    else {
+        memcpy(data, texture.bytes.get(), staging_size);
+    }
+
+    vkUnmapMemory(m_Context.device, staging_memory);
+
+    VK_CHECK_RESULT(vkBindBufferMemory(m_Context.device, staging_buffer, staging_memory, offset));
+
+    /// image
+
+    VkImageCreateInfo image_create_info{};
+    image_create_info.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_create_info.imageType     = VK_IMAGE_TYPE_2D;
+    image_create_info.format        = format;
+    image_create_info.extent        = { texture.width, texture.height, 1 };
+    image_create_info.mipLevels     = texture.mip_count;
+    image_create_info.arrayLayers   = 1;
+    image_create_info.samples       = VK_SAMPLE_COUNT_1_BIT;
+    image_create_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
+    image_create_info.usage         = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    image_create_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+    image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    VkImage image_raw{};
+    VK_CHECK_RESULT(vkCreateImage(m_Context.device, &image_create_info, nullptr, &image_raw));
+    vulkan_texture.image.image.attach(m_Context.device, image_raw);
+
+    vkGetImageMemoryRequirements(m_Context.device, image_raw, &memory_requirements);
+
+    // reusing memory allocate info
+    memory_allocate_info.allocationSize  = memory_requirements.size;
+    memory_allocate_info.memoryTypeIndex = fe::getMemoryTypeIndex(m_Context, memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    VkDeviceMemory image_memory_raw{};
+    VK_CHECK_RESULT(vkAllocateMemory(m_Context.device, &memory_allocate_info, nullptr, &image_memory_raw));
+    vulkan_texture.image.memory.attach(m_Context.device, image_memory_raw);
+
+    VK_CHECK_RESULT(vkBindImageMemory(m_Context.device, image_raw, image_memory_raw, offset));
+
+    /// submit
+
+    // there is no RAII because it is going to be freed by freeing m_CommandPool
+    VkCommandBuffer copy_command_buffer{};
+
+    VkCommandBufferAllocateInfo command_buffer_allocate_info{};
+    command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    command_buffer_allocate_info.commandPool        = m_Context.command_pool;
+    command_buffer_allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    command_buffer_allocate_info.commandBufferCount = 1;
+    VK_CHECK_RESULT(vkAllocateCommandBuffers(m_Context.device, &command_buffer_allocate_info, &copy_command_buffer));
+
+    VkCommandBufferBeginInfo command_buffer_begin_info{};
+    command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    VK_CHECK_RESULT(vkBeginCommandBuffer(copy_command_buffer, &command_buffer_begin_info));
+
+    transitionImageLayout(copy_command_buffer, image_raw, texture.mip_count, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    std::vector<VkBufferImageCopy> copy_regions(texture.mip_count);
+    for (uint32_t level = 0; level < texture.mip_count; level++) {
+        MipLevel mip = staging_level(level);
+
+        VkBufferImageCopy& copy_region              = copy_regions[level];
+        copy_region.bufferOffset                    = mip.offset;
+        copy_region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        copy_region.imageSubresource.mipLevel       = level;
+        copy_region.imageSubresource.baseArrayLayer = 0;
+        copy_region.imageSubresource.layerCount     = 1;
+        copy_region.imageExtent                     = { mip.width, mip.height, 1 };
+    }
+
+    vkCmdCopyBufferToImage(copy_command_buffer, staging_buffer, image_raw, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copy_regions.size()), copy_regions.data());
+
+    transitionImageLayout(copy_command_buffer, image_raw, texture.mip_count, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                          VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+    VK_CHECK_RESULT(vkEndCommandBuffer(copy_command_buffer));
+
+    VkSubmitInfo submit_info{};
+    submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers    = &copy_command_buffer;
+
+    VkFenceCreateInfo fence_create_info{};
+    fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fence_create_info.flags = 0;
+
+    fe::vk::Fence fence{}; // for RAII
+
+    VkFence fence_raw{};
+    VK_CHECK_RESULT(vkCreateFence(m_Context.device, &fence_create_info, nullptr, &fence_raw));
+    fence.attach(m_Context.device, fence_raw);
+
+    // the layout transitions need the fragment shader stage, so it's the graphics queue, not the transfer one
+    VK_CHECK_RESULT(vkQueueSubmit(m_Context.queue_graphics, 1, &submit_info, fence_raw));
+    VK_CHECK_RESULT(vkWaitForFences(m_Context.device, 1, &fence_raw, VK_TRUE, m_Context.default_fence_timeout));
+
+    vkFreeCommandBuffers(m_Context.device, m_Context.command_pool, 1, &copy_command_buffer);
+
+    vkDestroyBuffer(m_Context.device, staging_buffer, nullptr);
+    vkFreeMemory(m_Context.device, staging_memory, nullptr);
+
+    /// image view
+
+    VkImageViewCreateInfo image_view_create_info{};
+    image_view_create_info.sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    image_view_create_info.image            = image_raw;
+    image_view_create_info.viewType         = VK_IMAGE_VIEW_TYPE_2D;
+    image_view_create_info.format           = format;
+    image_view_create_info.subresourceRange = {
+        .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel   = 0,
+        .levelCount     = texture.mip_count,
+        .baseArrayLayer = 0,
+        .layerCount     = 1,
+    };
+
+    VkImageView image_view_raw{};
+    VK_CHECK_RESULT(vkCreateImageView(m_Context.device, &image_view_create_info, nullptr, &image_view_raw));
+    vulkan_texture.image.image_view.attach(m_Context.device, image_view_raw);
+
+    /// sampler
+
+    using MinFilter = Texture::MinFilter;
+
+    bool linear_min    = texture.min_filter == MinFilter::LINEAR || texture.min_filter == MinFilter::LINEAR_MIPMAP_NEAREST || texture.min_filter == MinFilter::LINEAR_MIPMAP_LINEAR;
+    bool linear_mipmap = texture.min_filter == MinFilter::NEAREST_MIPMAP_LINEAR || texture.min_filter == MinFilter::LINEAR_MIPMAP_LINEAR;
+    bool mipmapped     = texture.min_filter != MinFilter::NEAREST && texture.min_filter != MinFilter::LINEAR;
+
+    VkSamplerCreateInfo sampler_create_info{};
+    sampler_create_info.sType        = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_create_info.magFilter    = texture.mag_filter == Texture::MagFilter::LINEAR ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+    sampler_create_info.minFilter    = linear_min ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+    sampler_create_info.mipmapMode   = linear_mipmap ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler_create_info.addressModeU = toVkAddressMode(texture.wrap_s);
+    sampler_create_info.addressModeV = toVkAddressMode(texture.wrap_t);
+    sampler_create_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_create_info.minLod       = 0.0f;
+    sampler_create_info.maxLod       = mipmapped ? static_cast<float>(texture.mip_count - 1) : 0.0f;
+    sampler_create_info.borderColor  = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+
+    VkSampler sampler_raw{};
+    VK_CHECK_RESULT(vkCreateSampler(m_Context.device, &sampler_create_info, nullptr, &sampler_raw));
+    vulkan_texture.sampler.attach(m_Context.device, sampler_raw);
+
+    this->storeResource(texture.gpu_handle, vulkan_texture, m_StorageTextures, &m_FreeTextures);
 }
 template void fe::VulkanResourceManager::CreateResource(Texture& texture);
 
 ///
 
+template <>
+void fe::VulkanResourceManager::UpdateResource(Material& material) {
+    this->CreateResource(material);
+}
+template void fe::VulkanResourceManager::UpdateResource(Material& material);
+
+// the GPU must not use the old buffers anymore
+template <>
+void fe::VulkanResourceManager::UpdateResource(Model& model) {
+    for (auto& mesh : model.meshes) {
+        this->createMesh(mesh); // the old buffers are destroyed when the slot is replaced
+    }
+}
+template void fe::VulkanResourceManager::UpdateResource(Model& model);
+
+template <>
+void fe::VulkanResourceManager::UpdateResource(Texture& texture) {
+    this->CreateResource(texture);
+}
+template void fe::VulkanResourceManager::UpdateResource(Texture& texture);
+
+///
+
+template <>
+void fe::VulkanResourceManager::DestroyResource(Model& model) {
+    for (auto& mesh : model.meshes) this->releaseResource(mesh.gpu_handle, m_StorageMeshes, m_FreeMeshes);
+}
+template void fe::VulkanResourceManager::DestroyResource(Model& model);
+
+template <>
+void fe::VulkanResourceManager::DestroyResource(Texture& texture) {
+    this->releaseResource(texture.gpu_handle, m_StorageTextures, m_FreeTextures);
+}
+template void fe::VulkanResourceManager::DestroyResource(Texture& texture);
+
+///
+
 //template<>
 //const fe::VulkanMaterial& fe::VulkanResourceManager::GetResource(GPUHandle<resource::Material> handle) const {
 //    return m_StorageMaterials[handle.index];
@@ -61,6 +370,12 @@ const fe::VulkanMesh& fe::VulkanResourceManager::GetResource(GPUHandle<resource:
 }
 template const fe::VulkanMesh& fe::VulkanResourceManager::GetResource(GPUHandle<resource::Model::Mesh> handle)const;
 
+template<>
+const fe::VulkanTexture& fe::VulkanResourceManager::GetResource(GPUHandle<resource::Texture> handle) const {
+    return m_StorageTextures[handle.index];
+}
+template const fe::VulkanTexture& fe::VulkanResourceManager::GetResource(GPUHandle<resource::Texture> handle)const;
+
 
 ///
 
@@ -84,7 +399,10 @@ fe::GPUHandle<Model::Mesh> fe::VulkanResourceManager::createMesh(resource::Model
 
     /// vertex buffer
 
-    size_t vertex_buffer_size = mesh.vertices.size() * sizeof(Vertex);
+    // only the attributes of the mesh, see RendererVulkan::createPipeline()
+    const VertexLayout layout = vertex_layout(mesh.vertex_format);
+
+    size_t vertex_buffer_size = mesh.vertices.size() * layout.stride;
 
     VkBufferCreateInfo vertex_buffer_create_info{};
     vertex_buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -104,7 +422,7 @@ fe::GPUHandle<Model::Mesh> fe::VulkanResourceManager::createMesh(resource::Model
     VK_CHECK_RESULT(vkAllocateMemory(m_Context.device, &memory_allocate_info, nullptr, &staging_buffers.vertices.memory));
 
     VK_CHECK_RESULT(vkMapMemory(m_Context.device, staging_buffers.vertices.memory, offset, memory_allocate_info.allocationSize, flags, &data));
-    memcpy(data, mesh.vertices.data(), vertex_buffer_size);
+    pack_vertices(mesh.vertices.data(), mesh.vertices.size(), layout, data);
     vkUnmapMemory(m_Context.device, staging_buffers.vertices.memory);
 
     VK_CHECK_RESULT(vkBindBufferMemory(m_Context.device, staging_buffers.vertices.buffer, staging_buffers.vertices.memory, offset));
@@ -132,8 +450,12 @@ fe::GPUHandle<Model::Mesh> fe::VulkanResourceManager::createMesh(resource::Model
 
     /// index buffer
 
+    // 16-bit indices are narrowed while writing to the staging buffer, the mesh keeps fe::Index. importers don't make 8-bit ones
+    const RenderIndexType index_type = mesh.index_type == RenderIndexType::UNSIGNED_SHORT ? RenderIndexType::UNSIGNED_SHORT : RenderIndexType::UNSIGNED_INT;
+
     vulkan_mesh.index_buffer.count = mesh.indices.size();
-    size_t index_buffer_size       = vulkan_mesh.index_buffer.count * sizeof(uint32_t);
+    vulkan_mesh.index_buffer.type  = index_type == RenderIndexType::UNSIGNED_SHORT ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    size_t index_buffer_size       = vulkan_mesh.index_buffer.count * index_size(index_type);
 
     VkBufferCreateInfo index_buffer_create_info{};
     index_buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -151,7 +473,7 @@ fe::GPUHandle<Model::Mesh> fe::VulkanResourceManager::createMesh(resource::Model
     VK_CHECK_RESULT(vkAllocateMemory(m_Context.device, &memory_allocate_info, nullptr, &staging_buffers.indices.memory));
     VK_CHECK_RESULT(vkMapMemory(m_Context.device, staging_buffers.indices.memory, offset, index_buffer_size, flags, &data));
 
-    memcpy(data, mesh.indices.data(), index_buffer_size);
+    pack_indices(mesh.indices, index_type, data);
     vkUnmapMemory(m_Context.device, staging_buffers.indices.memory);
     VK_CHECK_RESULT(vkBindBufferMemory(m_Context.device, staging_buffers.indices.buffer, staging_buffers.indices.memory, offset));
 
@@ -238,7 +560,7 @@ fe::GPUHandle<Model::Mesh> fe::VulkanResourceManager::createMesh(resource::Model
         vulkan_primitive.material_ptr = primitive.material_ptr;
     }
 
-    return GPUHandle<Model::Mesh>(this->storeResource(mesh.gpu_handle, vulkan_mesh, m_StorageMeshes));
+    return GPUHandle<Model::Mesh>(this->storeResource(mesh.gpu_handle, vulkan_mesh, m_StorageMeshes, &m_FreeMeshes));
 }
 
 //fe::GPUHandle<fe::VulkanShaderProgram> fe::VulkanResourceManager::createShaderProgram(VulkanMaterial& Vulkan_material, std::vector<resource::Shader*> shaders) {
@@ -45,6 +45,7 @@ namespace fe {
         fe::vk::DeviceMemory memory{};
         fe::vk::Buffer       buffer{};
         size_t               count{};
+        VkIndexType          type{ VK_INDEX_TYPE_UINT32 };
 
         VulkanIndexBuffer()  = default;
         ~VulkanIndexBuffer() = default;
@@ -82,7 +83,10 @@ namespace fe {
         FORR_CLASS_MOVABLE(VulkanStorageBuffer)
     };
 
-    struct VulkanTexture { // TODO : provide textures
+    struct VulkanTexture {
+        VulkanImage     image{};
+        fe::vk::Sampler sampler{};
+        uint32_t        mip_count{};
 
         VulkanTexture()  = default;
         ~VulkanTexture() = default;
@@ -124,4 +128,5 @@ namespace fe {
     };
 
     VULKAN_RESOURCE_TRAITS_INSTANCE(resource::Model::Mesh, VulkanMesh)
+    VULKAN_RESOURCE_TRAITS_INSTANCE(resource::Texture, VulkanTexture)
 } // namespace fe
@@ -12,17 +12,34 @@
 
 #include "pch.hpp"
 #include "GLTFImporter.hpp"
+#include "TextureImporter.hpp"
+#include "ModelImporter.hpp"
+
+#include <limits>
+
+#include "Core/derived_data_cache.hpp"
+#include "Core/job_system.hpp"
+#include "Graphics/MeshOptimization.hpp"
 
 #include "MikkTSpace.hpp"
 
 fe::pointer<fe::resource::Model> fe::GLTFImporter::Import(ResourceStorage& storage, const std::filesystem::path& resource_full_path) {
-    tinygltf::Model    model{};
+    GLTFImportResult result{};
+    if (!GLTFImporter::Load(resource_full_path, result, storage.GetContext().texture_quality_tier, storage.GetContext().vertex_attributes,
+                            storage.GetContext().lod_settings)) return {};
+
+    return GLTFImporter::Publish(storage, result);
+}
+
+bool fe::GLTFImporter::parseFile(const std::filesystem::path& resource_full_path, tinygltf::Model& model, uint64_t& cache_key) {
     tinygltf::TinyGLTF loader{};
     std::string        error{};
     std::string        warning{};
     std::string        filename = resource_full_path.string();
     bool               good     = false;
 
+    loader.SetImageLoader(&GLTFImporter::keepEncodedImage, nullptr); // images are decoded later and only if their textures aren't cached
+
     if (resource_full_path.extension() == ".gltf") {
         good = loader.LoadASCIIFromFile(&model, &error, &warning, filename);
     }
@@ -31,7 +48,7 @@ fe::pointer<fe::resource::Model> fe::GLTFImporter::Import(ResourceStorage& stora
     }
     else {
         fe::logging::error("Failed to load GLTF model.\nWrong resource extension. It's not .gltf or .glb\nPath : %s", filename.c_str());
-        return {};
+        return false;
     }
 
     if (!warning.empty()) {
@@ -39,26 +56,148 @@ fe::pointer<fe::resource::Model> fe::GLTFImporter::Import(ResourceStorage& stora
     }
     if (!error.empty()) {
         fe::logging::error("Failed to load GLTF model.\nGot an error : %s", error.c_str());
-        return {};
+        return false;
     }
     if (!good) {
         fe::logging::error("Failed to load GLTF model.\n\"good\" value is false : %s", error.c_str());
-        return {};
+        return false;
+    }
+
+    // the key covers the file, external buffers and encoded external images. embedded ones are in the file already
+    if (!hash_file(resource_full_path, cache_key, derived_data_key("GLTFImporter", GLTFImporter::VERSION))) {
+        fe::logging::error("File -> Unified. Failed to read GLTF model\nPath : %s", filename.c_str());
+        return false;
+    }
+
+    auto is_external = [](const std::string& uri) { return !uri.empty() && uri.rfind("data:", 0) != 0; };
+
+    for (const auto& buffer : model.buffers) {
+        if (is_external(buffer.uri)) cache_key = hash_bytes(buffer.data.data(), buffer.data.size(), cache_key);
+    }
+    for (const auto& image : model.images) {
+        if (is_external(image.uri)) cache_key = hash_bytes(image.image.data(), image.image.size(), cache_key);
+    }
+
+    return true;
+}
+
+bool fe::GLTFImporter::Load(const std::filesystem::path& resource_full_path, GLTFImportResult& result, uint32_t texture_dropped_mips, VertexAttributes vertex_attributes,
+                            const LodSettings& lod_settings, bool load_textures) {
+    tinygltf::Model& model = result.source;
+
+    uint64_t cache_key{};
+    if (!GLTFImporter::parseFile(resource_full_path, model, cache_key)) return false;
+
+    std::filesystem::path model_extension = PATH.getModelExtension();
+
+    // levels of detail are in the model, textures don't depend on them
+    const uint64_t model_key = lod_settings.hash(cache_key);
+
+    bool model_cached = false;
+    if (DDC.find(model_key, model_extension)) {
+        model_cached = ModelImporter::Load(ResourceManagementContext{}, DDC.entry_path(model_key, model_extension), result.model);
+
+        if (!model_cached) {
+            DDC.discard(model_key, model_extension);
+            result.model = resource::Model{};
+        }
+    }
+
+    if (!model_cached) {
+        GLTFImportContext context{ model, result.model, nullptr };
+        context.lod_settings = lod_settings;
+
+        GLTFImporter::loadNodes(context);
+        GLTFImporter::loadSceneRoots(context);
+        GLTFImporter::loadSkins(context);
+        GLTFImporter::loadMeshes(context);
+        GLTFImporter::loadAnimations(context);
+
+        // materials aren't in the cached model, Publish() links them from the source every time
+        if (DDC.is_enabled() && ModelImporter::Write(result.model, DDC.entry_path(model_key, model_extension))) {
+            DDC.store(model_key, model_extension);
+        }
     }
 
-    resource::Model this_model{};
+    ModelImporter::KeepVertexAttributes(result.model, vertex_attributes);
+
+    if (load_textures) GLTFImporter::loadTextures(model, cache_key, result.textures, texture_dropped_mips);
+
+    // everything is copied out of them already. the rest of the source is small, URIs are kept for the cooker
+    for (auto& buffer : model.buffers) {
+        buffer.data.clear();
+        buffer.data.shrink_to_fit();
+    }
+    for (auto& image : model.images) {
+        image.image.clear();
+        image.image.shrink_to_fit();
+    }
+
+    return true;
+}
+
+bool fe::GLTFImporter::LoadTexture(const std::filesystem::path& resource_full_path, uint32_t texture_index, resource::Texture& texture, uint32_t texture_dropped_mips) {
+    tinygltf::Model model{};
+    uint64_t        cache_key{};
+    if (!GLTFImporter::parseFile(resource_full_path, model, cache_key)) return false;
+
+    if (texture_index >= model.textures.size()) {
+        fe::logging::error("File -> Unified. GLTF model has no texture %u\nPath : %s", texture_index, resource_full_path.string().c_str());
+        return false;
+    }
+
+    std::vector<resource::Texture> textures{};
+    GLTFImporter::loadTextures(model, cache_key, textures, texture_dropped_mips, static_cast<int>(texture_index));
+
+    if (!textures[texture_index].bytes) return false; // loadTextures() has already reported why
+
+    texture = std::move(textures[texture_index]);
+    return true;
+}
+
+fe::pointer<fe::resource::Model> fe::GLTFImporter::Publish(ResourceStorage& storage, GLTFImportResult& result, std::vector<fe::pointer<resource::Texture>>* textures) {
+    GLTFImportContext context{ result.source, result.model, &storage };
+
+    const fe::pointer<resource::Texture> fallback_texture_ptr = storage.GetContext().fallback_texture_ptr;
+
+    std::vector<fe::pointer<resource::Texture>> previous_textures{};
+    if (textures) previous_textures.swap(*textures);
+
+    size_t live_textures_count = storage.GetStorage<resource::Texture>().live_count();
+    storage.ReserveResources<resource::Texture>(live_textures_count + result.textures.size());
+
+    context.textures.resize(result.textures.size());
+    for (size_t i = 0; i < result.textures.size(); i++) {
+        resource::Texture& texture = result.textures[i];
+
+        if (!texture.bytes) {
+            context.textures[i] = fallback_texture_ptr;
+            continue;
+        }
+
+        resource::Texture* old_texture = nullptr;
+        if (i < previous_textures.size() && previous_textures[i] != fallback_texture_ptr) old_texture = storage.GetResource(previous_textures[i]);
+
+        if (old_texture) {
+            texture.guid       = old_texture->guid;
+            texture.gpu_handle = old_texture->gpu_handle;
+
+            *old_texture        = std::move(texture);
+            context.textures[i] = previous_textures[i];
+        }
+        else {
+            context.textures[i] = storage.CreateResource<resource::Texture>(std::move(texture));
+        }
+    }
+    result.textures.clear();
 
-    GLTFImportContext context{ model, this_model, storage };
+    if (textures) *textures = context.textures;
+    result.model.textures = context.textures;
 
-    GLTFImporter::loadNodes(context);
-    GLTFImporter::loadSceneRoots(context);
-    GLTFImporter::loadSkins(context);
-    GLTFImporter::loadTextures(context);
     GLTFImporter::loadMaterials(context);
-    GLTFImporter::loadMeshes(context);
-    GLTFImporter::loadAnimations(context);
+    GLTFImporter::linkMaterials(context);
 
-    auto ptr = storage.CreateResource<resource::Model>(std::move(this_model));
+    auto ptr = storage.CreateResource<resource::Model>(std::move(result.model));
     return ptr;
 }
 
@@ -122,6 +261,13 @@ void fe::GLTFImporter::loadSkins(GLTFImportContext& context) {
 
 void fe::GLTFImporter::loadMeshes(GLTFImportContext& context) {
     context.this_model.meshes.resize(context.model.meshes.size());
+
+    // the box of the quantization is known only when every mesh is read
+    std::vector<std::vector<VertexData>> mesh_vertices(context.model.meshes.size());
+
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(std::numeric_limits<float>::lowest());
+
     for (size_t i = 0; i < context.model.meshes.size(); i++) {
         const tinygltf::Mesh& mesh      = context.model.meshes[i];
         auto&                 this_mesh = context.this_model.meshes[i];
@@ -135,14 +281,12 @@ void fe::GLTFImporter::loadMeshes(GLTFImportContext& context) {
 
         this_primitives.resize(primitives.size());
 
-        for (size_t i = 0; i < primitives.size(); i++) {
-            const tinygltf::Primitive& primitive      = primitives[i];
-            auto&                      this_primitive = this_primitives[i];
-
-            this_primitive.material_ptr = context.GetMaterial(i);
+        for (size_t j = 0; j < primitives.size(); j++) {
+            const tinygltf::Primitive& primitive      = primitives[j];
+            auto&                      this_primitive = this_primitives[j];
 
             GLTFImporter::loadIndices(context, this_primitive, this_mesh.indices, primitive); // indices go first
-            GLTFImporter::loadVertices(context, this_mesh.vertices, this_mesh.indices, primitive);
+            GLTFImporter::loadVertices(context, this_primitive, this_mesh.indices, mesh_vertices[i], this_mesh.vertex_format, primitive);
 
             // clang-format off
             switch (primitive.mode) {
@@ -160,15 +304,152 @@ void fe::GLTFImporter::loadMeshes(GLTFImportContext& context) {
         }
 
         this_mesh.weights.insert_range(this_mesh.weights.end(), mesh.weights);
+
+        // levels of detail are simplified relative to the size of the mesh
+        glm::vec3 mesh_min(std::numeric_limits<float>::max());
+        glm::vec3 mesh_max(std::numeric_limits<float>::lowest());
+        for (const VertexData& vertex : mesh_vertices[i]) {
+            mesh_min = glm::min(mesh_min, vertex.position);
+            mesh_max = glm::max(mesh_max, vertex.position);
+        }
+
+        if (mesh_min.x <= mesh_max.x) {
+            this_mesh.bounds.center = (mesh_min + mesh_max) * 0.5f;
+            for (const VertexData& vertex : mesh_vertices[i]) {
+                this_mesh.bounds.radius = std::max(this_mesh.bounds.radius, glm::distance(vertex.position, this_mesh.bounds.center));
+            }
+        }
+
+        GLTFImporter::optimizeMesh(this_mesh, mesh_vertices[i], context.lod_settings);
+
+        // back faces of double-sided materials are seen, their meshlets are never culled by normal cones
+        for (size_t j = 0; j < primitives.size(); j++) {
+            const int material_index = primitives[j].material;
+            if (material_index < 0 || static_cast<size_t>(material_index) >= context.model.materials.size()) continue;
+            if (!context.model.materials[material_index].doubleSided) continue;
+
+            for (uint32_t level = 0; level <= this_primitives[j].lods.size(); level++) {
+                const MeshLod lod = this_primitives[j].lod(level);
+                for (int k = lod.meshlet_offset; k < lod.meshlet_offset + lod.meshlet_count; k++) this_mesh.meshlets[k].cone_cutoff = 1.0f;
+            }
+        }
+
+        bool unorm_texture_coords = true;
+        for (const VertexData& vertex : mesh_vertices[i]) {
+            min = glm::min(min, vertex.position);
+            max = glm::max(max, vertex.position);
+
+            bool in_unit_range = vertex.texture_coord.x >= 0.0f && vertex.texture_coord.x <= 1.0f && vertex.texture_coord.y >= 0.0f && vertex.texture_coord.y <= 1.0f;
+            unorm_texture_coords = unorm_texture_coords && in_unit_range;
+        }
+
+        // unorm16 is more precise than half floats in [0, 1], but tiled UVs need halves
+        this_mesh.vertex_format.unorm_texture_coords = this_mesh.vertex_format.has(VertexAttribute::TEXTURE_COORD) && unorm_texture_coords;
+    }
+
+    if (min.x <= max.x) context.this_model.vertex_quantization = vertex_quantization(min, max);
+
+    for (size_t i = 0; i < context.model.meshes.size(); i++) {
+        auto& this_mesh = context.this_model.meshes[i];
+
+        this_mesh.vertices.resize(mesh_vertices[i].size());
+        for (size_t j = 0; j < mesh_vertices[i].size(); j++) {
+            this_mesh.vertices[j] = encode_vertex(mesh_vertices[i][j], context.this_model.vertex_quantization, this_mesh.vertex_format);
+        }
+
+        this_mesh.index_type = index_type_for(this_mesh.vertices.size());
     }
 }
 
-void fe::GLTFImporter::loadTextures(GLTFImportContext& context) {
-    context.textures.resize(context.model.textures.size());
+// one job per image : its textures are read from DDC, and only if some of them aren't there, the image is decoded once for all of them.
+// a texture without bytes is replaced by the fallback in Publish()
+void fe::GLTFImporter::loadTextures(tinygltf::Model& model, uint64_t cache_key, std::vector<resource::Texture>& this_textures, uint32_t dropped_mips, int texture_index) {
+    this_textures.resize(model.textures.size());
+
+    std::vector<std::vector<uint32_t>> image_textures(model.images.size());
 
-    for (size_t i = 0; i < context.model.textures.size(); i++) {
-        context.textures[i] = createTexture(context.model, i, context.storage);
+    for (size_t i = 0; i < model.textures.size(); i++) {
+        if (texture_index >= 0 && i != static_cast<size_t>(texture_index)) continue;
+
+        int image_index = model.textures[i].source;
+
+        if (image_index < 0 || static_cast<size_t>(image_index) >= model.images.size()) {
+            fe::logging::warning("tinygltf -> Unified. Texture has no image. Image index : %i\nFallback is used", image_index);
+            continue;
+        }
+
+        image_textures[image_index].emplace_back(static_cast<uint32_t>(i));
+    }
+
+    // base color and emissive textures are colors, the others ( normals, metallic-roughness, occlusion ) are data
+    std::vector<resource::Texture::ColorSpace> color_spaces(model.textures.size(), resource::Texture::ColorSpace::LINEAR);
+
+    auto mark_srgb = [&](int index) {
+        if (index >= 0 && static_cast<size_t>(index) < color_spaces.size()) color_spaces[index] = resource::Texture::ColorSpace::SRGB;
+    };
+    for (const tinygltf::Material& material : model.materials) {
+        mark_srgb(material.pbrMetallicRoughness.baseColorTexture.index);
+        mark_srgb(material.emissiveTexture.index);
     }
+
+    auto texture_key = [&](uint32_t i) { return hash_combine(hash_combine(cache_key, i), static_cast<uint64_t>(color_spaces[i])); };
+
+    std::filesystem::path texture_extension = PATH.getTextureExtension();
+
+    JOBS.parallel_for(0, model.images.size(), 1, [&](size_t image_index) {
+        std::vector<uint32_t> uncached_textures{};
+
+        for (uint32_t i : image_textures[image_index]) {
+            if (DDC.find(texture_key(i), texture_extension)) {
+                if (TextureImporter::Load(DDC.entry_path(texture_key(i), texture_extension), this_textures[i], dropped_mips)) continue;
+
+                DDC.discard(texture_key(i), texture_extension);
+                this_textures[i] = resource::Texture{};
+            }
+
+            uncached_textures.emplace_back(i);
+        }
+
+        if (uncached_textures.empty()) return;
+
+        const tinygltf::Image& image = model.images[image_index];
+
+        resource::Texture decoded{};
+        if (image.image.empty() || !TextureImporter::Decode(image.image.data(), image.image.size(), decoded)) {
+            fe::logging::warning("tinygltf -> Unified. Failed to decode an image. Fallback is used\nURI : %s", image.uri.c_str());
+            return;
+        }
+
+        const size_t byte_size = decoded.bytes.get_deleter().count;
+
+        for (size_t n = 0; n < uncached_textures.size(); n++) {
+            uint32_t           i            = uncached_textures[n];
+            resource::Texture& this_texture = this_textures[i];
+
+            this_texture.width      = decoded.width;
+            this_texture.height     = decoded.height;
+            this_texture.components = decoded.components;
+
+            // the last texture takes the decoded buffer, the others share the image and copy it
+            if (n + 1 == uncached_textures.size()) {
+                this_texture.bytes = std::move(decoded.bytes);
+            }
+            else {
+                this_texture.bytes = fe::make_tagged_unique_array<unsigned char, MemoryTag::Textures>(byte_size);
+                std::copy_n(decoded.bytes.get(), byte_size, this_texture.bytes.get());
+            }
+
+            GLTFImporter::loadTexture(model, i, color_spaces[i], this_texture);
+
+            TextureImporter::GenerateMips(this_texture); // sRGB textures are filtered in linear space
+
+            if (DDC.is_enabled() && TextureImporter::Write(this_texture, DDC.entry_path(texture_key(i), texture_extension))) {
+                DDC.store(texture_key(i), texture_extension);
+            }
+
+            TextureImporter::DropTopMips(this_texture, dropped_mips);
+        }
+    });
 }
 
 void fe::GLTFImporter::loadMaterials(GLTFImportContext& context) {
@@ -179,8 +460,32 @@ void fe::GLTFImporter::loadMaterials(GLTFImportContext& context) {
     }
 }
 
-void fe::GLTFImporter::loadVertices(GLTFImportContext& context, Vertices& this_vertices, Indices& this_indices, const tinygltf::Primitive& primitive) {
+void fe::GLTFImporter::linkMaterials(GLTFImportContext& context) {
+    for (size_t i = 0; i < context.model.meshes.size(); i++) {
+        const tinygltf::Mesh& mesh      = context.model.meshes[i];
+        auto&                 this_mesh = context.this_model.meshes[i];
+
+        for (size_t j = 0; j < mesh.primitives.size(); j++) {
+            this_mesh.primitives[j].material_ptr = context.GetMaterial(mesh.primitives[j].material);
+        }
+    }
+}
 
+void fe::GLTFImporter::loadVertices(GLTFImportContext& context, resource::Model::Mesh::Primitive& this_primitive, Indices& this_indices,
+                                    std::vector<VertexData>& this_vertices, VertexFormat& this_format, const tinygltf::Primitive& primitive) {
+    auto position_it = primitive.attributes.find("POSITION");
+    if (position_it == primitive.attributes.end()) {
+        fe::logging::error("tinygltf -> Unified. Primitive has no positions. It isn't drawn");
+        this_primitive.index_count = 0;
+        return;
+    }
+
+    std::vector<glm::vec3> positions{};
+    GLTFImporter::readAttribute(context.model, position_it->second, positions);
+
+    const size_t vertices_count = positions.size();
+
+    // an attribute with another count of elements than the positions is broken and skipped
     auto read_attribute = [&](const std::string& attribute_name, auto& data) {
         auto it = primitive.attributes.find(attribute_name);
         if (it == primitive.attributes.end()) {
@@ -188,10 +493,12 @@ void fe::GLTFImporter::loadVertices(GLTFImportContext& context, Vertices& this_v
             return;
         }
         GLTFImporter::readAttribute(context.model, it->second, data);
-    };
 
-    std::vector<glm::vec3> positions{};
-    read_attribute("POSITION", positions);
+        if (data.size() != vertices_count) {
+            fe::logging::warning("tinygltf -> Unified. Attribute %s has %zu elements instead of %zu. It's skipped", attribute_name.c_str(), data.size(), vertices_count);
+            data.clear();
+        }
+    };
 
     std::vector<glm::vec3> normals{};
     read_attribute("NORMAL", normals);
@@ -205,76 +512,87 @@ void fe::GLTFImporter::loadVertices(GLTFImportContext& context, Vertices& this_v
     std::vector<glm::u16vec4> joints{};
     read_attribute("JOINTS_0", joints);
 
-    std::vector<glm::uvec4> weights{};
+    std::vector<glm::vec4> weights{};
     read_attribute("WEIGHTS_0", weights);
 
-    size_t vertices_count = positions.size();
-    this_vertices.resize(vertices_count);
+    // the indices of this primitive still start from 0
+    std::span<Index> primitive_indices{};
+    if (this_primitive.index_count > 0) {
+        primitive_indices = std::span<Index>(this_indices).subspan(this_primitive.index_offset, this_primitive.index_count);
+    }
 
-    if (tangents.empty()) {
-        tangents.resize(vertices_count);
+    if (std::ranges::any_of(primitive_indices, [&](Index index) { return index >= vertices_count; })) {
+        fe::logging::error("tinygltf -> Unified. Primitive has an index out of its vertices. It isn't drawn");
+        this_primitive.index_count = 0;
+        return;
+    }
 
-        if (positions.empty() || normals.empty() || texture_coords.empty() || this_indices.empty()) {
+    if (tangents.empty()) {
+        if (normals.empty() || texture_coords.empty() || primitive_indices.empty()) {
             fe::logging::warning("Skipping tangent generation. Needed data is missing");
         }
         else {
-            bool good = true;
-
-            for (uint32_t i : this_indices) {
-                if (i >= positions.size() || i >= normals.size() || i >= texture_coords.size()) {
-                    fe::logging::warning("Skipping tangent generation. Bad index : %i", i);
-                    good = false;
-                }
-            }
-
-            if (good) {
-                MikkUserData user_data{
-                    .positions      = &positions,
-                    .normals        = &normals,
-                    .texture_coords = &texture_coords,
-                    .tangents       = &tangents,
-                    .indices        = &this_indices
-                };
-
-                SMikkTSpaceInterface interface{};
-                interface.m_getNumFaces          = getNumberFaces;
-                interface.m_getNumVerticesOfFace = getNumberVerticesOfFace;
-                interface.m_getPosition          = getPosition;
-                interface.m_getNormal            = getNormal;
-                interface.m_getTexCoord          = getTextureCoord;
-                interface.m_setTSpaceBasic       = setTSpaceBasic;
-
-                SMikkTSpaceContext context{};
-                context.m_pInterface = &interface;
-                context.m_pUserData  = &user_data;
-
-                genTangSpaceDefault(&context);
+            tangents.resize(vertices_count);
+
+            MikkUserData user_data{
+                .positions      = &positions,
+                .normals        = &normals,
+                .texture_coords = &texture_coords,
+                .tangents       = &tangents,
+                .indices        = primitive_indices
+            };
+
+            SMikkTSpaceInterface interface{};
+            interface.m_getNumFaces          = getNumberFaces;
+            interface.m_getNumVerticesOfFace = getNumberVerticesOfFace;
+            interface.m_getPosition          = getPosition;
+            interface.m_getNormal            = getNormal;
+            interface.m_getTexCoord          = getTextureCoord;
+            interface.m_setTSpaceBasic       = setTSpaceBasic;
+
+            SMikkTSpaceContext context{};
+            context.m_pInterface = &interface;
+            context.m_pUserData  = &user_data;
+
+            if (!genTangSpaceDefault(&context)) {
+                fe::logging::warning("Skipping tangent generation. MikkTSpace failed");
+                tangents.clear();
             }
         }
     }
 
+    bool joints_clamped = false;
+
+    const size_t base_vertex = this_vertices.size();
+    this_vertices.resize(base_vertex + vertices_count);
+
     for (size_t i = 0; i < vertices_count; i++) {
-        auto& vertex    = this_vertices[i];
-        vertex.position = positions[i];
-
-        // TODO : support this
-
-        //if (i < normals.size()) {
-        //    v.normal = normals[i];
-        //}
-        //if (i < tangents.size()) {
-        //    v.tangent = tangents[i];
-        //}
-        //if (i < texture_coords.size()) {
-        //    v.texture_coord = texture_coords[i];
-        //}
-        //if (i < joints.size()) {
-        //    v.joints = joints[i];
-        //}
-        //if (i < weights.size()) {
-        //    v.weights = weights[i];
-        //}
+        VertexData& vertex = this_vertices[base_vertex + i];
+        vertex.position    = positions[i];
+
+        if (!normals.empty()) vertex.normal = normals[i];
+        if (!tangents.empty()) vertex.tangent = tangents[i];
+        if (!texture_coords.empty()) vertex.texture_coord = texture_coords[i];
+        if (!weights.empty()) vertex.weights = weights[i];
+        if (!joints.empty()) {
+            vertex.joints  = joints[i];
+            joints_clamped = joints_clamped || glm::any(glm::greaterThan(joints[i], glm::u16vec4(255)));
+        }
     }
+
+    if (joints_clamped) {
+        fe::logging::warning("tinygltf -> Unified. Joint indices over 255 aren't supported, they are clamped");
+    }
+
+    // all primitives of the mesh share one vertex buffer
+    for (Index& index : primitive_indices) index += static_cast<Index>(base_vertex);
+
+    // a primitive without an attribute gets the defaults of VertexData for it
+    if (!normals.empty()) this_format.attributes |= vertex_attribute_bit(VertexAttribute::NORMAL);
+    if (!tangents.empty()) this_format.attributes |= vertex_attribute_bit(VertexAttribute::TANGENT);
+    if (!texture_coords.empty()) this_format.attributes |= vertex_attribute_bit(VertexAttribute::TEXTURE_COORD);
+    if (!joints.empty()) this_format.attributes |= vertex_attribute_bit(VertexAttribute::JOINTS);
+    if (!weights.empty()) this_format.attributes |= vertex_attribute_bit(VertexAttribute::WEIGHTS);
 }
 
 void fe::GLTFImporter::loadIndices(GLTFImportContext& context, resource::Model::Mesh::Primitive& this_primitive, Indices& this_indices, const tinygltf::Primitive& primitive) {
@@ -288,15 +606,18 @@ void fe::GLTFImporter::loadIndices(GLTFImportContext& context, resource::Model::
     const tinygltf::Buffer&     buffer      = context.model.buffers[buffer_view.buffer];
     const uint8_t*              data_ptr    = buffer.data.data() + buffer_view.byteOffset + accessor.byteOffset;
 
+    // scratch memory for the source indices. returned to the thread's arena at the end of the function
+    fe::ArenaScope    arena_scope{ fe::thread_arena() };
+    fe::ArenaResource arena_resource{ fe::thread_arena() };
+
     switch (accessor.componentType) {
         case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
-            std::vector<uint8_t> vec{};
+            std::pmr::vector<uint8_t> vec{ &arena_resource };
             vec.resize(accessor.count);
             memcpy(vec.data(), data_ptr, accessor.count * sizeof(uint8_t));
 
             this_indices.insert_range(this_indices.end(), vec);
 
-            this_primitive.index_type   = RenderIndexType::UNSIGNED_INT; // TODO : maybe remove this ?
             this_primitive.index_count  = accessor.count;
             this_primitive.index_offset = context.mesh_primitive_offset_index;
 
@@ -305,7 +626,7 @@ void fe::GLTFImporter::loadIndices(GLTFImportContext& context, resource::Model::
             break;
         }
         case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
-            std::vector<uint16_t> vec{};
+            std::pmr::vector<uint16_t> vec{ &arena_resource };
             vec.resize(accessor.count);
             if (buffer_view.byteStride == 0 || buffer_view.byteStride == sizeof(uint16_t)) { // tightly packed
                 memcpy(vec.data(), data_ptr, accessor.count * sizeof(uint16_t));
@@ -318,7 +639,6 @@ void fe::GLTFImporter::loadIndices(GLTFImportContext& context, resource::Model::
 
             this_indices.insert_range(this_indices.end(), vec);
 
-            this_primitive.index_type   = RenderIndexType::UNSIGNED_INT; // TODO : maybe remove this ?
             this_primitive.index_count  = accessor.count;
             this_primitive.index_offset = context.mesh_primitive_offset_index;
 
@@ -327,7 +647,7 @@ void fe::GLTFImporter::loadIndices(GLTFImportContext& context, resource::Model::
             break;
         }
         case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
-            std::vector<uint32_t> vec{};
+            std::pmr::vector<uint32_t> vec{ &arena_resource };
             vec.resize(accessor.count);
             if (buffer_view.byteStride == 0 || buffer_view.byteStride == sizeof(uint32_t)) { // tightly packed
                 memcpy(vec.data(), data_ptr, accessor.count * sizeof(uint32_t));
@@ -340,7 +660,6 @@ void fe::GLTFImporter::loadIndices(GLTFImportContext& context, resource::Model::
 
             this_indices.insert_range(this_indices.end(), vec);
 
-            this_primitive.index_type   = RenderIndexType::UNSIGNED_INT; // TODO : maybe remove this ?
             this_primitive.index_count  = accessor.count;
             this_primitive.index_offset = context.mesh_primitive_offset_index;
 
@@ -353,6 +672,153 @@ void fe::GLTFImporter::loadIndices(GLTFImportContext& context, resource::Model::
     }
 }
 
+void fe::GLTFImporter::optimizeMesh(resource::Model::Mesh& this_mesh, std::vector<VertexData>& this_vertices, const LodSettings& lod_settings) {
+    using Primitive = resource::Model::Mesh::Primitive;
+
+    if (this_vertices.empty()) return;
+
+    // scratch memory. returned to the thread's arena at the end of the function
+    fe::ArenaScope    arena_scope{ fe::thread_arena() };
+    fe::ArenaResource arena_resource{ fe::thread_arena() };
+
+    // primitives disabled while loading keep their indices, they are left as they are
+    auto lod_indices = [&](const MeshLod& lod) {
+        return std::span<Index>(this_mesh.indices).subspan(lod.index_offset, lod.index_count);
+    };
+    auto primitive_indices = [&](const Primitive& primitive) {
+        return lod_indices(primitive.lod(0));
+    };
+    auto is_triangle_list = [](const Primitive& primitive) {
+        return primitive.render_mode == RenderMode::TRIANGLES && primitive.index_count > 0 && primitive.index_count % 3 == 0;
+    };
+    auto analyze = [&]() {
+        VertexCacheStatistics statistics{};
+        for (const Primitive& primitive : this_mesh.primitives) {
+            if (is_triangle_list(primitive)) statistics += analyze_vertex_cache(primitive_indices(primitive), this_vertices.size());
+        }
+        return statistics;
+    };
+
+    const size_t                source_vertex_count = this_vertices.size();
+    const VertexCacheStatistics source_statistics   = analyze();
+
+    std::pmr::vector<Index> remap(this_vertices.size(), &arena_resource);
+
+    // exporters often write every triangle with its own vertices
+    size_t unique_count = generate_vertex_remap(this_vertices.data(), this_vertices.size(), sizeof(VertexData), remap);
+    if (unique_count < this_vertices.size()) {
+        for (const Primitive& primitive : this_mesh.primitives) remap_indices(primitive_indices(primitive), remap);
+        remap_vertices(this_vertices, remap, unique_count);
+    }
+
+    std::pmr::vector<glm::vec3> positions(&arena_resource);
+    positions.reserve(this_vertices.size());
+    for (const VertexData& vertex : this_vertices) positions.emplace_back(vertex.position);
+
+    // every level is simplified from the full primitive, so its error is the distance to the original surface.
+    // indices of the levels go after the indices of every primitive
+    const float max_error = lod_settings.max_error * this_mesh.bounds.radius;
+
+    std::pmr::vector<Index> source_indices(&arena_resource);
+    std::pmr::vector<Index> simplified_indices(&arena_resource);
+
+    for (Primitive& primitive : this_mesh.primitives) {
+        if (!is_triangle_list(primitive) || lod_settings.max_levels == 0) continue;
+
+        std::span<const Index> indices = primitive_indices(primitive);
+        source_indices.assign(indices.begin(), indices.end()); // the indices of the mesh grow below
+        simplified_indices.resize(source_indices.size());
+
+        size_t previous_count = source_indices.size();
+        for (uint32_t level = 0; level < lod_settings.max_levels; level++) {
+            size_t target_count = static_cast<size_t>(static_cast<float>(previous_count) * lod_settings.reduction) / 3 * 3;
+            if (target_count < 3) break;
+
+            float  error = 0.0f;
+            size_t count = simplify(source_indices, positions, target_count, max_error, simplified_indices, &error);
+
+            // borders, seams or the error limit stopped the simplification. a level that is almost the previous one isn't worth its memory
+            if (count == 0 || static_cast<float>(count) > static_cast<float>(previous_count) * 0.9f) break;
+
+            MeshLod lod{};
+            lod.index_offset = static_cast<int>(this_mesh.indices.size());
+            lod.index_count  = static_cast<int>(count);
+            lod.error        = error;
+            primitive.lods.emplace_back(lod);
+
+            this_mesh.indices.insert(this_mesh.indices.end(), simplified_indices.begin(), simplified_indices.begin() + count);
+            previous_count = count;
+        }
+    }
+
+    std::vector<uint32_t> clusters{};
+    for (Primitive& primitive : this_mesh.primitives) {
+        if (!is_triangle_list(primitive)) continue;
+
+        for (uint32_t level = 0; level <= primitive.lods.size(); level++) {
+            const MeshLod    lod     = primitive.lod(level);
+            std::span<Index> indices = lod_indices(lod);
+
+            optimize_vertex_cache(indices, this_vertices.size(), &clusters);
+            optimize_overdraw(indices, positions, clusters);
+
+            // meshlets keep the order of triangles inside of them, so they are split last. they start in the order of the clusters
+            const size_t first_meshlet = this_mesh.meshlets.size();
+            build_meshlets(indices, positions, this_mesh.meshlets);
+
+            for (size_t i = first_meshlet; i < this_mesh.meshlets.size(); i++) this_mesh.meshlets[i].index_offset += static_cast<uint32_t>(lod.index_offset);
+
+            const int meshlet_offset = static_cast<int>(first_meshlet);
+            const int meshlet_count  = static_cast<int>(this_mesh.meshlets.size() - first_meshlet);
+
+            if (level == 0) {
+                primitive.meshlet_offset = meshlet_offset;
+                primitive.meshlet_count  = meshlet_count;
+            }
+            else {
+                primitive.lods[level - 1].meshlet_offset = meshlet_offset;
+                primitive.lods[level - 1].meshlet_count  = meshlet_count;
+            }
+        }
+    }
+
+    // primitives share the vertices of the mesh, so they are fetched in the order of primitives. coarser levels use vertices of the full one
+    std::pmr::vector<Index> used_indices(&arena_resource);
+    used_indices.reserve(this_mesh.indices.size());
+    for (const Primitive& primitive : this_mesh.primitives) {
+        for (uint32_t level = 0; level <= primitive.lods.size(); level++) {
+            std::span<Index> indices = lod_indices(primitive.lod(level));
+            used_indices.insert(used_indices.end(), indices.begin(), indices.end());
+        }
+    }
+
+    size_t used_count = generate_vertex_fetch_remap(used_indices, this_vertices.size(), remap);
+    for (const Primitive& primitive : this_mesh.primitives) {
+        for (uint32_t level = 0; level <= primitive.lods.size(); level++) remap_indices(lod_indices(primitive.lod(level)), remap);
+    }
+    remap_vertices(this_vertices, remap, used_count);
+
+    if (source_statistics.triangles == 0) return;
+
+    const VertexCacheStatistics statistics = analyze();
+    fe::logging::info("tinygltf -> Unified. Mesh \"%s\" is optimized. Vertices : %zu -> %zu, ACMR : %.3f -> %.3f, ATVR : %.3f -> %.3f, meshlets : %zu", this_mesh.name.c_str(),
+                      source_vertex_count, this_vertices.size(), source_statistics.acmr(), statistics.acmr(), source_statistics.atvr(), statistics.atvr(), this_mesh.meshlets.size());
+
+    // triangles of every level, summed over the primitives
+    std::pmr::vector<size_t> lod_triangles(&arena_resource);
+    for (const Primitive& primitive : this_mesh.primitives) {
+        if (primitive.lods.size() + 1 > lod_triangles.size()) lod_triangles.resize(primitive.lods.size() + 1);
+        for (uint32_t level = 0; level <= primitive.lods.size(); level++) lod_triangles[level] += primitive.lod(level).index_count / 3;
+    }
+
+    if (lod_triangles.size() > 1) {
+        std::string triangles = std::to_string(lod_triangles[0]);
+        for (size_t i = 1; i < lod_triangles.size(); i++) triangles += " -> " + std::to_string(lod_triangles[i]);
+
+        fe::logging::info("tinygltf -> Unified. Mesh \"%s\" has %zu levels of detail. Triangles : %s", this_mesh.name.c_str(), lod_triangles.size() - 1, triangles.c_str());
+    }
+}
+
 using namespace fe::resource;
 
 void fe::GLTFImporter::loadAnimations(GLTFImportContext& context) {
@@ -406,18 +872,10 @@ void fe::GLTFImporter::loadAnimations(GLTFImportContext& context) {
     }
 }
 
-fe::pointer<Texture> fe::GLTFImporter::createTexture(const tinygltf::Model& model, uint32_t texture_index, ResourceStorage& storage) {
-    if (texture_index >= model.textures.size()) {
-        fe::logging::warning("tinygltf -> Unified. Failed to create a texture. Texture index : %i\nFallbacks are not ready yet", texture_index);
-        return {}; // TODO : think about fallbacks
-    }
-
+void fe::GLTFImporter::loadTexture(const tinygltf::Model& model, uint32_t texture_index, Texture::ColorSpace color_space, Texture& this_texture) {
     const tinygltf::Texture& texture = model.textures[texture_index];
-    const tinygltf::Image&   image   = model.images[texture.source];
     tinygltf::Sampler        sampler{};
 
-    resource::Texture::ColorSpace texture_color_space = resource::Texture::ColorSpace::LINEAR;
-
     if (texture.sampler >= 0) {
         sampler = model.samplers[texture.sampler];
     }
@@ -428,36 +886,34 @@ fe::pointer<Texture> fe::GLTFImporter::createTexture(const tinygltf::Model& mode
         sampler.wrapT     = TINYGLTF_TEXTURE_WRAP_REPEAT;
     }
 
-    Texture this_texture{};
-
-    if (texture_color_space == Texture::ColorSpace::SRGB) {
-        if (image.component == 4) // number of color channels
+    if (color_space == Texture::ColorSpace::SRGB && this_texture.components >= 3) {
+        if (this_texture.components == 4) // number of color channels
             this_texture.internal_format = Texture::InternalFormat::SRGB8_ALPHA8;
         else
             this_texture.internal_format = Texture::InternalFormat::SRGB8;
     }
     else {
         // clang-format off
-        switch (image.component) { // number of color channels
+        switch (this_texture.components) { // number of color channels
             case 4: this_texture.internal_format = Texture::InternalFormat::RGBA8; break;
             case 3: this_texture.internal_format = Texture::InternalFormat::RGB8 ; break;
             case 2: this_texture.internal_format = Texture::InternalFormat::RG8  ; break;
             case 1: this_texture.internal_format = Texture::InternalFormat::R8   ; break;
             default:
-                fe::logging::warning("tinygltf -> Unified. Unsupported components ( number of color channels ) %i for internal format. Using RGBA8 as default", image.component);
+                fe::logging::warning("tinygltf -> Unified. Unsupported components ( number of color channels ) %i for internal format. Using RGBA8 as default", this_texture.components);
                 this_texture.internal_format = Texture::InternalFormat::RGBA8;
         }
         // clang-format on
     }
 
     // clang-format off
-    switch (image.component) { // number of color channels
+    switch (this_texture.components) { // number of color channels
         case 4: this_texture.data_format = Texture::DataFormat::RGBA; break;
         case 3: this_texture.data_format = Texture::DataFormat::RGB ; break;
         case 2: this_texture.data_format = Texture::DataFormat::RG  ; break;
         case 1: this_texture.data_format = Texture::DataFormat::RED ; break;
         default:
-            fe::logging::warning("tinygltf -> Unified. Unsupported components ( number of color channels ) %i for data format. Using RGBA as default", image.component);
+            fe::logging::warning("tinygltf -> Unified. Unsupported components ( number of color channels ) %i for data format. Using RGBA as default", this_texture.components);
             this_texture.data_format = Texture::DataFormat::RGBA;
     }
     // clang-format on
@@ -507,60 +963,21 @@ fe::pointer<Texture> fe::GLTFImporter::createTexture(const tinygltf::Model& mode
     }
     // clang-format on
 
-    this_texture.components = static_cast<uint8_t>(image.component);
-    this_texture.width      = image.width;
-    this_texture.height     = image.height;
-    this_texture.target     = Texture::Target::TEXTURE_2D; // TODO : for what this thing even needed ?
-
-    size_t buffer_size = image.width * image.height * image.component;
-    this_texture.bytes = std::make_unique<unsigned char[]>(buffer_size);
+    this_texture.target = Texture::Target::TEXTURE_2D; // TODO : for what this thing even needed ?
+}
 
-    if (!image.image.empty() && buffer_size == image.image.size()) {
-        std::copy(image.image.begin(), image.image.end(), this_texture.bytes.get());
-    }
-    else {
-        fe::logging::warning("tinygltf -> Unified. Failed to create a texture\nURI : %s", image.uri.c_str());
-        return {}; // TODO : think about fallbacks
+// the glTF is parsed with the encoded bytes only. stbi doesn't even read the headers here, that happens in the jobs of loadTextures()
+bool fe::GLTFImporter::keepEncodedImage(tinygltf::Image* image, const int image_index, std::string* /*unused*/, std::string* warning,
+                                        int /*unused*/, int /*unused*/, const unsigned char* bytes, int size, void* /*unused*/) {
+    if (!bytes || size <= 0) {
+        if (warning) *warning += "Image " + std::to_string(image_index) + " is empty\n";
+        return false;
     }
 
-    auto ptr = storage.CreateResource<Texture>(std::move(this_texture));
+    image->as_is = true;
+    image->image.assign(bytes, bytes + size);
 
-    // TODO : think about - Is this really so much needed ?
-    // Texture::ColorSpace::SRGB <-> Texture::ColorSpace::LINEAR
-    //
-    //for (const auto& mesh : this_model.meshes) {
-    //    for (const auto& primitive : mesh.primitives) {
-    //        const auto& material = *storage.GetResource(primitive.material_ptr);
-    //
-    //        if (material.pbr_metallic_roughness.base_color_texture.texture_ptr == ptr ||
-    //            material.emissive_texture.texture_ptr == ptr) {
-    //
-    //            texture_color_space = Texture::ColorSpace::SRGB;
-    //
-    //            if (texture_color_space == Texture::ColorSpace::SRGB) {
-    //                if (image.component == 4) // number of color channels
-    //                    this_texture.internal_format = Texture::InternalFormat::SRGB8_ALPHA8;
-    //                else
-    //                    this_texture.internal_format = Texture::InternalFormat::SRGB8;
-    //            }
-    //            else {
-    //                // clang-format off
-    //                switch (image.component) { // number of color channels
-    //                    case 4: this_texture.internal_format = Texture::InternalFormat::RGBA8; break;
-    //                    case 3: this_texture.internal_format = Texture::InternalFormat::RGB8 ; break;
-    //                    case 2: this_texture.internal_format = Texture::InternalFormat::RG8  ; break;
-    //                    case 1: this_texture.internal_format = Texture::InternalFormat::R8   ; break;
-    //                    default:
-    //                        fe::logging::warning("tinygltf -> Unified. Unsupported components ( number of color channels ) %i for internal format. Using RGBA8 as default", image.component);
-    //                        this_texture.internal_format = Texture::InternalFormat::RGBA8;
-    //                }
-    //                // clang-format on
-    //            }
-    //        }
-    //    }
-    //}
-
-    return ptr;
+    return true;
 }
 
 #undef OPAQUE
@@ -611,10 +1028,10 @@ fe::pointer<Material> fe::GLTFImporter::createMaterial(GLTFImportContext& contex
     //    this_material.emissive_texture.texture_ptr   = context.GetTexture(material.emissiveTexture.index);
     //    this_material.emissive_texture.texture_coord = material.emissiveTexture.texCoord;
 
-    //auto ptr = context.storage.CreateResource<Material>(std::move(this_material));
+    //auto ptr = context.storage->CreateResource<Material>(std::move(this_material));
     //return ptr;
 
-    return context.storage.GetContext().default_gltf_material_ptr; // TODO : create material instance
+    return context.storage->GetContext().default_gltf_material_ptr; // TODO : create material instance
 }
 
 void fe::GLTFImporter::readVector(glm::vec2& dst, const std::vector<double>& src) {
@@ -664,7 +1081,7 @@ FORR_NODISCARD float fe::GLTFImporter::readComponentAsFloat(const uint8_t* data,
     }
 }
 
-void fe::GLTFImporter::readAccessorVec4(const tinygltf::Model& model, int accessor_index, std::vector<glm::vec4>& out) {
+void fe::GLTFImporter::readAccessorVec4(const tinygltf::Model& model, int accessor_index, fe::tagged_vector<glm::vec4, MemoryTag::Animation>& out) {
     const auto& accessor    = model.accessors[accessor_index];
     const auto& buffer_view = model.bufferViews[accessor.bufferView];
     const auto& buffer      = model.buffers[buffer_view.buffer];
@@ -722,8 +1139,8 @@ void fe::GLTFImporter::readAccessorVec4(const tinygltf::Model& model, int access
     }
 }
 
-void fe::GLTFImporter::readAccessorFloat(const tinygltf::Model& model, int accessor_index, std::vector<float>& out) {
-    std::vector<glm::vec4> temp{};
+void fe::GLTFImporter::readAccessorFloat(const tinygltf::Model& model, int accessor_index, fe::tagged_vector<float, MemoryTag::Animation>& out) {
+    fe::tagged_vector<glm::vec4, MemoryTag::Animation> temp{};
     readAccessorVec4(model, accessor_index, temp);
 
     out.resize(temp.size());
@@ -17,6 +17,20 @@
 #include "tiny_gltf.h"
 
 namespace fe {
+    // result of GLTFImporter::Load(). nothing here is in the storage yet, GLTFImporter::Publish() puts it there
+    struct GLTFImportResult {
+        tinygltf::Model source{}; // bytes of buffers and images are released after loading, materials are created from it later
+
+        resource::Model                model{};
+        std::vector<resource::Texture> textures{}; // by tinygltf texture index. a texture without bytes failed to load
+
+        GLTFImportResult()  = default;
+        ~GLTFImportResult() = default;
+
+        FORR_CLASS_NONCOPYABLE(GLTFImportResult)
+        FORR_CLASS_MOVABLE(GLTFImportResult)
+    };
+
     struct GLTFImportContext {
     public:
         const tinygltf::Model& model;
@@ -25,27 +39,29 @@ namespace fe {
         std::vector<fe::pointer<resource::Texture>>  textures;
         std::vector<fe::pointer<resource::Material>> materials;
 
-        ResourceStorage& storage;
+        ResourceStorage* storage{}; // nullptr while loading, resources are created only when publishing
+
+        LodSettings lod_settings{}; // of the meshes being loaded
 
         // this needs to store index_count and index_offset of Mesh::Primitive
         uint32_t mesh_primitive_offset_index{};
 
         // safe function
         fe::pointer<resource::Texture> GetTexture(uint32_t index) const noexcept {
-            if (index >= textures.size()) return {}; // TODO : provide fallbacks
+            if (index >= textures.size()) return storage->GetContext().fallback_texture_ptr;
             return textures[index];
         }
 
         // safe function
         fe::pointer<resource::Material> GetMaterial(uint32_t index) const noexcept {
-            if (index >= materials.size()) return {}; // TODO : provide fallbacks
+            if (index >= materials.size()) return storage->GetContext().default_gltf_material_ptr;
             return materials[index];
         }
 
         GLTFImportContext()  = default;
         ~GLTFImportContext() = default;
 
-        GLTFImportContext(const tinygltf::Model& model, resource::Model& this_model, ResourceStorage& storage)
+        GLTFImportContext(const tinygltf::Model& model, resource::Model& this_model, ResourceStorage* storage)
             : model(model), this_model(this_model), storage(storage) {}
     };
 
@@ -53,32 +69,69 @@ namespace fe {
     private:
         inline static constexpr size_t JOINTS_COUNT = 128; // temp
     public:
+        inline static constexpr uint32_t VERSION = 8; // increase it when geometry or texture processing is changed, cached outputs are made again
+
         GLTFImporter()  = default;
         ~GLTFImporter() = default;
 
         static fe::pointer<resource::Model> Import(ResourceStorage& storage, const std::filesystem::path& resource_full_path);
 
+        // parses the file, decodes images and processes geometry without touching the storage, so it can run on any thread.
+        // the processed model and textures are taken from and stored to DDC, images of cached textures aren't decoded.
+        // 'texture_dropped_mips' is passed to TextureImporter::Load(). meshes keep only 'vertex_attributes' of what the file has,
+        // the cached model has all of them. triangle lists get levels of detail by 'lod_settings'.
+        // without 'load_textures' images aren't decoded and 'result.textures' stays empty, for the cooker that needs only the geometry
+        static FORR_NODISCARD bool Load(const std::filesystem::path& resource_full_path, GLTFImportResult& result, uint32_t texture_dropped_mips = 0,
+                                        VertexAttributes vertex_attributes = ALL_VERTEX_ATTRIBUTES, const LodSettings& lod_settings = {},
+                                        bool load_textures = true);
+
+        // one texture of the file by tinygltf texture index, the same as Load() gives. images of the other textures aren't decoded.
+        // it restores an evicted texture, the file is parsed again for it
+        static FORR_NODISCARD bool LoadTexture(const std::filesystem::path& resource_full_path, uint32_t texture_index, resource::Texture& texture,
+                                               uint32_t texture_dropped_mips = 0);
+
+        // creates textures, materials and the model in the storage. cheap comparing to Load().
+        // 'textures' gets the textures of the file by tinygltf texture index, failed ones are the fallback. if it has the textures
+        // of the previous version of the file, their slots get the new textures of the same index and keep their GPU slots
+        static fe::pointer<resource::Model> Publish(ResourceStorage& storage, GLTFImportResult& result, std::vector<fe::pointer<resource::Texture>>* textures = nullptr);
+
     private:
+        // parses the file with encoded images. 'cache_key' covers the file, external buffers and encoded external images
+        static FORR_NODISCARD bool parseFile(const std::filesystem::path& resource_full_path, tinygltf::Model& model, uint64_t& cache_key);
+
         static void loadNodes(GLTFImportContext& context);
         static void loadSceneRoots(GLTFImportContext& context);
         static void loadSkins(GLTFImportContext& context);
         static void loadMeshes(GLTFImportContext& context);
-        static void loadTextures(GLTFImportContext& context);
+        // 'this_textures' gets every texture of the file, or only the one of 'texture_index' if it isn't -1
+        static void loadTextures(tinygltf::Model& model, uint64_t cache_key, std::vector<resource::Texture>& this_textures, uint32_t dropped_mips,
+                                 int texture_index = -1);
         static void loadMaterials(GLTFImportContext& context);
-        static void loadVertices(GLTFImportContext& context, Vertices& this_vertices, Indices& this_indices, const tinygltf::Primitive& primitive);
+        static void linkMaterials(GLTFImportContext& context);
+        // appends the vertices of the primitive to the mesh and moves its indices past the vertices of the previous primitives
+        static void loadVertices(GLTFImportContext& context, resource::Model::Mesh::Primitive& this_primitive, Indices& this_indices,
+                                 std::vector<VertexData>& this_vertices, VertexFormat& this_format, const tinygltf::Primitive& primitive);
         static void loadIndices(GLTFImportContext& context, resource::Model::Mesh::Primitive& this_primitive, Indices& this_indices, const tinygltf::Primitive& primitive);
+        // welds equal vertices, makes levels of detail of triangle lists and reorders triangles of every level for the vertex cache and overdraw,
+        // splits every level into meshlets, then reorders vertices for fetching
+        static void optimizeMesh(resource::Model::Mesh& this_mesh, std::vector<VertexData>& this_vertices, const LodSettings& lod_settings);
         static void loadAnimations(GLTFImportContext& context);
 
     private:
-        static fe::pointer<resource::Texture>  createTexture(const tinygltf::Model& model, uint32_t texture_index, ResourceStorage& storage);
+        // sampler and formats of an already decoded texture. only RGB and RGBA textures can be sRGB
+        static void                            loadTexture(const tinygltf::Model& model, uint32_t texture_index, resource::Texture::ColorSpace color_space,
+                                                           resource::Texture& this_texture);
         static fe::pointer<resource::Material> createMaterial(GLTFImportContext& context, uint32_t tinygltf_material_index);
 
+        // tinygltf::LoadImageDataFunction. keeps the encoded bytes, they are decoded in parallel later
+        static FORR_NODISCARD bool keepEncodedImage(tinygltf::Image* image, const int image_index, std::string* error, std::string* warning,
+                                                    int required_width, int required_height, const unsigned char* bytes, int size, void* user_data);
+
     private:
         template <typename T>
             requires(std::is_same_v<T, glm::vec2> ||
                      std::is_same_v<T, glm::vec3> ||
                      std::is_same_v<T, glm::vec4> ||
-                     std::is_same_v<T, glm::uvec4> ||
                      std::is_same_v<T, glm::u16vec4> ||
                      std::is_same_v<T, glm::mat4>)
         static void readAttribute(const tinygltf::Model& model, size_t accessor_index, std::vector<T>& out) {
@@ -102,6 +155,18 @@ namespace fe {
             for (size_t i = 0; i < accessor.count; i++) {
                 const uint8_t* p = data_ptr + (i * stride);
 
+                // normalized integers ( UVs, weights ) are converted to floats
+                if constexpr (std::is_same_v<T, glm::vec2> || std::is_same_v<T, glm::vec3> || std::is_same_v<T, glm::vec4>) {
+                    if (accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) {
+                        T v(0.0f);
+                        for (int c = 0; c < std::min(num_components, static_cast<int>(T::length())); c++) {
+                            v[c] = readComponentAsFloat(p + (c * component_size), accessor.componentType, accessor.normalized);
+                        }
+                        out[i] = v;
+                        continue;
+                    }
+                }
+
                 if constexpr (std::is_same_v<T, glm::vec2>) {
                     const auto* f = reinterpret_cast<const float*>(p);
                     out[i]        = glm::vec2(f[0], f[1]);
@@ -115,8 +180,13 @@ namespace fe {
                     out[i]        = glm::vec4(f[0], f[1], f[2], f[3]);
                 }
                 else if constexpr (std::is_same_v<T, glm::u16vec4>) {
-                    const auto* ptr = reinterpret_cast<const uint16_t*>(p);
-                    out[i]          = glm::u16vec4(ptr[0], ptr[1], ptr[2], ptr[3]);
+                    if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
+                        out[i] = glm::u16vec4(p[0], p[1], p[2], p[3]);
+                    }
+                    else {
+                        const auto* ptr = reinterpret_cast<const uint16_t*>(p);
+                        out[i]          = glm::u16vec4(ptr[0], ptr[1], ptr[2], ptr[3]);
+                    }
                 }
                 else if constexpr (std::is_same_v<T, glm::mat4>) {
                     glm::mat4 m{};
@@ -148,8 +218,8 @@ namespace fe {
 
         static FORR_NODISCARD float readComponentAsFloat(const uint8_t* data, int component_type, bool normalized);
 
-        static void readAccessorVec4(const tinygltf::Model& model, int accessor_index, std::vector<glm::vec4>& out);
-        static void readAccessorFloat(const tinygltf::Model& model, int accessor_index, std::vector<float>& out);
+        static void readAccessorVec4(const tinygltf::Model& model, int accessor_index, fe::tagged_vector<glm::vec4, MemoryTag::Animation>& out);
+        static void readAccessorFloat(const tinygltf::Model& model, int accessor_index, fe::tagged_vector<float, MemoryTag::Animation>& out);
     };
 
 } // namespace fe
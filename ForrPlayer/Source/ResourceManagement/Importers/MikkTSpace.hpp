@@ -12,19 +12,21 @@
 
 #pragma once
 
+#include <span>
+
 #include "mikktspace.h"
 
 struct MikkUserData {
-    std::vector<glm::vec3>* positions;
-    std::vector<glm::vec3>* normals;
-    std::vector<glm::vec2>* texture_coords;
-    std::vector<glm::vec4>* tangents; // output
-    std::vector<uint32_t>*  indices;
+    std::vector<glm::vec3>*    positions;
+    std::vector<glm::vec3>*    normals;
+    std::vector<glm::vec2>*    texture_coords;
+    std::vector<glm::vec4>*    tangents; // output
+    std::span<const fe::Index> indices; // of one primitive
 };
 
 int getNumberFaces(const SMikkTSpaceContext* p_context) {
     auto* data = (MikkUserData*) p_context->m_pUserData;
-    return data->indices->size() / 3;
+    return data->indices.size() / 3;
 }
 
 int getNumberVerticesOfFace(const SMikkTSpaceContext* /*unused*/, int /*unused*/) {
@@ -33,7 +35,7 @@ int getNumberVerticesOfFace(const SMikkTSpaceContext* /*unused*/, int /*unused*/
 
 void getPosition(const SMikkTSpaceContext* p_context, float position[3], int face, int vertex) {
     auto*    data  = (MikkUserData*) p_context->m_pUserData;
-    uint32_t index = (*data->indices)[(face * 3) + vertex];
+    uint32_t index = data->indices[(face * 3) + vertex];
     auto&    p     = (*data->positions)[index];
     position[0]    = p.x;
     position[1]    = p.y;
@@ -42,7 +44,7 @@ void getPosition(const SMikkTSpaceContext* p_context, float position[3], int fac
 
 void getNormal(const SMikkTSpaceContext* p_context, float normal[3], int face, int vertex) {
     auto*    data  = (MikkUserData*) p_context->m_pUserData;
-    uint32_t index = (*data->indices)[(face * 3) + vertex];
+    uint32_t index = data->indices[(face * 3) + vertex];
     auto&    p     = (*data->normals)[index];
     normal[0]      = p.x;
     normal[1]      = p.y;
@@ -51,7 +53,7 @@ void getNormal(const SMikkTSpaceContext* p_context, float normal[3], int face, i
 
 void getTextureCoord(const SMikkTSpaceContext* p_context, float texture_coord[2], int face, int vertex) {
     auto*    data    = (MikkUserData*) p_context->m_pUserData;
-    uint32_t index   = (*data->indices)[(face * 3) + vertex];
+    uint32_t index   = data->indices[(face * 3) + vertex];
     auto&    p       = (*data->texture_coords)[index];
     texture_coord[0] = p.x;
     texture_coord[1] = p.y;
@@ -63,6 +65,6 @@ void setTSpaceBasic(const SMikkTSpaceContext* p_context,
                     const int                 face,
                     const int                 vertex) {
     auto*    data            = (MikkUserData*) p_context->m_pUserData;
-    uint32_t index           = (*data->indices)[(face * 3) + vertex];
+    uint32_t index           = data->indices[(face * 3) + vertex];
     (*data->tangents)[index] = glm::vec4(tangent[0], tangent[1], tangent[2], sign);
 }
@@ -0,0 +1,184 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ModelFormat.hpp
+    Role : layout of cooked models ( .forr_model )
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+#include "Graphics/GPUTypes.hpp"
+#include "Graphics/VertexFormat.hpp"
+
+// .forr_model is a header and flat arrays of records ( sections ). little-endian.
+// every section starts at a 16-byte aligned offset, so a mapped file is read in place without parsing.
+// records refer to each other and to the data sections by [first, first + count) ranges.
+// change VERSION when anything here, fe::Vertex or its encoding is changed
+namespace fe {
+    enum class ModelFileSection : uint32_t {
+        NODES,
+        SKINS,
+        MESHES,
+        PRIMITIVES,
+        LODS,
+        MESHLETS,
+        ANIMATIONS,
+        CHANNELS,
+        SAMPLERS,
+
+        VERTICES,      // fe::Vertex, quantized
+        INDICES,       // fe::Index, of meshes with RenderIndexType::UNSIGNED_INT
+        SHORT_INDICES, // uint16_t, of meshes with RenderIndexType::UNSIGNED_SHORT
+        MATRICES,      // glm::mat4
+        VEC4S,         // glm::vec4
+        FLOATS,        // float
+        INTS,          // int32_t
+        STRINGS,       // chars, not null-terminated
+
+        COUNT
+    };
+
+    struct ModelFileRange {
+        uint32_t first{};
+        uint32_t count{};
+    };
+
+    struct ModelFileSectionInfo {
+        uint64_t offset{}; // from the beginning of the file
+        uint64_t size{};   // in bytes
+    };
+
+    struct ModelFileHeader {
+        inline static constexpr uint32_t MAGIC     = 0x444D5246; // "FRMD"
+        inline static constexpr uint32_t VERSION   = 5;
+        inline static constexpr size_t   ALIGNMENT = 16;
+
+        uint32_t magic{ MAGIC };
+        uint32_t version{ VERSION };
+        uint32_t vertex_size{ sizeof(Vertex) };
+        uint32_t index_size{ sizeof(Index) };
+
+        ModelFileRange scene_roots{}; // INTS
+
+        glm::vec3 quantization_scale{ 1.0f }; // resource::Model::vertex_quantization
+        glm::vec3 quantization_bias{ 0.0f };
+
+        ModelFileSectionInfo sections[static_cast<size_t>(ModelFileSection::COUNT)]{};
+    };
+
+    struct ModelFileNode {
+        int32_t camera{ -1 };
+        int32_t skin{ -1 };
+        int32_t mesh{ -1 };
+        int32_t light{ -1 };
+        int32_t emitter{ -1 };
+
+        ModelFileRange name{};     // STRINGS
+        ModelFileRange children{}; // INTS
+        ModelFileRange weights{};  // FLOATS
+
+        glm::quat rotation{ 1, 0, 0, 0 };
+        glm::vec3 scale{ 1, 1, 1 };
+        glm::vec3 translation{ 0, 0, 0 };
+
+        glm::mat4 local_matrix{ 1.0f };
+        glm::mat4 global_matrix{ 1.0f };
+    };
+
+    struct ModelFileSkin {
+        ModelFileRange name{};                  // STRINGS
+        ModelFileRange inverse_bind_matrices{}; // MATRICES
+        ModelFileRange joints{};                // INTS
+
+        int32_t  skeleton{ -1 };
+        uint32_t bone_final_matrices_count{};
+    };
+
+    struct ModelFileMesh {
+        ModelFileRange name{};       // STRINGS
+        ModelFileRange vertices{};   // VERTICES
+        ModelFileRange indices{};    // INDICES or SHORT_INDICES, by 'index_type'
+        ModelFileRange primitives{}; // PRIMITIVES
+        ModelFileRange meshlets{};   // MESHLETS
+        ModelFileRange weights{};    // FLOATS
+
+        uint32_t vertex_attributes{};    // fe::VertexFormat
+        uint32_t unorm_texture_coords{};
+        uint32_t index_type{}; // fe::RenderIndexType
+
+        glm::vec3 bounds_center{}; // resource::Model::Mesh::bounds
+        float     bounds_radius{};
+    };
+
+    struct ModelFilePrimitive {
+        inline static constexpr uint32_t DEFAULT_MATERIAL = ~uint32_t(0);
+
+        uint32_t material{ DEFAULT_MATERIAL }; // materials aren't cooked yet, the default glTF material is used
+        uint32_t render_mode{};                // fe::RenderMode
+        int32_t  index_count{};
+        int32_t  index_offset{};
+        int32_t  meshlet_offset{}; // in the meshlets of the mesh
+        int32_t  meshlet_count{};
+
+        ModelFileRange lods{}; // LODS, coarser levels of detail
+    };
+
+    struct ModelFileLod {
+        int32_t index_offset{};
+        int32_t index_count{};
+        float   error{};
+        int32_t meshlet_offset{}; // in the meshlets of the mesh
+        int32_t meshlet_count{};
+    };
+
+    struct ModelFileMeshlet {
+        uint32_t index_offset{};
+        uint32_t index_count{};
+        uint32_t vertex_count{};
+
+        glm::vec3 bounds_center{};
+        float     bounds_radius{};
+        glm::vec3 aabb_min{};
+        glm::vec3 aabb_max{};
+        glm::vec3 cone_axis{};
+        float     cone_cutoff{};
+    };
+
+    struct ModelFileAnimation {
+        ModelFileRange channels{}; // CHANNELS
+        ModelFileRange samplers{}; // SAMPLERS
+    };
+
+    struct ModelFileChannel {
+        int32_t  sampler{ -1 };
+        int32_t  target_node{ -1 };
+        uint32_t target_path{}; // resource::Model::AnimationChannel::TargetPath
+    };
+
+    struct ModelFileSampler {
+        ModelFileRange times{};  // FLOATS
+        ModelFileRange values{}; // VEC4S
+
+        uint32_t interpolation{}; // resource::Model::AnimationSampler::InterpolationMode
+    };
+
+    // sections are read in place, so every record has to be a plain copy of bytes
+    static_assert(std::is_trivially_copyable_v<ModelFileHeader>);
+    static_assert(std::is_trivially_copyable_v<ModelFileNode>);
+    static_assert(std::is_trivially_copyable_v<ModelFileSkin>);
+    static_assert(std::is_trivially_copyable_v<ModelFileMesh>);
+    static_assert(std::is_trivially_copyable_v<ModelFilePrimitive>);
+    static_assert(std::is_trivially_copyable_v<ModelFileLod>);
+    static_assert(std::is_trivially_copyable_v<ModelFileMeshlet>);
+    static_assert(std::is_trivially_copyable_v<ModelFileAnimation>);
+    static_assert(std::is_trivially_copyable_v<ModelFileChannel>);
+    static_assert(std::is_trivially_copyable_v<ModelFileSampler>);
+    static_assert(std::is_trivially_copyable_v<Vertex>);
+} // namespace fe
@@ -0,0 +1,545 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ModelImporter.cpp
+    Role : imports resources and their metadata. for forr_model.
+        also writes models to it
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "ModelImporter.hpp"
+
+#include <array>
+#include <fstream>
+#include <limits>
+#include <span>
+
+#include "Core/derived_data_cache.hpp"
+#include "Core/mapped_file.hpp"
+
+using namespace fe::resource;
+
+namespace fe {
+    static constexpr size_t G_MODEL_FILE_SECTION_COUNT = static_cast<size_t>(ModelFileSection::COUNT);
+
+    // clang-format off
+    static constexpr std::array<size_t, G_MODEL_FILE_SECTION_COUNT> G_MODEL_FILE_RECORD_SIZES = {
+        sizeof(ModelFileNode),
+        sizeof(ModelFileSkin),
+        sizeof(ModelFileMesh),
+        sizeof(ModelFilePrimitive),
+        sizeof(ModelFileLod),
+        sizeof(ModelFileMeshlet),
+        sizeof(ModelFileAnimation),
+        sizeof(ModelFileChannel),
+        sizeof(ModelFileSampler),
+        sizeof(Vertex),
+        sizeof(Index),
+        sizeof(uint16_t),
+        sizeof(glm::mat4),
+        sizeof(glm::vec4),
+        sizeof(float),
+        sizeof(int32_t),
+        sizeof(char),
+    };
+    // clang-format on
+
+    // collects the sections before they are written to the file
+    struct ModelFileWriter {
+        std::array<std::vector<std::byte>, G_MODEL_FILE_SECTION_COUNT> sections{};
+
+        bool good = true; // false if a section is too big for ModelFileRange
+
+        template <typename T>
+        ModelFileRange append(ModelFileSection section, const T* data, size_t count) {
+            std::vector<std::byte>& bytes = sections[static_cast<size_t>(section)];
+
+            size_t first = bytes.size() / sizeof(T);
+            if (first + count > std::numeric_limits<uint32_t>::max()) {
+                good = false;
+                return {};
+            }
+
+            if (count != 0) {
+                size_t offset = bytes.size();
+                bytes.resize(offset + count * sizeof(T));
+                memcpy(bytes.data() + offset, data, count * sizeof(T));
+            }
+
+            return ModelFileRange{ static_cast<uint32_t>(first), static_cast<uint32_t>(count) };
+        }
+
+        template <typename T, typename Allocator>
+        ModelFileRange append(ModelFileSection section, const std::vector<T, Allocator>& vector) {
+            return this->append(section, vector.data(), vector.size());
+        }
+
+        ModelFileRange append(const std::string& string) {
+            return this->append(ModelFileSection::STRINGS, string.data(), string.size());
+        }
+    };
+
+    // gives typed views of the sections of a mapped file. any range out of its section marks the file as broken
+    struct ModelFileReader {
+        const MappedFile&      file;
+        const ModelFileHeader& header;
+
+        bool good = true;
+
+        template <typename T>
+        std::span<const T> section(ModelFileSection section) const noexcept {
+            const ModelFileSectionInfo& info = header.sections[static_cast<size_t>(section)];
+            return { reinterpret_cast<const T*>(file.data() + info.offset), static_cast<size_t>(info.size / sizeof(T)) };
+        }
+
+        template <typename T>
+        std::span<const T> range(ModelFileSection section, ModelFileRange range) noexcept {
+            std::span<const T> all = this->section<T>(section);
+
+            if (static_cast<size_t>(range.first) + range.count > all.size()) {
+                good = false;
+                return {};
+            }
+            return all.subspan(range.first, range.count);
+        }
+
+        std::string string(ModelFileRange range) noexcept {
+            std::span<const char> chars = this->range<char>(ModelFileSection::STRINGS, range);
+            return std::string(chars.begin(), chars.end());
+        }
+
+        ModelFileReader(const MappedFile& file, const ModelFileHeader& header) : file(file), header(header) {}
+        ~ModelFileReader() = default;
+    };
+
+    static bool validateModelFile(const MappedFile& file, const std::filesystem::path& path) {
+        if (file.size() < sizeof(ModelFileHeader)) {
+            fe::logging::error("File -> Unified. Failed to load a cooked model. The file is too small\nPath : %s", path.string().c_str());
+            return false;
+        }
+
+        const auto& header = *reinterpret_cast<const ModelFileHeader*>(file.data());
+
+        if (header.magic != ModelFileHeader::MAGIC) {
+            fe::logging::error("File -> Unified. Failed to load a cooked model. It's not a .forr_model file\nPath : %s", path.string().c_str());
+            return false;
+        }
+        if (header.version != ModelFileHeader::VERSION || header.vertex_size != sizeof(Vertex) || header.index_size != sizeof(Index)) {
+            fe::logging::error("File -> Unified. Failed to load a cooked model. The file is outdated ( version %u ), cook it again\nPath : %s", header.version, path.string().c_str());
+            return false;
+        }
+
+        for (size_t i = 0; i < G_MODEL_FILE_SECTION_COUNT; i++) {
+            const ModelFileSectionInfo& info = header.sections[i];
+
+            bool in_file   = info.offset <= file.size() && info.size <= file.size() - info.offset;
+            bool aligned   = info.offset % ModelFileHeader::ALIGNMENT == 0;
+            bool whole_set = info.size % G_MODEL_FILE_RECORD_SIZES[i] == 0;
+
+            if (!in_file || !aligned || !whole_set) {
+                fe::logging::error("File -> Unified. Failed to load a cooked model. Section %zu is broken\nPath : %s", i, path.string().c_str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+} // namespace fe
+
+fe::pointer<Model> fe::ModelImporter::Import(ResourceStorage& storage, const std::filesystem::path& resource_full_path) {
+    Model model{};
+    if (!ModelImporter::Load(storage.GetContext(), resource_full_path, model)) return {};
+
+    auto ptr = storage.CreateResource(std::move(model));
+    return ptr;
+}
+
+bool fe::ModelImporter::Load(const ResourceManagementContext& context, const std::filesystem::path& resource_full_path, Model& this_model) {
+    MappedFile file{};
+    if (!file.open(resource_full_path)) return false;
+
+    if (!validateModelFile(file, resource_full_path)) return false;
+
+    const auto&     header = *reinterpret_cast<const ModelFileHeader*>(file.data());
+    ModelFileReader reader{ file, header };
+
+    auto read_ints = [&](ModelFileRange range) -> std::vector<int> {
+        std::span<const int32_t> ints = reader.range<int32_t>(ModelFileSection::INTS, range);
+        return std::vector<int>(ints.begin(), ints.end());
+    };
+
+    auto read_floats = [&](ModelFileRange range) -> std::vector<float> {
+        std::span<const float> floats = reader.range<float>(ModelFileSection::FLOATS, range);
+        return std::vector<float>(floats.begin(), floats.end());
+    };
+
+    std::span<const ModelFileNode> nodes = reader.section<ModelFileNode>(ModelFileSection::NODES);
+    this_model.nodes.resize(nodes.size());
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const ModelFileNode& node      = nodes[i];
+        auto&                this_node = this_model.nodes[i];
+
+        this_node.camera        = node.camera;
+        this_node.skin          = node.skin;
+        this_node.mesh          = node.mesh;
+        this_node.light         = node.light;
+        this_node.emitter       = node.emitter;
+        this_node.name          = reader.string(node.name);
+        this_node.children      = read_ints(node.children);
+        this_node.weights       = read_floats(node.weights);
+        this_node.rotation      = node.rotation;
+        this_node.scale         = node.scale;
+        this_node.translation   = node.translation;
+        this_node.local_matrix  = node.local_matrix;
+        this_node.global_matrix = node.global_matrix;
+    }
+
+    this_model.scene_roots = read_ints(header.scene_roots);
+
+    this_model.vertex_quantization.scale = header.quantization_scale;
+    this_model.vertex_quantization.bias  = header.quantization_bias;
+
+    std::span<const ModelFileSkin> skins = reader.section<ModelFileSkin>(ModelFileSection::SKINS);
+    this_model.skins.resize(skins.size());
+
+    for (size_t i = 0; i < skins.size(); i++) {
+        const ModelFileSkin& skin      = skins[i];
+        auto&                this_skin = this_model.skins[i];
+
+        std::span<const glm::mat4> matrices = reader.range<glm::mat4>(ModelFileSection::MATRICES, skin.inverse_bind_matrices);
+
+        this_skin.name = reader.string(skin.name);
+        this_skin.inverse_bind_matrices.assign(matrices.begin(), matrices.end());
+        this_skin.skeleton = skin.skeleton;
+        this_skin.joints   = read_ints(skin.joints);
+        this_skin.bone_final_matrices.resize(skin.bone_final_matrices_count);
+    }
+
+    std::span<const ModelFileMesh> meshes = reader.section<ModelFileMesh>(ModelFileSection::MESHES);
+    this_model.meshes.resize(meshes.size());
+
+    for (size_t i = 0; i < meshes.size(); i++) {
+        const ModelFileMesh& mesh      = meshes[i];
+        auto&                this_mesh = this_model.meshes[i];
+
+        // one bulk copy per section, nothing is done per vertex
+        std::span<const Vertex> vertices = reader.range<Vertex>(ModelFileSection::VERTICES, mesh.vertices);
+
+        this_mesh.name = reader.string(mesh.name);
+        this_mesh.vertices.assign(vertices.begin(), vertices.end());
+        this_mesh.weights = read_floats(mesh.weights);
+
+        // 16-bit indices are widened, the CPU works with fe::Index only
+        if (static_cast<RenderIndexType>(mesh.index_type) == RenderIndexType::UNSIGNED_SHORT) {
+            std::span<const uint16_t> indices = reader.range<uint16_t>(ModelFileSection::SHORT_INDICES, mesh.indices);
+
+            this_mesh.indices.assign(indices.begin(), indices.end());
+            this_mesh.index_type = RenderIndexType::UNSIGNED_SHORT;
+        }
+        else {
+            std::span<const Index> indices = reader.range<Index>(ModelFileSection::INDICES, mesh.indices);
+
+            this_mesh.indices.assign(indices.begin(), indices.end());
+            this_mesh.index_type = RenderIndexType::UNSIGNED_INT;
+        }
+
+        this_mesh.vertex_format.attributes           = static_cast<VertexAttributes>(mesh.vertex_attributes & ALL_VERTEX_ATTRIBUTES) | vertex_attribute_bit(VertexAttribute::POSITION);
+        this_mesh.vertex_format.unorm_texture_coords = mesh.unorm_texture_coords != 0;
+        this_mesh.bounds.center                      = mesh.bounds_center;
+        this_mesh.bounds.radius                      = mesh.bounds_radius;
+
+        std::span<const ModelFileMeshlet> meshlets = reader.range<ModelFileMeshlet>(ModelFileSection::MESHLETS, mesh.meshlets);
+        this_mesh.meshlets.resize(meshlets.size());
+
+        for (size_t j = 0; j < meshlets.size(); j++) {
+            const ModelFileMeshlet& meshlet      = meshlets[j];
+            auto&                   this_meshlet = this_mesh.meshlets[j];
+
+            this_meshlet.index_offset  = meshlet.index_offset;
+            this_meshlet.index_count   = meshlet.index_count;
+            this_meshlet.vertex_count  = meshlet.vertex_count;
+            this_meshlet.bounds.center = meshlet.bounds_center;
+            this_meshlet.bounds.radius = meshlet.bounds_radius;
+            this_meshlet.aabb_min      = meshlet.aabb_min;
+            this_meshlet.aabb_max      = meshlet.aabb_max;
+            this_meshlet.cone_axis     = meshlet.cone_axis;
+            this_meshlet.cone_cutoff   = meshlet.cone_cutoff;
+        }
+
+        std::span<const ModelFilePrimitive> primitives = reader.range<ModelFilePrimitive>(ModelFileSection::PRIMITIVES, mesh.primitives);
+        this_mesh.primitives.resize(primitives.size());
+
+        for (size_t j = 0; j < primitives.size(); j++) {
+            const ModelFilePrimitive& primitive      = primitives[j];
+            auto&                     this_primitive = this_mesh.primitives[j];
+
+            this_primitive.material_ptr   = context.default_gltf_material_ptr; // materials aren't in the file
+            this_primitive.render_mode    = static_cast<RenderMode>(primitive.render_mode);
+            this_primitive.index_count    = primitive.index_count;
+            this_primitive.index_offset   = primitive.index_offset;
+            this_primitive.meshlet_offset = primitive.meshlet_offset;
+            this_primitive.meshlet_count  = primitive.meshlet_count;
+
+            std::span<const ModelFileLod> lods = reader.range<ModelFileLod>(ModelFileSection::LODS, primitive.lods);
+            this_primitive.lods.resize(lods.size());
+
+            for (size_t k = 0; k < lods.size(); k++) {
+                this_primitive.lods[k].index_offset   = lods[k].index_offset;
+                this_primitive.lods[k].index_count    = lods[k].index_count;
+                this_primitive.lods[k].error          = lods[k].error;
+                this_primitive.lods[k].meshlet_offset = lods[k].meshlet_offset;
+                this_primitive.lods[k].meshlet_count  = lods[k].meshlet_count;
+            }
+        }
+    }
+
+    std::span<const ModelFileAnimation> animations = reader.section<ModelFileAnimation>(ModelFileSection::ANIMATIONS);
+    this_model.animations.resize(animations.size());
+
+    for (size_t i = 0; i < animations.size(); i++) {
+        const ModelFileAnimation& animation      = animations[i];
+        auto&                     this_animation = this_model.animations[i];
+
+        std::span<const ModelFileChannel> channels = reader.range<ModelFileChannel>(ModelFileSection::CHANNELS, animation.channels);
+        this_animation.channels.resize(channels.size());
+
+        for (size_t j = 0; j < channels.size(); j++) {
+            auto& this_channel       = this_animation.channels[j];
+            this_channel.sampler     = channels[j].sampler;
+            this_channel.target_node = channels[j].target_node;
+            this_channel.target_path = static_cast<Model::AnimationChannel::TargetPath>(channels[j].target_path);
+        }
+
+        std::span<const ModelFileSampler> samplers = reader.range<ModelFileSampler>(ModelFileSection::SAMPLERS, animation.samplers);
+        this_animation.samplers.resize(samplers.size());
+
+        for (size_t j = 0; j < samplers.size(); j++) {
+            auto& this_sampler = this_animation.samplers[j];
+
+            std::span<const float>     times  = reader.range<float>(ModelFileSection::FLOATS, samplers[j].times);
+            std::span<const glm::vec4> values = reader.range<glm::vec4>(ModelFileSection::VEC4S, samplers[j].values);
+
+            this_sampler.times.assign(times.begin(), times.end());
+            this_sampler.values.assign(values.begin(), values.end());
+            this_sampler.interpolation = static_cast<Model::AnimationSampler::InterpolationMode>(samplers[j].interpolation);
+        }
+    }
+
+    if (!reader.good) {
+        fe::logging::error("File -> Unified. Failed to load a cooked model. A range is out of its section\nPath : %s", resource_full_path.string().c_str());
+        this_model = Model{};
+        return false;
+    }
+
+    ModelImporter::KeepVertexAttributes(this_model, context.vertex_attributes);
+
+    return true;
+}
+
+bool fe::ModelImporter::Write(const Model& model, const std::filesystem::path& resource_full_path) {
+    ModelFileWriter writer{};
+    ModelFileHeader header{};
+
+    for (const auto& node : model.nodes) {
+        ModelFileNode this_node{};
+        this_node.camera        = node.camera;
+        this_node.skin          = node.skin;
+        this_node.mesh          = node.mesh;
+        this_node.light         = node.light;
+        this_node.emitter       = node.emitter;
+        this_node.name          = writer.append(node.name);
+        this_node.children      = writer.append(ModelFileSection::INTS, node.children);
+        this_node.weights       = writer.append(ModelFileSection::FLOATS, node.weights);
+        this_node.rotation      = node.rotation;
+        this_node.scale         = node.scale;
+        this_node.translation   = node.translation;
+        this_node.local_matrix  = node.local_matrix;
+        this_node.global_matrix = node.global_matrix;
+
+        writer.append(ModelFileSection::NODES, &this_node, 1);
+    }
+
+    header.scene_roots = writer.append(ModelFileSection::INTS, model.scene_roots);
+
+    header.quantization_scale = model.vertex_quantization.scale;
+    header.quantization_bias  = model.vertex_quantization.bias;
+
+    for (const auto& skin : model.skins) {
+        ModelFileSkin this_skin{};
+        this_skin.name                      = writer.append(skin.name);
+        this_skin.inverse_bind_matrices     = writer.append(ModelFileSection::MATRICES, skin.inverse_bind_matrices);
+        this_skin.joints                    = writer.append(ModelFileSection::INTS, skin.joints);
+        this_skin.skeleton                  = skin.skeleton;
+        this_skin.bone_final_matrices_count = static_cast<uint32_t>(skin.bone_final_matrices.size());
+
+        writer.append(ModelFileSection::SKINS, &this_skin, 1);
+    }
+
+    for (const auto& mesh : model.meshes) {
+        ModelFileMesh this_mesh{};
+        this_mesh.name     = writer.append(mesh.name);
+        this_mesh.vertices = writer.append(ModelFileSection::VERTICES, mesh.vertices);
+        this_mesh.weights  = writer.append(ModelFileSection::FLOATS, mesh.weights);
+
+        if (mesh.index_type == RenderIndexType::UNSIGNED_SHORT) {
+            std::vector<uint16_t> short_indices(mesh.indices.size());
+            pack_indices(mesh.indices, RenderIndexType::UNSIGNED_SHORT, short_indices.data());
+
+            this_mesh.indices    = writer.append(ModelFileSection::SHORT_INDICES, short_indices);
+            this_mesh.index_type = static_cast<uint32_t>(RenderIndexType::UNSIGNED_SHORT);
+        }
+        else {
+            this_mesh.indices    = writer.append(ModelFileSection::INDICES, mesh.indices);
+            this_mesh.index_type = static_cast<uint32_t>(RenderIndexType::UNSIGNED_INT);
+        }
+
+        this_mesh.vertex_attributes    = mesh.vertex_format.attributes;
+        this_mesh.unorm_texture_coords = mesh.vertex_format.unorm_texture_coords ? 1 : 0;
+        this_mesh.bounds_center        = mesh.bounds.center;
+        this_mesh.bounds_radius        = mesh.bounds.radius;
+
+        std::vector<ModelFilePrimitive> primitives(mesh.primitives.size());
+        for (size_t i = 0; i < mesh.primitives.size(); i++) {
+            const auto& primitive = mesh.primitives[i];
+
+            primitives[i].render_mode    = static_cast<uint32_t>(primitive.render_mode);
+            primitives[i].index_count    = primitive.index_count;
+            primitives[i].index_offset   = primitive.index_offset;
+            primitives[i].meshlet_offset = primitive.meshlet_offset;
+            primitives[i].meshlet_count  = primitive.meshlet_count;
+
+            std::vector<ModelFileLod> lods(primitive.lods.size());
+            for (size_t j = 0; j < primitive.lods.size(); j++) {
+                lods[j].index_offset   = primitive.lods[j].index_offset;
+                lods[j].index_count    = primitive.lods[j].index_count;
+                lods[j].error          = primitive.lods[j].error;
+                lods[j].meshlet_offset = primitive.lods[j].meshlet_offset;
+                lods[j].meshlet_count  = primitive.lods[j].meshlet_count;
+            }
+            primitives[i].lods = writer.append(ModelFileSection::LODS, lods);
+        }
+        this_mesh.primitives = writer.append(ModelFileSection::PRIMITIVES, primitives);
+
+        std::vector<ModelFileMeshlet> meshlets(mesh.meshlets.size());
+        for (size_t i = 0; i < mesh.meshlets.size(); i++) {
+            const auto& meshlet = mesh.meshlets[i];
+
+            meshlets[i].index_offset  = meshlet.index_offset;
+            meshlets[i].index_count   = meshlet.index_count;
+            meshlets[i].vertex_count  = meshlet.vertex_count;
+            meshlets[i].bounds_center = meshlet.bounds.center;
+            meshlets[i].bounds_radius = meshlet.bounds.radius;
+            meshlets[i].aabb_min      = meshlet.aabb_min;
+            meshlets[i].aabb_max      = meshlet.aabb_max;
+            meshlets[i].cone_axis     = meshlet.cone_axis;
+            meshlets[i].cone_cutoff   = meshlet.cone_cutoff;
+        }
+        this_mesh.meshlets = writer.append(ModelFileSection::MESHLETS, meshlets);
+
+        writer.append(ModelFileSection::MESHES, &this_mesh, 1);
+    }
+
+    for (const auto& animation : model.animations) {
+        std::vector<ModelFileChannel> channels(animation.channels.size());
+        for (size_t i = 0; i < animation.channels.size(); i++) {
+            channels[i].sampler     = animation.channels[i].sampler;
+            channels[i].target_node = animation.channels[i].target_node;
+            channels[i].target_path = static_cast<uint32_t>(animation.channels[i].target_path);
+        }
+
+        std::vector<ModelFileSampler> samplers(animation.samplers.size());
+        for (size_t i = 0; i < animation.samplers.size(); i++) {
+            samplers[i].times         = writer.append(ModelFileSection::FLOATS, animation.samplers[i].times);
+            samplers[i].values        = writer.append(ModelFileSection::VEC4S, animation.samplers[i].values);
+            samplers[i].interpolation = static_cast<uint32_t>(animation.samplers[i].interpolation);
+        }
+
+        ModelFileAnimation this_animation{};
+        this_animation.channels = writer.append(ModelFileSection::CHANNELS, channels);
+        this_animation.samplers = writer.append(ModelFileSection::SAMPLERS, samplers);
+
+        writer.append(ModelFileSection::ANIMATIONS, &this_animation, 1);
+    }
+
+    if (!writer.good) {
+        fe::logging::error("Failed to write a cooked model. The model is too big\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
+
+    auto align = [](uint64_t offset) { return (offset + ModelFileHeader::ALIGNMENT - 1) & ~uint64_t(ModelFileHeader::ALIGNMENT - 1); };
+
+    uint64_t offset = align(sizeof(ModelFileHeader));
+    for (size_t i = 0; i < G_MODEL_FILE_SECTION_COUNT; i++) {
+        header.sections[i].offset = offset;
+        header.sections[i].size   = writer.sections[i].size();
+
+        offset = align(offset + header.sections[i].size);
+    }
+
+    std::vector<std::byte> bytes(offset);
+    memcpy(bytes.data(), &header, sizeof(ModelFileHeader));
+
+    for (size_t i = 0; i < G_MODEL_FILE_SECTION_COUNT; i++) {
+        if (writer.sections[i].empty()) continue;
+        memcpy(bytes.data() + header.sections[i].offset, writer.sections[i].data(), writer.sections[i].size());
+    }
+
+    // written to a temporary file first, so a reader never sees a half-written model
+    std::filesystem::path temporary_path = DerivedDataCache::temporary_path(resource_full_path);
+
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!file.good()) {
+            fe::logging::error("File -> Unified. Failed to create a file for a cooked model\nPath : %s", temporary_path.string().c_str());
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file.good()) {
+            fe::logging::error("File -> Unified. Failed to write a cooked model\nPath : %s", temporary_path.string().c_str());
+            return false;
+        }
+    }
+
+    std::error_code error_code{};
+    std::filesystem::rename(temporary_path, resource_full_path, error_code);
+    if (error_code) {
+        fe::logging::error("File -> Unified. Failed to replace a cooked model. %s\nPath : %s", error_code.message().c_str(), resource_full_path.string().c_str());
+        std::filesystem::remove(temporary_path, error_code);
+        return false;
+    }
+
+    return true;
+}
+
+void fe::ModelImporter::KeepVertexAttributes(Model& model, VertexAttributes vertex_attributes) {
+    vertex_attributes |= vertex_attribute_bit(VertexAttribute::POSITION);
+
+    for (auto& mesh : model.meshes) {
+        VertexAttributes dropped = mesh.vertex_format.attributes & ~vertex_attributes;
+        if (dropped == 0) continue;
+
+        mesh.vertex_format.attributes &= vertex_attributes;
+        if (!mesh.vertex_format.has(VertexAttribute::TEXTURE_COORD)) mesh.vertex_format.unorm_texture_coords = false;
+
+        // the fields of dropped attributes are zero, like in meshes that never had them
+        auto dropped_has = [&](VertexAttribute attribute) { return (dropped & vertex_attribute_bit(attribute)) != 0; };
+
+        for (Vertex& vertex : mesh.vertices) {
+            if (dropped_has(VertexAttribute::NORMAL)) vertex.normal = {};
+            if (dropped_has(VertexAttribute::TANGENT)) {
+                vertex.tangent    = {};
+                vertex.position.w = 65535;
+            }
+            if (dropped_has(VertexAttribute::TEXTURE_COORD)) vertex.texture_coord = {};
+            if (dropped_has(VertexAttribute::JOINTS)) vertex.joints = {};
+            if (dropped_has(VertexAttribute::WEIGHTS)) vertex.weights = {};
+        }
+    }
+}
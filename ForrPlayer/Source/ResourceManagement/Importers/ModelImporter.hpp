@@ -0,0 +1,35 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ModelImporter.hpp
+    Role : imports resources and their metadata. for forr_model.
+        also writes models to it
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#pragma once
+#include "ResourceManagement/ResourceStorage.hpp"
+#include "ModelFormat.hpp"
+
+namespace fe {
+    class ModelImporter {
+    public:
+        ModelImporter()  = default;
+        ~ModelImporter() = default;
+
+        static fe::pointer<resource::Model> Import(ResourceStorage& storage, const std::filesystem::path& resource_full_path);
+
+        // maps the file and copies its sections to the model without touching the storage, so it can run on any thread
+        static FORR_NODISCARD bool Load(const ResourceManagementContext& context, const std::filesystem::path& resource_full_path, resource::Model& this_model);
+
+        // the output of any model importer can be written. materials aren't written yet
+        static FORR_NODISCARD bool Write(const resource::Model& model, const std::filesystem::path& resource_full_path);
+
+        // drops the attributes that aren't in 'vertex_attributes' from every mesh. the position is always kept
+        static void KeepVertexAttributes(resource::Model& model, VertexAttributes vertex_attributes);
+    };
+} // namespace fe
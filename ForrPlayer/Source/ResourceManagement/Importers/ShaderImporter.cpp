@@ -13,20 +13,445 @@
 #include "pch.hpp"
 #include "ShaderImporter.hpp"
 
+#include <algorithm>
 #include <fstream>
 
 #include "Graphics/Shaders/ShaderReflector.hpp"
 #include "Graphics/Shaders/ShaderCompiler.hpp"
+#include "Graphics/Shaders/ShaderVariants.hpp"
+
+#include "Core/derived_data_cache.hpp"
+#include "Core/job_system.hpp"
+#include "Core/mapped_file.hpp"
 
 using namespace fe::resource;
 
+namespace fe {
+    // .forr_shader is this header, keyword names, the variants one after another and the names of everything.
+    // a variant is ShaderFileVariant, SPIR-V words, property records and specialization constant records.
+    // reflection is stored, so loading doesn't need SPIRV-Reflect
+    struct ShaderFileHeader {
+        inline static constexpr uint32_t MAGIC   = 0x48535246; // "FRSH"
+        inline static constexpr uint32_t VERSION = 3;
+
+        uint32_t magic{ MAGIC };
+        uint32_t version{ VERSION };
+
+        uint32_t type{};             // resource::Shader::Type
+        uint32_t graphics_backend{}; // SPIR-V differs for OpenGL and Vulkan
+
+        uint32_t keyword_count{};
+        uint32_t variant_count{}; // always ShaderVariants::GetVariantCount( keyword_count )
+        uint32_t names_size{};    // in bytes
+        uint32_t reserved{};
+    };
+
+    struct ShaderFileName {
+        uint32_t offset{}; // in the names
+        uint32_t size{};
+    };
+
+    struct ShaderFileVariant {
+        uint64_t variant_key{};
+        uint64_t word_count{};
+
+        uint32_t property_count{};
+        uint32_t specialization_constant_count{};
+    };
+
+    struct ShaderFileProperty {
+        ShaderFileName name{};
+
+        uint32_t offset{};
+        uint32_t size{};
+        uint32_t count{};
+        uint32_t type{}; // resource::Shader::Property::Type
+    };
+
+    struct ShaderFileSpecializationConstant {
+        ShaderFileName name{};
+
+        uint32_t constant_id{};
+        uint32_t value{};
+    };
+
+    static ShaderFileName appendName(std::string& names, std::string_view name) {
+        ShaderFileName file_name{};
+        file_name.offset = static_cast<uint32_t>(names.size());
+        file_name.size   = static_cast<uint32_t>(name.size());
+
+        names += name;
+        return file_name;
+    }
+
+    template <typename T>
+    static void appendRecord(std::vector<std::byte>& bytes, const T* records, size_t count) {
+        const auto* begin = reinterpret_cast<const std::byte*>(records);
+        bytes.insert(bytes.end(), begin, begin + count * sizeof(T));
+    }
+
+    // reads 'count' records and moves 'data' after them. false if the file ends earlier
+    template <typename T>
+    static bool readRecord(const std::byte*& data, const std::byte* end, T* records, uint64_t count) {
+        if (count > static_cast<uint64_t>(end - data) / sizeof(T)) return false;
+
+        memcpy(records, data, count * sizeof(T));
+        data += count * sizeof(T);
+        return true;
+    }
+
+    // records of a map sorted by name, so the same shader gives the same file
+    template <typename T>
+    static std::vector<const std::pair<const std::string, T>*> sortByName(const std::unordered_map<std::string, T>& map) {
+        std::vector<const std::pair<const std::string, T>*> sorted{};
+        sorted.reserve(map.size());
+        for (const auto& pair : map) sorted.emplace_back(&pair);
+
+        std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+        return sorted;
+    }
+} // namespace fe
+
 fe::pointer<fe::resource::Shader> fe::ShaderImporter::Import(ResourceStorage& storage, const std::filesystem::path& resource_full_path) {
-    Shader shader{};
+    ShaderImportResult result{};
+    if (!ShaderImporter::Load(storage.GetContext(), resource_full_path, result)) return {};
+
+    return ShaderImporter::Publish(storage, result);
+}
+
+bool fe::ShaderImporter::Load(const ResourceManagementContext& context, const std::filesystem::path& resource_full_path, ShaderImportResult& result) {
+    return ShaderImporter::LoadBatch(context, { &resource_full_path, 1 }, { &result, 1 }) == 1;
+}
+
+size_t fe::ShaderImporter::LoadBatch(const ResourceManagementContext& context, std::span<const std::filesystem::path> resource_full_paths, std::span<ShaderImportResult> results) {
+    if (resource_full_paths.size() != results.size()) {
+        fe::logging::error("Failed to load a batch of shaders. There are %zu paths for %zu results", resource_full_paths.size(), results.size());
+        return 0;
+    }
+
+    const size_t count = resource_full_paths.size();
+
+    struct BatchItem {
+        std::string              source_code{};
+        Shader::Type             type{};
+        std::vector<std::string> keywords{};
+        uint64_t                 cache_key{};
+
+        size_t first_request{}; // the requests of the variants go one after another
+
+        bool loaded{}; // cooked or cached, nothing to compile
+        bool failed{};
+    };
+
+    std::vector<BatchItem> items(count);
+
+    // reading and cache lookups, these are mostly waiting for the disk
+    JOBS.parallel_for(0, count, 1, [&](size_t index) {
+        const std::filesystem::path& path   = resource_full_paths[index];
+        BatchItem&                   item   = items[index];
+        ShaderImportResult&          result = results[index];
+
+        result.variants.clear();
+
+        if (path.extension() == PATH.getShaderExtension()) {
+            item.loaded = ShaderImporter::loadCooked(context, path, result);
+            item.failed = !item.loaded;
+            return;
+        }
+
+        if (!ShaderImporter::readSource(path, item.source_code, item.type) || !ShaderVariants::ParseKeywords(item.source_code, item.keywords)) {
+            fe::logging::error("Failed to load a shader\nPath : %s", path.string().c_str());
+            item.failed = true;
+            return;
+        }
+
+        // the keywords are in the source, so the key of the source covers every variant
+        item.cache_key = ShaderImporter::cacheKey(item.source_code, item.type, context.graphics_backend);
+        item.loaded    = ShaderImporter::loadCached(context, item.cache_key, result);
+    });
+
+    std::vector<ShaderCompileRequest> requests{};
+
+    for (size_t i = 0; i < count; i++) {
+        BatchItem& item = items[i];
+        if (item.loaded || item.failed) continue;
+
+        item.first_request = requests.size();
+
+        const size_t variant_count = ShaderVariants::GetVariantCount(item.keywords.size());
+        for (uint64_t variant_key = 0; variant_key < variant_count; variant_key++) {
+            ShaderCompileRequest& request = requests.emplace_back();
+            request.source                = item.source_code;
+            request.type                  = item.type;
+            request.graphics_backend      = context.graphics_backend;
+            request.defines               = ShaderVariants::GetDefines(item.keywords, variant_key);
+            request.name                  = resource_full_paths[i];
+        }
+    }
+
+    std::vector<Shader> compiled(requests.size());
+    ShaderCompiler::CompileBatch(requests, compiled);
+
+    JOBS.parallel_for(0, count, 1, [&](size_t index) {
+        BatchItem&          item   = items[index];
+        ShaderImportResult& result = results[index];
+
+        if (item.loaded || item.failed) return;
+
+        const size_t variant_count = ShaderVariants::GetVariantCount(item.keywords.size());
+
+        result.variants.resize(variant_count);
+        for (uint64_t variant_key = 0; variant_key < variant_count; variant_key++) {
+            Shader& variant = compiled[item.first_request + variant_key];
+
+            if (variant.source_code.empty()) { // the compiler has already reported why
+                result.variants.clear();
+                item.failed = true;
+                return;
+            }
+
+            variant.keywords    = item.keywords;
+            variant.variant_key = variant_key;
+
+            result.variants[variant_key] = std::move(variant);
+        }
+
+        ShaderImporter::storeCached(result, context.graphics_backend, item.cache_key);
+    });
+
+    size_t loaded_count{};
+    for (const BatchItem& item : items) loaded_count += item.failed ? 0 : 1;
+
+    if (!requests.empty()) {
+        fe::logging::info("Compiled %zu shader variants of %zu shaders on %zu workers", requests.size(), count, JOBS.worker_count());
+    }
+
+    return loaded_count;
+}
+
+fe::pointer<fe::resource::Shader> fe::ShaderImporter::Publish(ResourceStorage& storage, ShaderImportResult& result) {
+    if (result.variants.empty()) return {};
+
+    std::vector<fe::pointer<Shader>> variants{};
+    variants.reserve(result.variants.size());
+
+    for (Shader& variant : result.variants) variants.emplace_back(storage.CreateResource(std::move(variant)));
+    result.variants.clear();
+
+    fe::pointer<Shader> base = variants[0];
+
+    // nobody else has the pointer yet
+    storage.GetResource(base)->variants = std::move(variants);
+
+    return base;
+}
+
+bool fe::ShaderImporter::Write(const ShaderImportResult& result, GraphicsBackend graphics_backend, const std::filesystem::path& resource_full_path) {
+    if (result.variants.empty() || result.variants.size() != ShaderVariants::GetVariantCount(result.variants[0].keywords.size())) {
+        fe::logging::error("Failed to write a cooked shader. Its variants are incomplete\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
+
+    const Shader& base = result.variants[0];
+
+    std::string            names{};
+    std::vector<std::byte> bytes(sizeof(ShaderFileHeader));
+
+    for (const std::string& keyword : base.keywords) {
+        ShaderFileName file_name = appendName(names, keyword);
+        appendRecord(bytes, &file_name, 1);
+    }
+
+    for (const Shader& variant : result.variants) {
+        if (variant.source_code.empty()) {
+            fe::logging::error("Failed to write a cooked shader. Variant %llu has no SPIR-V\nPath : %s", static_cast<unsigned long long>(variant.variant_key), resource_full_path.string().c_str());
+            return false;
+        }
+
+        ShaderFileVariant file_variant{};
+        file_variant.variant_key                   = variant.variant_key;
+        file_variant.word_count                    = variant.source_code.size();
+        file_variant.property_count                = static_cast<uint32_t>(variant.properties.size());
+        file_variant.specialization_constant_count = static_cast<uint32_t>(variant.specialization_constants.size());
+
+        appendRecord(bytes, &file_variant, 1);
+        appendRecord(bytes, variant.source_code.data(), variant.source_code.size());
+
+        for (const auto* property : sortByName(variant.properties)) {
+            ShaderFileProperty file_property{};
+            file_property.name   = appendName(names, property->first);
+            file_property.offset = property->second.offset;
+            file_property.size   = property->second.size;
+            file_property.count  = property->second.count;
+            file_property.type   = static_cast<uint32_t>(property->second.type);
+
+            appendRecord(bytes, &file_property, 1);
+        }
+
+        for (const auto* constant : sortByName(variant.specialization_constants)) {
+            ShaderFileSpecializationConstant file_constant{};
+            file_constant.name        = appendName(names, constant->first);
+            file_constant.constant_id = constant->second.constant_id;
+            file_constant.value       = constant->second.value;
+
+            appendRecord(bytes, &file_constant, 1);
+        }
+    }
+
+    ShaderFileHeader header{};
+    header.type             = static_cast<uint32_t>(base.type);
+    header.graphics_backend = static_cast<uint32_t>(graphics_backend);
+    header.keyword_count    = static_cast<uint32_t>(base.keywords.size());
+    header.variant_count    = static_cast<uint32_t>(result.variants.size());
+    header.names_size       = static_cast<uint32_t>(names.size());
+
+    memcpy(bytes.data(), &header, sizeof(header));
+
+    std::filesystem::path temporary_path = DerivedDataCache::temporary_path(resource_full_path);
+
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        if (!file.good()) {
+            fe::logging::error("File -> Unified. Failed to write a cooked shader\nPath : %s", temporary_path.string().c_str());
+            return false;
+        }
+    }
+
+    std::error_code error_code{};
+    std::filesystem::rename(temporary_path, resource_full_path, error_code);
+    if (error_code) {
+        fe::logging::error("File -> Unified. Failed to replace a cooked shader. %s\nPath : %s", error_code.message().c_str(), resource_full_path.string().c_str());
+        std::filesystem::remove(temporary_path, error_code);
+        return false;
+    }
+
+    return true;
+}
+
+bool fe::ShaderImporter::loadCooked(const ResourceManagementContext& context, const std::filesystem::path& resource_full_path, ShaderImportResult& result) {
+    MappedFile file{};
+    if (!file.open(resource_full_path)) return false;
+
+    const std::byte* data = file.data();
+    const std::byte* end  = file.data() + file.size();
+
+    ShaderFileHeader header{};
+    if (!readRecord(data, end, &header, 1)) {
+        fe::logging::error("File -> Unified. Failed to load a cooked shader. The file is too small\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
+
+    if (header.magic != ShaderFileHeader::MAGIC || header.version != ShaderFileHeader::VERSION) {
+        fe::logging::error("File -> Unified. Failed to load a cooked shader. The file is outdated or it's not .forr_shader, cook it again\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
+    if (header.graphics_backend != static_cast<uint32_t>(context.graphics_backend)) {
+        fe::logging::error("Failed to load a cooked shader. It was compiled for another graphics backend\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
+
+    auto broken = [&resource_full_path, &result]() {
+        fe::logging::error("File -> Unified. Failed to load a cooked shader. The file is broken\nPath : %s", resource_full_path.string().c_str());
+        result.variants.clear();
+        return false;
+    };
+
+    if (header.keyword_count > ShaderVariants::MAX_KEYWORDS || header.variant_count != ShaderVariants::GetVariantCount(header.keyword_count) ||
+        header.names_size > file.size() - sizeof(header)) {
+        return broken();
+    }
+
+    end -= header.names_size; // the names are at the end of the file
+
+    const char* names = reinterpret_cast<const char*>(end);
+
+    auto readName = [names, &header](const ShaderFileName& name, std::string& string) {
+        if (static_cast<uint64_t>(name.offset) + name.size > header.names_size) return false;
+
+        string.assign(names + name.offset, name.size);
+        return true;
+    };
+
+    std::vector<ShaderFileName> keyword_names(header.keyword_count);
+    if (!readRecord(data, end, keyword_names.data(), keyword_names.size())) return broken();
+
+    std::vector<std::string> keywords(header.keyword_count);
+    for (size_t i = 0; i < keywords.size(); i++) {
+        if (!readName(keyword_names[i], keywords[i])) return broken();
+    }
+
+    result.variants.resize(header.variant_count);
+
+    for (uint64_t variant_key = 0; variant_key < header.variant_count; variant_key++) {
+        Shader& shader = result.variants[variant_key];
+
+        ShaderFileVariant file_variant{};
+        if (!readRecord(data, end, &file_variant, 1) || file_variant.variant_key != variant_key || file_variant.word_count == 0) return broken();
+
+        shader.type        = static_cast<Shader::Type>(header.type);
+        shader.keywords    = keywords;
+        shader.variant_key = variant_key;
+
+        if (file_variant.word_count > static_cast<uint64_t>(end - data) / sizeof(uint32_t)) return broken();
+
+        shader.source_code.resize(file_variant.word_count);
+        if (!readRecord(data, end, shader.source_code.data(), shader.source_code.size())) return broken();
+
+        std::vector<ShaderFileProperty> properties(file_variant.property_count);
+        if (!readRecord(data, end, properties.data(), properties.size())) return broken();
+
+        std::vector<ShaderFileSpecializationConstant> constants(file_variant.specialization_constant_count);
+        if (!readRecord(data, end, constants.data(), constants.size())) return broken();
+
+        shader.properties.reserve(properties.size());
+        for (const ShaderFileProperty& file_property : properties) {
+            std::string name{};
+            if (!readName(file_property.name, name)) return broken();
+
+            Shader::Property property{};
+            property.offset = file_property.offset;
+            property.size   = file_property.size;
+            property.count  = file_property.count;
+            property.type   = static_cast<Shader::Property::Type>(file_property.type);
+
+            shader.properties.insert({ std::move(name), property });
+        }
+
+        shader.specialization_constants.reserve(constants.size());
+        for (const ShaderFileSpecializationConstant& file_constant : constants) {
+            std::string name{};
+            if (!readName(file_constant.name, name)) return broken();
+
+            Shader::SpecializationConstant constant{};
+            constant.constant_id = file_constant.constant_id;
+            constant.value       = file_constant.value;
+
+            shader.specialization_constants.insert({ std::move(name), constant });
+        }
+    }
+
+    return true;
+}
+
+bool fe::ShaderImporter::readSource(const std::filesystem::path& resource_full_path, std::string& source_code, Shader::Type& type) {
+    if (resource_full_path.extension() == PATH.getVertexShaderExtension()) {
+        type = Shader::Type::VERTEX;
+    }
+    else if (resource_full_path.extension() == PATH.getFragmentShaderExtension()) {
+        type = Shader::Type::FRAGMENT;
+    }
+    else {
+        fe::logging::error("File -> Unified. Unknown shader file extension\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
 
     std::ifstream file(resource_full_path, std::ios::binary | std::ios::ate);
     if (!file.good()) {
         fe::logging::error("File -> Unified. Failed to open shader file\nPath : %s", resource_full_path.string().c_str());
-        return {};
+        return false;
     }
 
     std::streampos file_size{};
@@ -35,27 +460,34 @@ fe::pointer<fe::resource::Shader> fe::ShaderImporter::Import(ResourceStorage& st
     file_size = file.tellg();
     file.seekg(0, std::ios::beg);
 
-    std::string source_code{};
-
     source_code.resize(file_size);
     file.read((char*) &source_code[0], file_size);
 
-    if (resource_full_path.extension() == PATH.getVertexShaderExtension()) {
-        shader.type = Shader::Type::VERTEX;
-    }
-    else if (resource_full_path.extension() == PATH.getFragmentShaderExtension()) {
-        shader.type = Shader::Type::FRAGMENT;
-    }
-    else {
-        fe::logging::error("File -> Unified. Unknown shader file extension\nPath : %s", resource_full_path.string().c_str());
-        return {};
-    }
+    return true;
+}
+
+uint64_t fe::ShaderImporter::cacheKey(std::string_view source_code, Shader::Type type, GraphicsBackend graphics_backend) {
+    uint64_t cache_key = derived_data_key("ShaderImporter", ShaderImporter::VERSION);
+    return hash_combine(cache_key, ShaderCompiler::Hash(source_code, type, graphics_backend));
+}
 
-    const auto& resource_management_context = storage.GetContext();
-    ShaderCompiler::Compile(shader.source_code, source_code, shader.type, resource_management_context.graphics_backend);
+bool fe::ShaderImporter::loadCached(const ResourceManagementContext& context, uint64_t cache_key, ShaderImportResult& result) {
+    std::filesystem::path cache_extension = PATH.getShaderExtension();
 
-    ShaderReflector::Reflect(shader, resource_full_path);
+    if (!DDC.find(cache_key, cache_extension)) return false;
 
-    auto ptr = storage.CreateResource(std::move(shader));
-    return ptr;
+    if (ShaderImporter::loadCooked(context, DDC.entry_path(cache_key, cache_extension), result)) return true;
+
+    DDC.discard(cache_key, cache_extension);
+    return false;
+}
+
+void fe::ShaderImporter::storeCached(const ShaderImportResult& result, GraphicsBackend graphics_backend, uint64_t cache_key) {
+    if (!DDC.is_enabled()) return;
+
+    std::filesystem::path cache_extension = PATH.getShaderExtension();
+
+    if (ShaderImporter::Write(result, graphics_backend, DDC.entry_path(cache_key, cache_extension))) {
+        DDC.store(cache_key, cache_extension);
+    }
 }
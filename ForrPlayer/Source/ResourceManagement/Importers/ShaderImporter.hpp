@@ -11,17 +11,56 @@
 ===============================================*/
 
 #pragma once
+#include <span>
+
 #include "ResourceManagement/ResourceStorage.hpp"
 
 #define SPIRV_REFLECT_USE_SYSTEM_SPIRV_H
 #include "spirv_reflect.h"
 
 namespace fe {
+    // a shader file is loaded as a table of its variants, see ShaderVariants
+    struct ShaderImportResult {
+        std::vector<resource::Shader> variants{}; // by variant key. a file without keywords has only one
+
+        ShaderImportResult()  = default;
+        ~ShaderImportResult() = default;
+
+        FORR_CLASS_NONCOPYABLE(ShaderImportResult)
+        FORR_CLASS_MOVABLE(ShaderImportResult)
+    };
+
     class ShaderImporter {
     public:
+        inline static constexpr uint32_t VERSION = 3; // increase it when reflection is changed, cached shaders are made again
+
         ShaderImporter()  = default;
         ~ShaderImporter() = default;
 
+        // returns the base variant, the other ones are in its 'variants'
         static fe::pointer<resource::Shader> Import(ResourceStorage& storage, const std::filesystem::path& resource_full_path);
+
+        // reads, compiles and reflects every variant of the shader without touching the storage, so it can run on any thread.
+        // cooked shaders ( .forr_shader ) are already compiled and reflected. compiled variant tables are taken from and stored to DDC,
+        // a hit skips both shaderc and SPIRV-Reflect
+        static FORR_NODISCARD bool Load(const ResourceManagementContext& context, const std::filesystem::path& resource_full_path, ShaderImportResult& result);
+
+        // like Load() for every path, but all variants that aren't cooked or cached are compiled together by ShaderCompiler::CompileBatch().
+        // results[i] is loaded from resource_full_paths[i]. returns how many were loaded, failed results have no variants
+        static size_t LoadBatch(const ResourceManagementContext& context, std::span<const std::filesystem::path> resource_full_paths, std::span<ShaderImportResult> results);
+
+        // creates every variant in the storage and links them to the base one. returns the base variant
+        static fe::pointer<resource::Shader> Publish(ResourceStorage& storage, ShaderImportResult& result);
+
+        // writes the variant table with SPIR-V compiled for 'graphics_backend' and reflection to .forr_shader
+        static FORR_NODISCARD bool Write(const ShaderImportResult& result, GraphicsBackend graphics_backend, const std::filesystem::path& resource_full_path);
+
+    private:
+        static FORR_NODISCARD bool loadCooked(const ResourceManagementContext& context, const std::filesystem::path& resource_full_path, ShaderImportResult& result);
+
+        static FORR_NODISCARD bool     readSource(const std::filesystem::path& resource_full_path, std::string& source_code, resource::Shader::Type& type);
+        static FORR_NODISCARD uint64_t cacheKey(std::string_view source_code, resource::Shader::Type type, GraphicsBackend graphics_backend);
+        static FORR_NODISCARD bool     loadCached(const ResourceManagementContext& context, uint64_t cache_key, ShaderImportResult& result);
+        static void                    storeCached(const ShaderImportResult& result, GraphicsBackend graphics_backend, uint64_t cache_key);
     };
 } // namespace fe
@@ -15,54 +15,329 @@
 
 #include "stb_image.h"
 
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <string_view>
+
+#include "Core/block_compression.hpp"
+#include "Core/derived_data_cache.hpp"
+#include "Core/mapped_file.hpp"
+#include "ResourceManagement/TextureLayout.hpp"
+
 using namespace fe::resource;
 
+namespace fe {
+    // .forr_texture is this header and the mip chain right after it
+    struct TextureFileHeader {
+        inline static constexpr uint32_t MAGIC   = 0x58545246; // "FRTX"
+        inline static constexpr uint32_t VERSION = 2;
+
+        uint32_t magic{ MAGIC };
+        uint32_t version{ VERSION };
+
+        uint32_t width{};
+        uint32_t height{};
+        uint32_t components{};
+        uint32_t mip_count{};
+        uint32_t reserved{}; // keeps byte_size aligned without padding
+
+        uint32_t internal_format{};
+        uint32_t data_format{};
+        uint32_t min_filter{};
+        uint32_t mag_filter{};
+        uint32_t wrap_s{};
+        uint32_t wrap_t{};
+        uint32_t target{};
+
+        uint64_t byte_size{};
+    };
+
+    // lowercase ends of names of standalone textures that are colors
+    static constexpr std::string_view G_SRGB_NAME_SUFFIXES[] = { "_albedo", "_basecolor", "_base_color", "_diffuse", "_color", "_emissive", "_srgb" };
+
+    static void freeSTBIImage(unsigned char* bytes) {
+        stbi_image_free(bytes);
+    }
+} // namespace fe
+
 fe::pointer<Texture> fe::TextureImporter::Import(ResourceStorage& storage, const std::filesystem::path& resource_full_path) {
-    int            width{};
-    int            height{};
-    int            components{};
-    unsigned char* bytes{};
+    Texture texture{};
+    if (!TextureImporter::Load(resource_full_path, texture, storage.GetContext().texture_quality_tier)) return {};
+
+    auto ptr = storage.CreateResource(std::move(texture));
+    return ptr;
+}
+
+bool fe::TextureImporter::Load(const std::filesystem::path& resource_full_path, Texture& texture, uint32_t dropped_mips) {
+    if (resource_full_path.extension() == PATH.getTextureExtension()) {
+        return TextureImporter::loadCooked(resource_full_path, texture, dropped_mips);
+    }
+
+    MappedFile file{};
+    if (!file.open(resource_full_path)) return false;
+
+    std::filesystem::path cache_extension = PATH.getTextureExtension();
 
-    bytes = stbi_load(resource_full_path.string().c_str(), &width, &height, &components, 0);
+    const Texture::ColorSpace color_space = TextureImporter::ColorSpaceFromName(resource_full_path);
 
-    if (!bytes) {
-        fe::logging::error("STBI -> Unified. Failed to load a texture\nPath : %s", components, resource_full_path.string().c_str());
-        return {};
+    uint64_t cache_key = hash_bytes(file.data(), file.size(), derived_data_key("TextureImporter", TextureImporter::VERSION));
+    cache_key          = hash_combine(cache_key, static_cast<uint64_t>(color_space));
+
+    if (DDC.find(cache_key, cache_extension)) {
+        if (TextureImporter::loadCooked(DDC.entry_path(cache_key, cache_extension), texture, dropped_mips)) return true;
+        DDC.discard(cache_key, cache_extension);
     }
 
-    Texture::InternalFormat internal_format{};
-    Texture::DataFormat     data_format{};
+    if (!TextureImporter::Decode(file.data(), file.size(), texture)) {
+        fe::logging::error("STBI -> Unified. Failed to load a texture\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
+
+    TextureImporter::SetColorSpace(texture, color_space);
+    TextureImporter::GenerateMips(texture);
+
+    if (DDC.is_enabled() && TextureImporter::Write(texture, DDC.entry_path(cache_key, cache_extension))) {
+        DDC.store(cache_key, cache_extension);
+    }
+
+    TextureImporter::DropTopMips(texture, dropped_mips);
+
+    return true;
+}
+
+bool fe::TextureImporter::Decode(const void* encoded, size_t size, Texture& texture) {
+    int width{};
+    int height{};
+    int components{};
+
+    // 16-bit images are converted to 8 bits
+    unsigned char* bytes = stbi_load_from_memory(static_cast<const stbi_uc*>(encoded), static_cast<int>(size), &width, &height, &components, 0);
+    if (!bytes) return false;
 
     // clang-format off
     switch (components) {
-        case 4: internal_format = Texture::InternalFormat::RGBA8; data_format = Texture::DataFormat::RGBA; break;
-        case 3: internal_format = Texture::InternalFormat::RGB8 ; data_format = Texture::DataFormat::RGB ; break;
-        case 2: internal_format = Texture::InternalFormat::RG8  ; data_format = Texture::DataFormat::RG  ; break;
-        case 1: internal_format = Texture::InternalFormat::R8   ; data_format = Texture::DataFormat::RED ; break;
+        case 4: texture.internal_format = Texture::InternalFormat::RGBA8; texture.data_format = Texture::DataFormat::RGBA; break;
+        case 3: texture.internal_format = Texture::InternalFormat::RGB8 ; texture.data_format = Texture::DataFormat::RGB ; break;
+        case 2: texture.internal_format = Texture::InternalFormat::RG8  ; texture.data_format = Texture::DataFormat::RG  ; break;
+        case 1: texture.internal_format = Texture::InternalFormat::R8   ; texture.data_format = Texture::DataFormat::RED ; break;
         default:
-            fe::logging::error("STBI -> Unified. Failed to load a texture. Unsupported number of components %i. Using RGBA8 for internal format and RGBA for data format as default\nPath : %s", 
-                components, resource_full_path.string().c_str());
+            fe::logging::error("STBI -> Unified. Unsupported number of components %i", components);
+            stbi_image_free(bytes);
+            return false;
+    }
+    // clang-format on
+
+    texture.width      = width;
+    texture.height     = height;
+    texture.components = static_cast<uint8_t>(components);
+    texture.mip_count  = 1;
+
+    // stbi's buffer is kept as it is, it's freed by stbi_image_free()
+    size_t buffer_size = static_cast<size_t>(width) * height * components;
+    texture.bytes      = fe::adopt_tagged_unique_array<unsigned char, MemoryTag::Textures>(bytes, buffer_size, &freeSTBIImage);
+
+    return true;
+}
+
+Texture::ColorSpace fe::TextureImporter::ColorSpaceFromName(const std::filesystem::path& resource_full_path) {
+    std::string stem = resource_full_path.stem().string();
+    std::ranges::transform(stem, stem.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    for (std::string_view suffix : G_SRGB_NAME_SUFFIXES) {
+        if (stem.ends_with(suffix)) return Texture::ColorSpace::SRGB;
+    }
+    return Texture::ColorSpace::LINEAR;
+}
+
+void fe::TextureImporter::SetColorSpace(Texture& texture, Texture::ColorSpace color_space) {
+    const bool srgb = color_space == Texture::ColorSpace::SRGB;
+
+    // clang-format off
+    switch (texture.internal_format) {
+        case Texture::InternalFormat::RGBA8:
+        case Texture::InternalFormat::SRGB8_ALPHA8: texture.internal_format = srgb ? Texture::InternalFormat::SRGB8_ALPHA8 : Texture::InternalFormat::RGBA8; break;
+        case Texture::InternalFormat::RGB8:
+        case Texture::InternalFormat::SRGB8       : texture.internal_format = srgb ? Texture::InternalFormat::SRGB8 : Texture::InternalFormat::RGB8; break;
+        default: break; // one and two channels are data, compressed textures keep their formats
+    }
+    // clang-format on
+}
+
+bool fe::TextureImporter::Write(const Texture& texture, const std::filesystem::path& resource_full_path) {
+    TextureFileHeader header{};
+    header.width           = texture.width;
+    header.height          = texture.height;
+    header.components      = texture.components;
+    header.mip_count       = texture.mip_count;
+    header.internal_format = static_cast<uint32_t>(texture.internal_format);
+    header.data_format     = static_cast<uint32_t>(texture.data_format);
+    header.min_filter      = static_cast<uint32_t>(texture.min_filter);
+    header.mag_filter      = static_cast<uint32_t>(texture.mag_filter);
+    header.wrap_s          = static_cast<uint32_t>(texture.wrap_s);
+    header.wrap_t          = static_cast<uint32_t>(texture.wrap_t);
+    header.target          = static_cast<uint32_t>(texture.target);
+    header.byte_size       = texture_byte_size(texture);
+
+    if (!texture.bytes && header.byte_size != 0) {
+        fe::logging::error("Failed to write a cooked texture. It has no bytes\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
 
-            internal_format = Texture::InternalFormat::RGBA8;
-            data_format = Texture::DataFormat::RGBA;
+    std::filesystem::path temporary_path = DerivedDataCache::temporary_path(resource_full_path);
+
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(texture.bytes.get()), static_cast<std::streamsize>(header.byte_size));
+
+        if (!file.good()) {
+            fe::logging::error("File -> Unified. Failed to write a cooked texture\nPath : %s", temporary_path.string().c_str());
+            return false;
+        }
+    }
+
+    std::error_code error_code{};
+    std::filesystem::rename(temporary_path, resource_full_path, error_code);
+    if (error_code) {
+        fe::logging::error("File -> Unified. Failed to replace a cooked texture. %s\nPath : %s", error_code.message().c_str(), resource_full_path.string().c_str());
+        std::filesystem::remove(temporary_path, error_code);
+        return false;
+    }
+
+    return true;
+}
+
+void fe::TextureImporter::GenerateMips(Texture& texture) {
+    if (!texture.bytes || texture.mip_count != 1 || is_block_compressed(texture.internal_format)) return;
+
+    uint32_t count = mip_count(texture.width, texture.height);
+    if (count == 1) return;
+
+    size_t top_size = mip_chain_size(texture.width, texture.height, texture.components, 1);
+
+    auto chain = fe::make_tagged_unique_array<unsigned char, MemoryTag::Textures>(mip_chain_size(texture.width, texture.height, texture.components, count));
+    memcpy(chain.get(), texture.bytes.get(), top_size);
+
+    generate_mips(chain.get(), texture.width, texture.height, texture.components, count, is_srgb(texture.internal_format));
+
+    texture.bytes     = std::move(chain);
+    texture.mip_count = count;
+}
+
+void fe::TextureImporter::Compress(Texture& texture, TextureCompression compression) {
+    if (!texture.bytes || compression == TextureCompression::NONE || is_block_compressed(texture.internal_format)) return;
+
+    const bool srgb = is_srgb(texture.internal_format);
+
+    BlockFormat             block_format{};
+    Texture::InternalFormat internal_format{};
+
+    // clang-format off
+    switch (texture.components) {
+        case 1: block_format = BlockFormat::BC4; internal_format = Texture::InternalFormat::BC4_RED; break;
+        case 2: block_format = BlockFormat::BC5; internal_format = Texture::InternalFormat::BC5_RG ; break;
+        case 3: block_format = BlockFormat::BC1; internal_format = srgb ? Texture::InternalFormat::BC1_SRGB : Texture::InternalFormat::BC1_RGB; break;
+        case 4:
+            if (compression == TextureCompression::QUALITY) {
+                block_format = BlockFormat::BC7; internal_format = srgb ? Texture::InternalFormat::BC7_SRGB_ALPHA : Texture::InternalFormat::BC7_RGBA;
+            }
+            else {
+                block_format = BlockFormat::BC3; internal_format = srgb ? Texture::InternalFormat::BC3_SRGB_ALPHA : Texture::InternalFormat::BC3_RGBA;
+            }
+            break;
+        default: return;
     }
     // clang-format on
 
-    fe::resource::Texture texture{};
-    texture.width           = width;
-    texture.height          = height;
-    texture.components      = components;
+    MipFormat mip_format = texture_mip_format(internal_format, texture.components);
+
+    auto blocks = fe::make_tagged_unique_array<unsigned char, MemoryTag::Textures>(mip_chain_size(texture.width, texture.height, mip_format, texture.mip_count));
+
+    for (uint32_t level = 0; level < texture.mip_count; level++) {
+        MipLevel source      = texture_mip_level(texture, level);
+        MipLevel destination = mip_level(texture.width, texture.height, mip_format, level);
+
+        compress_blocks(texture.bytes.get() + source.offset, source.width, source.height, texture.components, block_format, blocks.get() + destination.offset);
+    }
+
+    texture.bytes           = std::move(blocks);
     texture.internal_format = internal_format;
-    texture.data_format     = data_format;
+}
 
-    size_t buffer_size = width * height * components;
-    texture.bytes      = std::make_unique<unsigned char[]>(buffer_size);
+void fe::TextureImporter::DropTopMips(Texture& texture, uint32_t count) {
+    count = TextureImporter::droppableMips(texture.width, texture.height, texture.mip_count, count);
+    if (!texture.bytes || count == 0) return;
 
-    // bytes are already checked that it is not nullptr
-    std::copy(bytes, bytes + buffer_size, texture.bytes.get());
+    MipLevel top        = texture_mip_level(texture, count);
+    size_t   chain_size = texture_byte_size(texture);
 
-    stbi_image_free(bytes); // can be freed after copying
+    auto chain = fe::make_tagged_unique_array<unsigned char, MemoryTag::Textures>(chain_size - top.offset);
+    memcpy(chain.get(), texture.bytes.get() + top.offset, chain_size - top.offset);
 
-    auto ptr = storage.CreateResource(std::move(texture));
-    return ptr;
+    texture.bytes      = std::move(chain);
+    texture.width      = top.width;
+    texture.height     = top.height;
+    texture.mip_count -= count;
+}
+
+uint32_t fe::TextureImporter::droppableMips(uint32_t width, uint32_t height, uint32_t mip_count, uint32_t count) {
+    uint32_t dropped = 0;
+
+    while (dropped < count && dropped + 1 < mip_count) {
+        uint32_t next = dropped + 1;
+        if (std::max(mip_extent(width, next), mip_extent(height, next)) < TextureImporter::MIN_DROPPED_SIZE) break;
+
+        dropped = next;
+    }
+
+    return dropped;
+}
+
+bool fe::TextureImporter::loadCooked(const std::filesystem::path& resource_full_path, Texture& texture, uint32_t dropped_mips) {
+    MappedFile file{};
+    if (!file.open(resource_full_path)) return false;
+
+    TextureFileHeader header{};
+    if (file.size() < sizeof(header)) {
+        fe::logging::error("File -> Unified. Failed to load a cooked texture. The file is too small\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
+    memcpy(&header, file.data(), sizeof(header));
+
+    if (header.magic != TextureFileHeader::MAGIC || header.version != TextureFileHeader::VERSION) {
+        fe::logging::error("File -> Unified. Failed to load a cooked texture. The file is outdated or it's not .forr_texture, cook it again\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
+
+    bool mips_valid = header.mip_count >= 1 && header.mip_count <= mip_count(header.width, header.height);
+
+    MipFormat mip_format = texture_mip_format(static_cast<Texture::InternalFormat>(header.internal_format), header.components);
+
+    uint64_t expected_size = mips_valid ? mip_chain_size(header.width, header.height, mip_format, header.mip_count) : 0;
+    if (!mips_valid || header.byte_size != expected_size || header.byte_size > file.size() - sizeof(header)) {
+        fe::logging::error("File -> Unified. Failed to load a cooked texture. The file is broken\nPath : %s", resource_full_path.string().c_str());
+        return false;
+    }
+
+    // the dropped mips are never read from the mapping
+    uint32_t dropped = TextureImporter::droppableMips(header.width, header.height, header.mip_count, dropped_mips);
+    MipLevel top     = mip_level(header.width, header.height, mip_format, dropped);
+
+    texture.width           = top.width;
+    texture.height          = top.height;
+    texture.mip_count       = header.mip_count - dropped;
+    texture.components      = static_cast<uint8_t>(header.components);
+    texture.internal_format = static_cast<Texture::InternalFormat>(header.internal_format);
+    texture.data_format     = static_cast<Texture::DataFormat>(header.data_format);
+    texture.min_filter      = static_cast<Texture::MinFilter>(header.min_filter);
+    texture.mag_filter      = static_cast<Texture::MagFilter>(header.mag_filter);
+    texture.wrap_s          = static_cast<Texture::Wrap>(header.wrap_s);
+    texture.wrap_t          = static_cast<Texture::Wrap>(header.wrap_t);
+    texture.target          = static_cast<Texture::Target>(header.target);
+
+    texture.bytes = fe::make_tagged_unique_array<unsigned char, MemoryTag::Textures>(header.byte_size - top.offset);
+    memcpy(texture.bytes.get(), file.data() + sizeof(header) + top.offset, header.byte_size - top.offset);
+
+    return true;
 }
@@ -12,13 +12,54 @@
 
 #pragma once
 #include "ResourceManagement/ResourceStorage.hpp"
+#include "ResourceManagement/ResourceCooker.hpp"
 
 namespace fe {
     class TextureImporter {
     public:
+        inline static constexpr uint32_t VERSION = 2; // increase it when decoding is changed, cached textures are decoded again
+
+        inline static constexpr uint32_t MIN_DROPPED_SIZE = 256; // quality tiers don't make the top mip smaller than this
+
         TextureImporter()  = default;
         ~TextureImporter() = default;
 
         static fe::pointer<resource::Texture> Import(ResourceStorage& storage, const std::filesystem::path& resource_full_path);
+
+        // reads and decodes the file without touching the storage, so it can run on any thread.
+        // cooked textures ( .forr_texture ) are read without decoding. decoded textures are taken from and stored to DDC with the full mip chain.
+        // 'dropped_mips' top mips aren't kept, a cooked texture doesn't even read them
+        static FORR_NODISCARD bool Load(const std::filesystem::path& resource_full_path, resource::Texture& texture, uint32_t dropped_mips = 0);
+
+        // decodes PNG, JPG, ... from memory to the top mip. only the pixel format and the size of 'texture' are set, it's linear.
+        // it's thread-safe, importers decode their images in parallel with it
+        static FORR_NODISCARD bool Decode(const void* encoded, size_t size, resource::Texture& texture);
+
+        // the color space of a standalone texture by the end of its name : "_albedo", "_basecolor", "_diffuse", "_color", "_emissive", "_srgb".
+        // the rest are data ( normals, roughness, masks, ... ) and linear
+        FORR_NODISCARD static resource::Texture::ColorSpace ColorSpaceFromName(const std::filesystem::path& resource_full_path);
+
+        // switches a decoded RGB or RGBA texture between sRGB and linear formats, the others are always linear.
+        // GenerateMips() and Compress() depend on it, so it goes before them
+        static void SetColorSpace(resource::Texture& texture, resource::Texture::ColorSpace color_space);
+
+        // writes decoded pixels of every mip and sampler settings to .forr_texture
+        static FORR_NODISCARD bool Write(const resource::Texture& texture, const std::filesystem::path& resource_full_path);
+
+        // 'texture' has only the top mip, the full chain is made on the CPU. sRGB textures are filtered in linear space
+        static void GenerateMips(resource::Texture& texture);
+
+        // every mip to BC blocks, chosen by the components and the color space : R - BC4, RG - BC5, RGB - BC1, RGBA - BC3 or BC7.
+        // sRGB textures ( see SetColorSpace() ) get the _SRGB variants
+        static void Compress(resource::Texture& texture, TextureCompression compression);
+
+        // keeps the chain from the 'count' mip. it stops at MIN_DROPPED_SIZE
+        static void DropTopMips(resource::Texture& texture, uint32_t count);
+
+    private:
+        static FORR_NODISCARD bool loadCooked(const std::filesystem::path& resource_full_path, resource::Texture& texture, uint32_t dropped_mips);
+
+        // how many of 'count' top mips can go
+        static FORR_NODISCARD uint32_t droppableMips(uint32_t width, uint32_t height, uint32_t mip_count, uint32_t count);
     };
 } // namespace fe
@@ -0,0 +1,399 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ResourceCooker.cpp
+    Role : offline conversion of resources to runtime formats
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "ResourceManagement/ResourceCooker.hpp"
+
+#include "Core/hash.hpp"
+
+#include "Importers/TextureImporter.hpp"
+#include "Importers/GLTFImporter.hpp"
+#include "Importers/ShaderImporter.hpp"
+#include "Importers/ModelImporter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+namespace fe {
+    static constexpr GraphicsBackend G_COOKED_SHADER_BACKENDS[] = { GraphicsBackend::OpenGL, GraphicsBackend::Vulkan };
+
+    static const char* G_MANIFEST_FILE_NAME = "manifest.forr_cook";
+
+    using CookClock = std::chrono::steady_clock;
+
+    static double millisecondsSince(CookClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(CookClock::now() - start).count();
+    }
+
+    static bool isShaderExtension(const std::filesystem::path& extension) {
+        return extension == PATH.getVertexShaderExtension() || extension == PATH.getFragmentShaderExtension();
+    }
+
+    static bool isCookable(const std::filesystem::path& extension) {
+        return extension == ".png" || extension == ".gltf" || extension == ".glb" || isShaderExtension(extension);
+    }
+
+    static const char* graphicsBackendName(GraphicsBackend graphics_backend) {
+        switch (graphics_backend) {
+            case GraphicsBackend::OpenGL: return "opengl";
+            case GraphicsBackend::Vulkan: return "vulkan";
+        }
+        return "unknown";
+    }
+
+    // the result of cooking one resource, merged into the manifest on the main thread
+    struct CookResult {
+        enum class Status {
+            COOKED,
+            UP_TO_DATE,
+            FAILED
+        };
+
+        Status status{ Status::FAILED };
+
+        uint64_t                 hash{};
+        std::vector<std::string> dependencies{};
+
+        CookResult()  = default;
+        ~CookResult() = default;
+    };
+} // namespace fe
+
+fe::ResourceCooker::ResourceCooker(const ResourceCookerDesc& desc)
+    : m_Force(desc.force), m_TextureCompression(desc.texture_compression), m_VertexAttributes(desc.vertex_attributes), m_LodSettings(desc.lod_settings) {
+
+    if (desc.args.empty()) {
+        fe::logging::error("Failed to initialize ResourceCooker. There were no arguments. args[0] is required to find the assets folder");
+        return;
+    }
+
+    PATH.init(desc.args[0], true);
+    JOBS.init(desc.job_system_desc);
+}
+
+fe::ResourceCooker::~ResourceCooker() {
+    JOBS.shutdown();
+}
+
+fe::ResourceCookerStats fe::ResourceCooker::Cook() {
+    ResourceCookerStats stats{};
+
+    auto cook_start = CookClock::now();
+
+    const std::filesystem::path& assets_path = PATH.getAssetsPath();
+    const std::filesystem::path  cooked_path = PATH.getCookedAssetsPath();
+
+    std::vector<std::filesystem::path> sources{};
+
+    std::error_code error_code{};
+    for (auto it = std::filesystem::recursive_directory_iterator(assets_path, error_code); !error_code && it != std::filesystem::recursive_directory_iterator(); it.increment(error_code)) {
+        if (it->is_directory() && it->path() == cooked_path) {
+            it.disable_recursion_pending(); // don't cook the cooked files
+            continue;
+        }
+
+        if (it->is_regular_file() && isCookable(it->path().extension())) sources.emplace_back(it->path());
+    }
+
+    if (error_code) {
+        fe::logging::error("File -> Unified. Failed to walk the assets folder. %s\nPath : %s", error_code.message().c_str(), assets_path.string().c_str());
+        return stats;
+    }
+
+    std::sort(sources.begin(), sources.end()); // the manifest and the log don't depend on the order of the file system
+
+    this->loadManifest();
+
+    std::vector<CookResult> results(sources.size());
+
+    // one resource per job, glTF files are much heavier than textures
+    JOBS.parallel_for(0, sources.size(), 1, [&](size_t index) {
+        const std::filesystem::path& source   = sources[index];
+        CookResult&                  result   = results[index];
+        std::string                  relative = source.lexically_relative(assets_path).generic_string();
+
+        if (this->isUpToDate(source, relative)) {
+            result.status = CookResult::Status::UP_TO_DATE;
+            return;
+        }
+
+        auto start = CookClock::now();
+
+        std::vector<std::filesystem::path> dependencies{};
+        if (!this->cookResource(source, dependencies)) {
+            fe::logging::warning("Failed to cook a resource\nPath : %s", source.string().c_str());
+            return;
+        }
+
+        for (const std::filesystem::path& dependency : dependencies) {
+            result.dependencies.emplace_back(dependency.lexically_normal().lexically_relative(assets_path).generic_string());
+        }
+
+        if (!this->hashInputs(source, result.dependencies, result.hash)) {
+            fe::logging::warning("Failed to hash a cooked resource. It will be cooked again next time\nPath : %s", source.string().c_str());
+            result.hash = 0;
+        }
+
+        result.status = CookResult::Status::COOKED;
+
+        fe::logging::info("Cooked a resource in %.2f ms\nPath : %s", millisecondsSince(start), source.string().c_str());
+    });
+
+    // entries of deleted resources are dropped. failed resources keep no entry, so they are tried again next time
+    std::unordered_map<std::string, ManifestEntry> manifest{};
+
+    for (size_t i = 0; i < sources.size(); i++) {
+        std::string relative = sources[i].lexically_relative(assets_path).generic_string();
+        CookResult& result   = results[i];
+
+        switch (result.status) {
+            case CookResult::Status::COOKED: {
+                ManifestEntry& entry = manifest[relative];
+                entry.hash           = result.hash;
+                entry.dependencies   = std::move(result.dependencies);
+
+                stats.cooked++;
+                break;
+            }
+            case CookResult::Status::UP_TO_DATE: {
+                manifest[relative] = std::move(m_Manifest[relative]);
+
+                stats.up_to_date++;
+                break;
+            }
+            case CookResult::Status::FAILED: {
+                stats.failed++;
+                break;
+            }
+        }
+    }
+
+    m_Manifest = std::move(manifest);
+    this->saveManifest();
+
+    stats.milliseconds = millisecondsSince(cook_start);
+
+    fe::logging::info("Cooking finished in %.2f ms on %zu workers. Cooked : %zu, Up to date : %zu, Failed : %zu",
+                      stats.milliseconds, JOBS.worker_count(), stats.cooked, stats.up_to_date, stats.failed);
+
+    return stats;
+}
+
+std::filesystem::path fe::ResourceCooker::GetCookedPath(const std::filesystem::path& resource_full_path, GraphicsBackend graphics_backend) {
+    std::filesystem::path extension = resource_full_path.extension();
+    if (!isCookable(extension)) return {};
+
+    std::filesystem::path relative = resource_full_path.lexically_normal().lexically_relative(PATH.getAssetsPath().lexically_normal());
+    if (relative.empty() || *relative.begin() == "..") return {};
+
+    std::filesystem::path cooked = PATH.getCookedAssetsPath() / relative;
+
+    // the original extension is kept, so "a.vert" and "a.frag" don't collide
+    if (extension == ".png") {
+        cooked += PATH.getTextureExtension();
+    }
+    else if (extension == ".gltf" || extension == ".glb") {
+        cooked += PATH.getModelExtension();
+    }
+    else {
+        cooked += ".";
+        cooked += graphicsBackendName(graphics_backend); // SPIR-V is compiled differently for every backend
+        cooked += PATH.getShaderExtension();
+    }
+
+    return cooked;
+}
+
+std::unordered_map<std::string, std::vector<std::string>> fe::ResourceCooker::ReadDependencies() {
+    std::unordered_map<std::string, ManifestEntry> manifest{};
+    readManifest(manifest);
+
+    std::unordered_map<std::string, std::vector<std::string>> dependencies{};
+    for (auto& [relative, entry] : manifest) dependencies.emplace(relative, std::move(entry.dependencies));
+
+    return dependencies;
+}
+
+void fe::ResourceCooker::readManifest(std::unordered_map<std::string, ManifestEntry>& manifest) {
+    manifest.clear();
+
+    std::filesystem::path manifest_path = PATH.getCookedAssetsPath() / G_MANIFEST_FILE_NAME;
+
+    std::ifstream file(manifest_path);
+    if (!file.good()) return; // nothing is cooked yet
+
+    // every line : <hash> \t <resource> [ \t <dependency> ]...
+    std::string line{};
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields{};
+
+        std::stringstream stream(line);
+        std::string       field{};
+        while (std::getline(stream, field, '\t')) fields.emplace_back(std::move(field));
+
+        ManifestEntry entry{};
+        if (fields.size() < 2 || !hash_from_string(fields[0], entry.hash)) {
+            fe::logging::warning("Cook manifest has an invalid line. It's ignored\nPath : %s", manifest_path.string().c_str());
+            continue;
+        }
+
+        entry.dependencies.assign(std::make_move_iterator(fields.begin() + 2), std::make_move_iterator(fields.end()));
+
+        manifest[std::move(fields[1])] = std::move(entry);
+    }
+}
+
+void fe::ResourceCooker::loadManifest() {
+    readManifest(m_Manifest);
+}
+
+void fe::ResourceCooker::saveManifest() const {
+    std::filesystem::path manifest_path = PATH.getCookedAssetsPath() / G_MANIFEST_FILE_NAME;
+    std::filesystem::path temporary     = manifest_path;
+    temporary += ".tmp";
+
+    std::error_code error_code{};
+    std::filesystem::create_directories(manifest_path.parent_path(), error_code);
+
+    // sorted, so the manifest can be compared between builds
+    std::vector<const std::pair<const std::string, ManifestEntry>*> entries{};
+    entries.reserve(m_Manifest.size());
+    for (const auto& entry : m_Manifest) entries.emplace_back(&entry);
+
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file.good()) {
+            fe::logging::error("File -> Unified. Failed to write the cook manifest\nPath : %s", temporary.string().c_str());
+            return;
+        }
+
+        for (const auto* entry : entries) {
+            file << hash_to_string(entry->second.hash) << '\t' << entry->first;
+            for (const std::string& dependency : entry->second.dependencies) file << '\t' << dependency;
+            file << '\n';
+        }
+
+        if (!file.good()) {
+            fe::logging::error("File -> Unified. Failed to write the cook manifest\nPath : %s", temporary.string().c_str());
+            file.close();
+            std::filesystem::remove(temporary, error_code);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary, manifest_path, error_code);
+    if (error_code) {
+        fe::logging::error("File -> Unified. Failed to replace the cook manifest. %s\nPath : %s", error_code.message().c_str(), manifest_path.string().c_str());
+        std::filesystem::remove(temporary, error_code);
+    }
+}
+
+bool fe::ResourceCooker::isUpToDate(const std::filesystem::path& resource_full_path, const std::string& relative_path) const {
+    if (m_Force) return false;
+
+    auto it = m_Manifest.find(relative_path);
+    if (it == m_Manifest.end() || it->second.hash == 0) return false;
+
+    // cooked files could be deleted by hand
+    if (isShaderExtension(resource_full_path.extension())) {
+        for (GraphicsBackend graphics_backend : G_COOKED_SHADER_BACKENDS) {
+            if (!std::filesystem::exists(GetCookedPath(resource_full_path, graphics_backend))) return false;
+        }
+    }
+    else if (!std::filesystem::exists(GetCookedPath(resource_full_path, GraphicsBackend{}))) {
+        return false;
+    }
+
+    uint64_t hash{};
+    if (!hashInputs(resource_full_path, it->second.dependencies, hash)) return false;
+
+    return hash == it->second.hash;
+}
+
+bool fe::ResourceCooker::cookResource(const std::filesystem::path& resource_full_path, std::vector<std::filesystem::path>& dependencies) const {
+    std::filesystem::path extension = resource_full_path.extension();
+
+    std::error_code error_code{};
+    std::filesystem::create_directories(GetCookedPath(resource_full_path, GraphicsBackend{}).parent_path(), error_code);
+    if (error_code) {
+        fe::logging::error("File -> Unified. Failed to create a folder for cooked files. %s\nPath : %s", error_code.message().c_str(), resource_full_path.string().c_str());
+        return false;
+    }
+
+    if (extension == ".png") {
+        resource::Texture texture{};
+        if (!TextureImporter::Load(resource_full_path, texture)) return false;
+
+        TextureImporter::Compress(texture, m_TextureCompression);
+
+        return TextureImporter::Write(texture, GetCookedPath(resource_full_path, GraphicsBackend{}));
+    }
+
+    if (extension == ".gltf" || extension == ".glb") {
+        GLTFImportResult result{}; // only the geometry is cooked, images aren't decoded
+        if (!GLTFImporter::Load(resource_full_path, result, 0, m_VertexAttributes, m_LodSettings, false)) return false;
+
+        // external buffers and images change the cooked model without changing the .gltf
+        auto add_dependency = [&](const std::string& uri) {
+            if (uri.empty() || uri.rfind("data:", 0) == 0) return; // embedded
+            dependencies.emplace_back(resource_full_path.parent_path() / uri);
+        };
+
+        for (const tinygltf::Buffer& buffer : result.source.buffers) add_dependency(buffer.uri);
+        for (const tinygltf::Image& image : result.source.images) add_dependency(image.uri);
+
+        return ModelImporter::Write(result.model, GetCookedPath(resource_full_path, GraphicsBackend{}));
+    }
+
+    if (isShaderExtension(extension)) {
+        for (GraphicsBackend graphics_backend : G_COOKED_SHADER_BACKENDS) {
+            ResourceManagementContext context{};
+            context.graphics_backend = graphics_backend;
+
+            ShaderImportResult result{}; // every variant goes to the same file
+            if (!ShaderImporter::Load(context, resource_full_path, result)) return false;
+
+            if (!ShaderImporter::Write(result, graphics_backend, GetCookedPath(resource_full_path, graphics_backend))) return false;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool fe::ResourceCooker::hashInputs(const std::filesystem::path& resource_full_path, const std::vector<std::string>& dependencies, uint64_t& hash) const {
+    uint64_t seed = VERSION;
+    if (resource_full_path.extension() == ".png") seed = hash_combine(seed, static_cast<uint64_t>(m_TextureCompression));
+    if (resource_full_path.extension() == ".gltf" || resource_full_path.extension() == ".glb") {
+        seed = hash_combine(seed, static_cast<uint64_t>(m_VertexAttributes));
+        seed = m_LodSettings.hash(seed);
+    }
+
+    if (!hash_file(resource_full_path, hash, seed)) return false;
+
+    for (const std::string& dependency : dependencies) {
+        uint64_t dependency_hash{}; // missing dependencies are hashed too, so the resource is cooked again when they appear
+        if (!hash_file(PATH.getAssetsPath() / dependency, dependency_hash)) dependency_hash = 0;
+
+        hash = hash_combine(hash, hash_string(dependency));
+        hash = hash_combine(hash, dependency_hash);
+    }
+
+    // zero means "not hashed" in the manifest
+    if (hash == 0) hash = 1;
+
+    return true;
+}
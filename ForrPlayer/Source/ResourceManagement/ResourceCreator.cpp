@@ -18,13 +18,17 @@
 void fe::ResourceCreator::CreateDefaultResources() {
     this->createDefaultShaders();
     this->createDefaultMaterials();
+    this->createFallbackResources();
 }
 
 void fe::ResourceCreator::createDefaultShaders() {
     std::filesystem::path gltf_shaders_path = PATH.getDefaultShadersPath() / L"gLTF" / L"shader";
 
-    m_Context.default_gltf_vertex_shader_ptr   = m_Importer.ImportResource<resource::Shader>(gltf_shaders_path.wstring() + PATH.getVertexShaderExtension().wstring());
-    m_Context.default_gltf_fragment_shader_ptr = m_Importer.ImportResource<resource::Shader>(gltf_shaders_path.wstring() + PATH.getFragmentShaderExtension().wstring());
+    auto shaders = m_Importer.ImportShaders({ gltf_shaders_path.wstring() + PATH.getVertexShaderExtension().wstring(),
+                                              gltf_shaders_path.wstring() + PATH.getFragmentShaderExtension().wstring() });
+
+    m_Context.default_gltf_vertex_shader_ptr   = shaders[0];
+    m_Context.default_gltf_fragment_shader_ptr = shaders[1];
 }
 
 void fe::ResourceCreator::createDefaultMaterials() {
@@ -39,3 +43,20 @@ void fe::ResourceCreator::createDefaultMaterials() {
 
     m_Context.default_gltf_material_ptr = m_Storage.CreateResource(std::move(gltf_material));
 }
+
+void fe::ResourceCreator::createFallbackResources() {
+    resource::Texture texture{};
+    texture.components      = 4;
+    texture.width           = 1;
+    texture.height          = 1;
+    texture.min_filter      = resource::Texture::MinFilter::NEAREST;
+    texture.mag_filter      = resource::Texture::MagFilter::NEAREST;
+    texture.internal_format = resource::Texture::InternalFormat::RGBA8;
+    texture.data_format     = resource::Texture::DataFormat::RGBA;
+
+    texture.bytes = fe::make_tagged_unique_array<unsigned char, MemoryTag::Textures>(4);
+    std::fill_n(texture.bytes.get(), 4, static_cast<unsigned char>(128)); // gray
+
+    m_Context.fallback_texture_ptr = m_Storage.CreateResource(std::move(texture));
+    m_Context.fallback_model_ptr   = m_Storage.CreateResource(resource::Model{});
+}
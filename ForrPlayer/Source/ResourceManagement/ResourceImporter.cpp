@@ -12,41 +12,615 @@
 
 #include "pch.hpp"
 #include "ResourceManagement/ResourceImporter.hpp"
+#include "ResourceManagement/ResourceCooker.hpp"
 
 #include "Importers/TextureImporter.hpp"
 #include "Importers/GLTFImporter.hpp"
 #include "Importers/ShaderImporter.hpp"
 #include "Importers/MaterialImporter.hpp"
+#include "Importers/ModelImporter.hpp"
 
-#define IMPORTER_INSTANCE(T, T_IMPORTER)                                                                   \
-    template <>                                                                                            \
-    fe::pointer<T> fe::ResourceImporter::ImportResource(const std::filesystem::path& resource_full_path) { \
-        return T_IMPORTER::Import(m_Storage, resource_full_path);                                          \
-    }                                                                                                      \
+#include <algorithm>
+#include <chrono>
+#include <variant>
+
+#define IMPORTER_INSTANCE(T, T_IMPORTER)                                                                                         \
+    template <>                                                                                                                  \
+    fe::pointer<T> fe::ResourceImporter::ImportResource(const std::filesystem::path& resource_full_path) {                       \
+        return this->registerImport(resource_full_path, T_IMPORTER::Import(m_Storage, this->resolvePath(resource_full_path)));  \
+    }                                                                                                                            \
     template fe::pointer<T> fe::ResourceImporter::ImportResource(const std::filesystem::path& resource_full_path);
 
-void fe::ResourceImporter::ImportResource(const std::filesystem::path& resource_full_path) {
-    std::filesystem::path extension = resource_full_path.extension();
+namespace fe {
+    // a resource that is loaded on a worker and waits to be published to the storage
+    struct StagedResource {
+        std::variant<std::monostate, resource::Texture, resource::Model, GLTFImportResult, ShaderImportResult> value{};
+
+        bool   loaded_on_worker{}; // false for resources that are imported while publishing
+        double load_milliseconds{};
+
+        StagedResource()  = default;
+        ~StagedResource() = default;
+    };
+
+    using ImportClock = std::chrono::steady_clock;
+
+    static double millisecondsSince(ImportClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(ImportClock::now() - start).count();
+    }
+
+    // the same file can be written as 'a/../b.png' or 'b.png', the watcher and the importer have to agree
+    static std::string importKey(const std::filesystem::path& source_full_path) {
+        return source_full_path.lexically_normal().generic_string();
+    }
+
+    // the expensive part of an import, it doesn't touch the storage. 'resource_full_path' is resolved already
+    static void loadStaged(const ResourceManagementContext& context, const std::filesystem::path& resource_full_path, StagedResource& resource) {
+        auto start = ImportClock::now();
+
+        std::filesystem::path extension = resource_full_path.extension();
+
+        resource.loaded_on_worker = true;
+
+        if (extension == ".png" || extension == PATH.getTextureExtension()) {
+            resource::Texture texture{};
+            if (TextureImporter::Load(resource_full_path, texture, context.texture_quality_tier)) resource.value = std::move(texture);
+        }
+        else if (extension == ".gltf" || extension == ".glb") {
+            GLTFImportResult result{};
+            if (GLTFImporter::Load(resource_full_path, result, context.texture_quality_tier, context.vertex_attributes, context.lod_settings)) resource.value = std::move(result);
+        }
+        else if (extension == PATH.getModelExtension()) {
+            resource::Model model{};
+            if (ModelImporter::Load(context, resource_full_path, model)) resource.value = std::move(model);
+        }
+        else if (extension == PATH.getVertexShaderExtension() || extension == PATH.getFragmentShaderExtension() || extension == PATH.getShaderExtension()) {
+            ShaderImportResult result{};
+            if (ShaderImporter::Load(context, resource_full_path, result)) resource.value = std::move(result);
+        }
+        else {
+            resource.loaded_on_worker = false; // other resources are cheap and imported while publishing
+        }
+
+        resource.load_milliseconds = millisecondsSince(start);
+    }
+
+    // one texture of a glTF file, an evicted one that is restored
+    static void loadStagedGLTFTexture(const ResourceManagementContext& context, const std::filesystem::path& source_full_path, uint32_t texture_index, StagedResource& resource) {
+        auto start = ImportClock::now();
+
+        resource.loaded_on_worker = true;
+
+        resource::Texture texture{};
+        if (GLTFImporter::LoadTexture(source_full_path, texture_index, texture, context.texture_quality_tier)) resource.value = std::move(texture);
+
+        resource.load_milliseconds = millisecondsSince(start);
+    }
+} // namespace fe
+
+struct fe::ResourceImporter::PendingReload {
+    std::filesystem::path source_full_path{};
+    ImportedResource      target{}; // the resource whose slot gets the new data
+    bool                  restore{}; // the file didn't change, the resource was evicted
+    int                   gltf_texture_index{ -1 }; // only this texture of the glTF file is loaded
+
+    StagedResource staged{};
+    JobCounter     counter{};
+};
+
+fe::ResourceImporter::ResourceImporter(ResourceManagementContext& context, ResourceStorage& storage)
+    : m_Context(context), m_Storage(storage), m_CookedDependencies(ResourceCooker::ReadDependencies()) {}
+
+fe::ResourceImporter::~ResourceImporter() {
+    // the jobs write to the pending reloads
+    for (auto& reload : m_PendingReloads) {
+        if (!reload->counter.is_done()) JOBS.wait(reload->counter);
+    }
+}
+
+template <typename T>
+fe::pointer<T> fe::ResourceImporter::registerImport(const std::filesystem::path& source_full_path, fe::pointer<T> ptr) {
+    if constexpr (std::is_constructible_v<ImportedResource, fe::pointer<T>>) {
+        if (m_Storage.GetResource(ptr) == nullptr) return ptr; // failed, there is nothing to reload
+
+        std::lock_guard<std::mutex> lock_guard(m_ImportedMutex);
+        m_Imported.insert_or_assign(importKey(source_full_path), ImportedResource{ ptr });
+    }
+    return ptr;
+}
+
+fe::pointer<fe::resource::Model> fe::ResourceImporter::importGLTF(const std::filesystem::path& source_full_path, const std::filesystem::path& resource_full_path) {
+    GLTFImportResult result{};
+    if (!GLTFImporter::Load(resource_full_path, result, m_Context.texture_quality_tier, m_Context.vertex_attributes, m_Context.lod_settings)) return {};
+
+    return this->publishGLTF(source_full_path, result);
+}
+
+fe::pointer<fe::resource::Model> fe::ResourceImporter::publishGLTF(const std::filesystem::path& source_full_path, GLTFImportResult& result) {
+    std::vector<fe::pointer<resource::Texture>> textures{};
+    fe::pointer<resource::Model>                ptr = GLTFImporter::Publish(m_Storage, result, &textures);
+
+    {
+        std::lock_guard<std::mutex> lock_guard(m_ImportedMutex);
+        m_ImportedTextures.insert_or_assign(importKey(source_full_path), std::move(textures));
+    }
+
+    return this->registerImport(source_full_path, ptr);
+}
+
+std::filesystem::path fe::ResourceImporter::resolvePath(const std::filesystem::path& resource_full_path) const {
+    // cooked models have only the geometry. the source is imported until materials are cooked too, the DDC keeps its geometry anyway
+    if (resource_full_path.extension() == ".gltf" || resource_full_path.extension() == ".glb") return resource_full_path;
+
+    std::filesystem::path cooked_path = ResourceCooker::GetCookedPath(resource_full_path, m_Context.graphics_backend);
+    if (cooked_path.empty()) return resource_full_path;
+
+    // a cooked file without an entry is left from a cook that failed or was interrupted
+    std::string relative = resource_full_path.lexically_normal().lexically_relative(PATH.getAssetsPath().lexically_normal()).generic_string();
+    auto        it       = m_CookedDependencies.find(relative);
+    if (it == m_CookedDependencies.end()) return resource_full_path;
+
+    std::error_code error_code{};
+    auto cooked_time = std::filesystem::last_write_time(cooked_path, error_code);
+    if (error_code) return resource_full_path; // not cooked
+
+    auto is_newer = [&](const std::filesystem::path& path) {
+        auto time = std::filesystem::last_write_time(path, error_code);
+        return !error_code && time > cooked_time;
+    };
+
+    // changed after cooking. dependencies change the cooked file without changing the resource
+    if (is_newer(resource_full_path)) return resource_full_path;
+    for (const std::string& dependency : it->second) {
+        if (is_newer(PATH.getAssetsPath() / dependency)) return resource_full_path;
+    }
+
+    return cooked_path;
+}
+
+void fe::ResourceImporter::ImportResource(const std::filesystem::path& source_full_path) {
+    std::filesystem::path resource_full_path = this->resolvePath(source_full_path);
+    std::filesystem::path extension          = resource_full_path.extension();
 
     // TODO : add metadata parsing ( .forr_meta )
 
-    if (extension == ".png") {
-        TextureImporter::Import(m_Storage, resource_full_path);
+    if (extension == ".png" || extension == PATH.getTextureExtension()) {
+        this->registerImport(source_full_path, TextureImporter::Import(m_Storage, resource_full_path));
     }
     else if (extension == ".gltf" || extension == ".glb") {
-        GLTFImporter::Import(m_Storage, resource_full_path);
+        this->importGLTF(source_full_path, resource_full_path);
+    }
+    else if (extension == PATH.getModelExtension()) {
+        this->registerImport(source_full_path, ModelImporter::Import(m_Storage, resource_full_path));
     }
     else if (extension == PATH.getMaterialExtension()) {
         MaterialImporter::Import(m_Storage, resource_full_path);
     }
-    else if (extension == PATH.getVertexShaderExtension() || extension == PATH.getFragmentShaderExtension()) {
-        ShaderImporter::Import(m_Storage, resource_full_path);
+    else if (extension == PATH.getVertexShaderExtension() || extension == PATH.getFragmentShaderExtension() || extension == PATH.getShaderExtension()) {
+        this->registerImport(source_full_path, ShaderImporter::Import(m_Storage, resource_full_path));
     }
 }
 
+void fe::ResourceImporter::ImportResources(const std::vector<std::filesystem::path>& resource_full_paths) {
+    const size_t count = resource_full_paths.size();
+    if (count == 0) return;
+
+    auto batch_start = ImportClock::now();
+
+    auto staged   = std::make_unique<StagedResource[]>(count);
+    auto counters = std::make_unique<JobCounter[]>(count);
+
+    for (size_t i = 0; i < count; i++) {
+        JOBS.run([this, &resource_full_paths, &staged, i] {
+            loadStaged(m_Context, this->resolvePath(resource_full_paths[i]), staged[i]);
+        }, &counters[i]);
+    }
+
+    double load_milliseconds_sum{};
+
+    // publishing goes in the order of the paths, so the storage layout doesn't depend on the worker timings.
+    // file 'i' is published as soon as it is loaded, while the next ones are still loading
+    for (size_t i = 0; i < count; i++) {
+        JOBS.wait(counters[i]);
+
+        const std::filesystem::path& path     = resource_full_paths[i];
+        StagedResource&              resource = staged[i];
+
+        auto publish_start = ImportClock::now();
+
+        bool good = std::visit([&](auto& value) -> bool {
+            using T = std::decay_t<decltype(value)>;
+
+            if constexpr (std::is_same_v<T, resource::Texture> || std::is_same_v<T, resource::Model>) {
+                return static_cast<bool>(this->registerImport(path, m_Storage.CreateResource(std::move(value))));
+            }
+            else if constexpr (std::is_same_v<T, GLTFImportResult>) {
+                return static_cast<bool>(this->publishGLTF(path, value));
+            }
+            else if constexpr (std::is_same_v<T, ShaderImportResult>) {
+                return static_cast<bool>(this->registerImport(path, ShaderImporter::Publish(m_Storage, value)));
+            }
+            else {
+                if (resource.loaded_on_worker) return false; // failed to load. the importer has already reported why
+
+                this->ImportResource(path);
+                return true;
+            }
+        }, resource.value);
+
+        resource.value = std::monostate{}; // free the staged memory right away
+
+        double publish_milliseconds = millisecondsSince(publish_start);
+        load_milliseconds_sum += resource.load_milliseconds;
+
+        if (good) {
+            fe::logging::info("Imported a resource. Load : %.2f ms, Publish : %.2f ms\nPath : %s", resource.load_milliseconds, publish_milliseconds, path.string().c_str());
+        }
+        else {
+            fe::logging::warning("Failed to import a resource. Load : %.2f ms\nPath : %s", resource.load_milliseconds, path.string().c_str());
+        }
+    }
+
+    double batch_milliseconds = millisecondsSince(batch_start);
+
+    fe::logging::info("Imported %zu resources in %.2f ms on %zu workers. Sum of load times : %.2f ms ( x%.2f )",
+                      count, batch_milliseconds, JOBS.worker_count(), load_milliseconds_sum,
+                      batch_milliseconds > 0.0 ? load_milliseconds_sum / batch_milliseconds : 1.0);
+}
+
+std::vector<fe::pointer<fe::resource::Shader>> fe::ResourceImporter::ImportShaders(const std::vector<std::filesystem::path>& source_full_paths) {
+    std::vector<std::filesystem::path> resource_full_paths{};
+    resource_full_paths.reserve(source_full_paths.size());
+    for (const std::filesystem::path& path : source_full_paths) resource_full_paths.emplace_back(this->resolvePath(path));
+
+    std::vector<ShaderImportResult> results(resource_full_paths.size());
+    ShaderImporter::LoadBatch(m_Context, resource_full_paths, results);
+
+    std::vector<fe::pointer<resource::Shader>> pointers{};
+    pointers.reserve(results.size());
+
+    // a failed shader has no variants and gets an empty pointer. LoadBatch() has already reported why
+    for (size_t i = 0; i < results.size(); i++) {
+        pointers.emplace_back(this->registerImport(source_full_paths[i], ShaderImporter::Publish(m_Storage, results[i])));
+    }
+
+    return pointers;
+}
+
 IMPORTER_INSTANCE(fe::resource::Texture, fe::TextureImporter)
-IMPORTER_INSTANCE(fe::resource::Model, fe::GLTFImporter)
 IMPORTER_INSTANCE(fe::resource::Shader, fe::ShaderImporter)
 IMPORTER_INSTANCE(fe::resource::Material, fe::MaterialImporter)
 
 #undef IMPORTER_INSTANCE
+
+// models come from glTF or from cooked files
+template <>
+fe::pointer<fe::resource::Model> fe::ResourceImporter::ImportResource(const std::filesystem::path& source_full_path) {
+    std::filesystem::path resource_full_path = this->resolvePath(source_full_path);
+
+    if (resource_full_path.extension() == PATH.getModelExtension()) {
+        return this->registerImport(source_full_path, ModelImporter::Import(m_Storage, resource_full_path));
+    }
+    return this->importGLTF(source_full_path, resource_full_path);
+}
+template fe::pointer<fe::resource::Model> fe::ResourceImporter::ImportResource(const std::filesystem::path& resource_full_path);
+
+bool fe::ResourceImporter::ReloadResource(const std::filesystem::path& source_full_path) {
+    ImportedResource target{};
+    {
+        std::lock_guard<std::mutex> lock_guard(m_ImportedMutex);
+
+        auto it = m_Imported.find(importKey(source_full_path));
+        if (it == m_Imported.end()) return false;
+
+        target = it->second;
+    }
+
+    this->startReload(source_full_path, target, false);
+    return true;
+}
+
+template <typename T>
+fe::pointer<T> fe::ResourceImporter::GetImportedResource(const std::filesystem::path& source_full_path) const {
+    std::lock_guard<std::mutex> lock_guard(m_ImportedMutex);
+
+    auto it = m_Imported.find(importKey(source_full_path));
+    if (it == m_Imported.end()) return {};
+
+    const auto* ptr = std::get_if<fe::pointer<T>>(&it->second);
+    return ptr ? *ptr : fe::pointer<T>{};
+}
+template fe::pointer<fe::resource::Texture> fe::ResourceImporter::GetImportedResource(const std::filesystem::path& source_full_path) const;
+template fe::pointer<fe::resource::Model> fe::ResourceImporter::GetImportedResource(const std::filesystem::path& source_full_path) const;
+template fe::pointer<fe::resource::Shader> fe::ResourceImporter::GetImportedResource(const std::filesystem::path& source_full_path) const;
+
+std::vector<fe::pointer<fe::resource::Texture>> fe::ResourceImporter::GetImportedTextures(const std::filesystem::path& source_full_path) const {
+    std::lock_guard<std::mutex> lock_guard(m_ImportedMutex);
+
+    auto it = m_ImportedTextures.find(importKey(source_full_path));
+    if (it == m_ImportedTextures.end()) return {};
+
+    return it->second;
+}
+
+template <typename T>
+std::filesystem::path fe::ResourceImporter::findSourcePath(fe::pointer<T> ptr) const {
+    std::lock_guard<std::mutex> lock_guard(m_ImportedMutex);
+
+    // it's needed only when a resource is uploaded or evicted, a reverse map isn't worth keeping
+    for (const auto& [key, imported] : m_Imported) {
+        const auto* imported_ptr = std::get_if<fe::pointer<T>>(&imported);
+        if (imported_ptr && *imported_ptr == ptr) return key;
+    }
+    return {};
+}
+template std::filesystem::path fe::ResourceImporter::findSourcePath(fe::pointer<fe::resource::Texture> ptr) const;
+template std::filesystem::path fe::ResourceImporter::findSourcePath(fe::pointer<fe::resource::Model> ptr) const;
+
+bool fe::ResourceImporter::findGLTFTexture(fe::pointer<resource::Texture> ptr, std::filesystem::path& source_full_path, uint32_t& texture_index) const {
+    if (ptr == m_Context.fallback_texture_ptr) return false; // every failed texture of every file is the fallback
+
+    std::lock_guard<std::mutex> lock_guard(m_ImportedMutex);
+
+    for (const auto& [key, textures] : m_ImportedTextures) {
+        auto it = std::ranges::find(textures, ptr);
+        if (it == textures.end()) continue;
+
+        source_full_path = key;
+        texture_index    = static_cast<uint32_t>(it - textures.begin());
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+bool fe::ResourceImporter::CanRestoreResource(fe::pointer<T> ptr) const {
+    if (!this->findSourcePath(ptr).empty()) return true;
+
+    if constexpr (std::is_same_v<T, resource::Texture>) {
+        std::filesystem::path source_full_path{};
+        uint32_t              texture_index{};
+        return this->findGLTFTexture(ptr, source_full_path, texture_index);
+    }
+    return false;
+}
+template bool fe::ResourceImporter::CanRestoreResource(fe::pointer<fe::resource::Texture> ptr) const;
+template bool fe::ResourceImporter::CanRestoreResource(fe::pointer<fe::resource::Model> ptr) const;
+
+template <typename T>
+bool fe::ResourceImporter::RestoreResource(fe::pointer<T> ptr) {
+    std::filesystem::path source_full_path = this->findSourcePath(ptr);
+    if (!source_full_path.empty()) {
+        this->startReload(source_full_path, ImportedResource{ ptr }, true);
+        return true;
+    }
+
+    if constexpr (std::is_same_v<T, resource::Texture>) {
+        uint32_t texture_index{};
+        if (this->findGLTFTexture(ptr, source_full_path, texture_index)) {
+            this->startReload(source_full_path, ImportedResource{ ptr }, true, static_cast<int>(texture_index));
+            return true;
+        }
+    }
+    return false;
+}
+template bool fe::ResourceImporter::RestoreResource(fe::pointer<fe::resource::Texture> ptr);
+template bool fe::ResourceImporter::RestoreResource(fe::pointer<fe::resource::Model> ptr);
+
+void fe::ResourceImporter::startReload(const std::filesystem::path& source_full_path, const ImportedResource& target, bool restore, int gltf_texture_index) {
+    auto reload = std::make_unique<PendingReload>();
+    reload->source_full_path   = source_full_path;
+    reload->target             = target;
+    reload->restore            = restore;
+    reload->gltf_texture_index = gltf_texture_index;
+
+    // the pending reload lives until ApplyReloads() sees that its counter is done
+    PendingReload* pending = reload.get();
+    JOBS.run([this, pending] {
+        if (pending->gltf_texture_index >= 0)
+            loadStagedGLTFTexture(m_Context, pending->source_full_path, static_cast<uint32_t>(pending->gltf_texture_index), pending->staged);
+        else
+            loadStaged(m_Context, this->resolvePath(pending->source_full_path), pending->staged);
+    }, &pending->counter);
+
+    m_PendingReloads.emplace_back(std::move(reload));
+}
+
+void fe::ResourceImporter::ApplyReloads(ResourceUploadQueue& queue) {
+    // in the order of the changes, so an older version of a file never replaces a newer one
+    size_t ready_count = 0;
+    while (ready_count < m_PendingReloads.size() && m_PendingReloads[ready_count]->counter.is_done()) ready_count++;
+
+    for (size_t i = 0; i < ready_count; i++) {
+        PendingReload& reload = *m_PendingReloads[i];
+
+        auto apply_start = ImportClock::now();
+
+        bool good = std::visit([&](auto& value) -> bool {
+            using T = std::decay_t<decltype(value)>;
+
+            if constexpr (std::is_same_v<T, resource::Texture>) {
+                return this->reloadTexture(reload.target, value, queue);
+            }
+            else if constexpr (std::is_same_v<T, resource::Model>) {
+                return this->reloadModel(reload.target, value, queue);
+            }
+            else if constexpr (std::is_same_v<T, GLTFImportResult>) {
+                // the file is the same, its materials and textures are still in the storage
+                if (reload.restore && this->reloadModel(reload.target, value.model, queue, true)) return true;
+
+                // textures of the file go to the slots of the previous version, the model goes to the old slot
+                std::vector<fe::pointer<resource::Texture>> previous_textures{};
+                {
+                    std::lock_guard<std::mutex> lock_guard(m_ImportedMutex);
+
+                    auto it = m_ImportedTextures.find(importKey(reload.source_full_path));
+                    if (it != m_ImportedTextures.end()) previous_textures = it->second;
+                }
+
+                std::vector<fe::pointer<resource::Texture>> textures = previous_textures;
+                fe::pointer<resource::Model>                model_ptr = GLTFImporter::Publish(m_Storage, value, &textures);
+
+                this->reloadTextures(previous_textures, textures, queue);
+                {
+                    std::lock_guard<std::mutex> lock_guard(m_ImportedMutex);
+                    m_ImportedTextures.insert_or_assign(importKey(reload.source_full_path), std::move(textures));
+                }
+
+                resource::Model* model = m_Storage.GetResource(model_ptr);
+                bool             moved = model && this->reloadModel(reload.target, *model, queue);
+
+                m_Storage.DestroyResource(model_ptr);
+                return moved;
+            }
+            else if constexpr (std::is_same_v<T, ShaderImportResult>) {
+                return this->reloadShader(reload.target, value.variants, queue);
+            }
+            else {
+                return false; // failed to load. the importer has already reported why
+            }
+        }, reload.staged.value);
+
+        double apply_milliseconds = millisecondsSince(apply_start);
+
+        if (good && reload.restore) {
+            fe::logging::info("Restored an evicted resource. Load : %.2f ms, Apply : %.2f ms\nPath : %s", reload.staged.load_milliseconds, apply_milliseconds, reload.source_full_path.string().c_str());
+        }
+        else if (good) {
+            fe::logging::info("Reloaded a resource. Load : %.2f ms, Apply : %.2f ms\nPath : %s", reload.staged.load_milliseconds, apply_milliseconds, reload.source_full_path.string().c_str());
+        }
+        else {
+            fe::logging::warning("Failed to reload a resource. The old one is kept\nPath : %s", reload.source_full_path.string().c_str());
+        }
+    }
+
+    m_PendingReloads.erase(m_PendingReloads.begin(), m_PendingReloads.begin() + ready_count);
+}
+
+bool fe::ResourceImporter::reloadTexture(const ImportedResource& target, resource::Texture& texture, ResourceUploadQueue& queue) {
+    const auto* texture_ptr = std::get_if<fe::pointer<resource::Texture>>(&target);
+    if (!texture_ptr) return false; // the file was imported as something else
+
+    resource::Texture* old_texture = m_Storage.GetResource(*texture_ptr);
+    if (!old_texture) return false; // destroyed since the import
+
+    // the GPU texture is made again in the same GPU slot
+    texture.guid       = old_texture->guid;
+    texture.gpu_handle = old_texture->gpu_handle;
+
+    *old_texture = std::move(texture);
+
+    queue.reloaded_textures.emplace_back(*texture_ptr);
+    return true;
+}
+
+void fe::ResourceImporter::reloadTextures(const std::vector<fe::pointer<resource::Texture>>& previous_textures,
+                                          const std::vector<fe::pointer<resource::Texture>>& textures, ResourceUploadQueue& queue) {
+    const fe::pointer<resource::Texture> fallback_texture_ptr = m_Context.fallback_texture_ptr;
+
+    for (size_t i = 0; i < textures.size(); i++) {
+        if (textures[i] == fallback_texture_ptr) continue;
+
+        // the same slot - the new data is in the old texture, otherwise the texture is new
+        if (i < previous_textures.size() && previous_textures[i] == textures[i])
+            queue.reloaded_textures.emplace_back(textures[i]);
+        else
+            queue.textures.emplace_back(textures[i]);
+    }
+
+    for (auto texture_ptr : previous_textures) {
+        if (texture_ptr == fallback_texture_ptr || std::ranges::find(textures, texture_ptr) != textures.end()) continue;
+        queue.destroyed_textures.emplace_back(texture_ptr);
+    }
+}
+
+bool fe::ResourceImporter::reloadModel(const ImportedResource& target, resource::Model& model, ResourceUploadQueue& queue, bool keep_materials) {
+    const auto* model_ptr = std::get_if<fe::pointer<resource::Model>>(&target);
+    if (!model_ptr) return false;
+
+    resource::Model* old_model = m_Storage.GetResource(*model_ptr);
+    if (!old_model) return false;
+
+    if (keep_materials) {
+        if (model.meshes.size() != old_model->meshes.size()) return false;
+
+        for (size_t i = 0; i < model.meshes.size(); i++) {
+            auto&       primitives     = model.meshes[i].primitives;
+            const auto& old_primitives = old_model->meshes[i].primitives;
+            if (primitives.size() != old_primitives.size()) return false;
+
+            for (size_t j = 0; j < primitives.size(); j++) primitives[j].material_ptr = old_primitives[j].material_ptr;
+        }
+
+        model.textures = old_model->textures;
+    }
+
+    // meshes that exist in both versions keep their GPU slots. new meshes get new ones
+    size_t shared_mesh_count = std::min(model.meshes.size(), old_model->meshes.size());
+    for (size_t i = 0; i < shared_mesh_count; i++) model.meshes[i].gpu_handle = old_model->meshes[i].gpu_handle;
+
+    model.guid = old_model->guid;
+
+    *old_model = std::move(model);
+
+    queue.reloaded_models.emplace_back(*model_ptr);
+    return true;
+}
+
+bool fe::ResourceImporter::reloadShader(const ImportedResource& target, std::vector<resource::Shader>& variants, ResourceUploadQueue& queue) {
+    const auto* base_ptr = std::get_if<fe::pointer<resource::Shader>>(&target);
+    if (!base_ptr || variants.empty()) return false;
+
+    resource::Shader* base = m_Storage.GetResource(*base_ptr);
+    if (!base) return false;
+
+    std::vector<fe::pointer<resource::Shader>> old_slots = base->variants; // by variant key, the base is the first one
+    if (old_slots.empty()) old_slots.emplace_back(*base_ptr);
+
+    std::vector<fe::pointer<resource::Shader>> new_slots{};
+    new_slots.reserve(variants.size());
+
+    // a variant with the same key goes to the same slot, so materials keep their variants
+    for (size_t key = 0; key < variants.size(); key++) {
+        resource::Shader& variant = variants[key];
+        variant.variants.clear();
+
+        resource::Shader* old_variant = key < old_slots.size() ? m_Storage.GetResource(old_slots[key]) : nullptr;
+        if (old_variant) {
+            variant.guid = old_variant->guid;
+            *old_variant = std::move(variant);
+            new_slots.emplace_back(old_slots[key]);
+        }
+        else {
+            new_slots.emplace_back(m_Storage.CreateResource(std::move(variant)));
+        }
+    }
+    variants.clear();
+
+    // keywords were removed, these keys don't exist anymore
+    std::vector<fe::pointer<resource::Shader>> removed_slots{};
+    for (size_t key = new_slots.size(); key < old_slots.size(); key++) removed_slots.emplace_back(old_slots[key]);
+
+    base->variants = new_slots; // the storage never moves resources, 'base' is still the base variant
+
+    auto contains = [](const std::vector<fe::pointer<resource::Shader>>& slots, fe::pointer<resource::Shader> ptr) {
+        return std::find(slots.begin(), slots.end(), ptr) != slots.end();
+    };
+
+    // programs of the materials that use any variant have to be linked again
+    m_Storage.RunForEach<resource::Material>([&](fe::pointer<resource::Material> material_ptr, resource::Material& material) {
+        bool affected = false;
+
+        for (fe::pointer<resource::Shader>* shader_ptr : { &material.vertex_shader_ptr, &material.fragment_shader_ptr }) {
+            if (contains(removed_slots, *shader_ptr)) *shader_ptr = *base_ptr;
+            if (contains(new_slots, *shader_ptr)) affected = true;
+        }
+
+        if (affected) queue.reloaded_materials.emplace_back(material_ptr);
+    });
+
+    for (fe::pointer<resource::Shader> removed_ptr : removed_slots) m_Storage.DestroyResource(removed_ptr);
+
+    queue.reloaded_shaders.emplace_back(*base_ptr);
+    return true;
+}
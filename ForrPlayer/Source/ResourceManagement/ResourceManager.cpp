@@ -12,9 +12,62 @@
 
 #include "pch.hpp"
 #include "ResourceManagement/ResourceManager.hpp"
+#include "ResourceManagement/TextureLayout.hpp"
+
+namespace fe {
+    // what the GPU copy takes, it's estimated from the CPU data
+    static size_t gpuBytes(const resource::Texture& texture) {
+        if (is_block_compressed(texture.internal_format)) return texture_byte_size(texture); // uploaded as it is
+
+        size_t bytes = static_cast<size_t>(texture.width) * texture.height * 4; // drivers keep RGB8 as RGBA8
+        return bytes + bytes / 3;                                              // the mip chain
+    }
+
+    static size_t gpuBytes(const resource::Model& model) {
+        size_t bytes{};
+        for (const auto& mesh : model.meshes) {
+            bytes += mesh.vertices.size() * vertex_layout(mesh.vertex_format).stride; // only the attributes of the mesh
+            bytes += mesh.indices.size() * index_size(mesh.index_type);
+        }
+        return bytes;
+    }
+
+    static size_t cpuBytes(const resource::Texture& texture) {
+        return texture.bytes ? texture.bytes.get_deleter().count : 0;
+    }
+
+    static size_t cpuBytes(const resource::Model& model) {
+        size_t bytes{};
+        for (const auto& mesh : model.meshes) bytes += mesh.vertices.capacity() * sizeof(Vertex) + mesh.indices.capacity() * sizeof(Index);
+        return bytes;
+    }
+
+    // only the data that is copied to the GPU. sizes, primitives, nodes, ... stay
+    static void releaseCPUCopy(resource::Texture& texture) {
+        texture.bytes.reset();
+    }
+
+    static void releaseCPUCopy(resource::Model& model) {
+        for (auto& mesh : model.meshes) {
+            Vertices{}.swap(mesh.vertices);
+            Indices{}.swap(mesh.indices);
+        }
+    }
+} // namespace fe
 
 fe::ResourceManager::ResourceManager(ResourceManagerDesc desc) {
-    m_Context.graphics_backend = desc.graphics_backend;
+    m_Context.graphics_backend     = desc.graphics_backend;
+    m_Context.texture_quality_tier = desc.texture_quality_tier;
+    m_Context.vertex_attributes    = desc.vertex_attributes;
+    m_Context.lod_settings         = desc.lod_settings;
+
+    m_Residency.Init(desc.residency_desc);
+
+    if (desc.hot_reload_enabled) {
+        if (!m_Watcher.init(PATH.getAssetsPath(), desc.hot_reload_desc)) {
+            fe::logging::warning("Hot reload is disabled, the assets folder can't be watched\nPath : %s", PATH.getAssetsPath().string().c_str());
+        }
+    }
 }
 
 void fe::ResourceManager::CreateDefaultResources() {
@@ -22,7 +75,64 @@ void fe::ResourceManager::CreateDefaultResources() {
 }
 
 void fe::ResourceManager::SetupSceneResources(const std::vector<std::filesystem::path>& resource_full_paths) {
-    for (const auto& path : resource_full_paths) {
-        m_Importer.ImportResource(path); // uploads resource to the storage
+    m_Importer.ImportResources(resource_full_paths); // uploads resources to the storage in the order of the paths
+}
+
+void fe::ResourceManager::UpdateHotReload() {
+    if (m_Watcher.is_watching()) {
+        for (const std::filesystem::path& path : m_Watcher.poll()) {
+            // files that were never imported ( cooked outputs, metadata, ... ) are ignored
+            if (m_Importer.ReloadResource(path)) fe::logging::info("Reloading a changed resource\nPath : %s", path.string().c_str());
+        }
+    }
+
+    m_Importer.ApplyReloads(m_UploadQueue);
+}
+
+template <fe::residency_t T>
+void fe::ResourceManager::MarkUploaded(fe::pointer<T> ptr) {
+    T* resource = m_Storage.GetResource(ptr);
+    if (!resource) return;
+
+    size_t gpu_bytes = gpuBytes(*resource); // before the CPU copy is released
+
+    // the fallbacks and resources that weren't imported from a file can't be imported again, so they are never evicted
+    bool pinned = ptr == m_Context.GetFallback<T>() || !m_Importer.CanRestoreResource(ptr);
+
+    if (m_Residency.GetDesc().release_cpu_copies) releaseCPUCopy(*resource);
+
+    m_Residency.MarkResident(ptr, cpuBytes(*resource), gpu_bytes, pinned);
+}
+template void fe::ResourceManager::MarkUploaded(fe::pointer<resource::Texture> ptr);
+template void fe::ResourceManager::MarkUploaded(fe::pointer<resource::Model> ptr);
+
+template <fe::residency_t T>
+bool fe::ResourceManager::TouchResource(fe::pointer<T> ptr) {
+    switch (m_Residency.Touch(ptr)) {
+        case ResidencyState::RESIDENT:
+            return true;
+        case ResidencyState::EVICTED:
+            // it comes back through the upload queue, like a hot-reloaded resource
+            if (m_Importer.RestoreResource(ptr)) m_Residency.MarkRestoring(ptr);
+            return false;
+        case ResidencyState::RESTORING:
+            return false;
     }
+    return false;
+}
+template bool fe::ResourceManager::TouchResource(fe::pointer<resource::Texture> ptr);
+template bool fe::ResourceManager::TouchResource(fe::pointer<resource::Model> ptr);
+
+template <fe::residency_t T>
+void fe::ResourceManager::EvictResource(fe::pointer<T> ptr) {
+    T* resource = m_Storage.GetResource(ptr);
+    if (!resource) {
+        m_Residency.Forget(ptr);
+        return;
+    }
+
+    releaseCPUCopy(*resource);
+    m_Residency.MarkEvicted(ptr);
 }
+template void fe::ResourceManager::EvictResource(fe::pointer<resource::Texture> ptr);
+template void fe::ResourceManager::EvictResource(fe::pointer<resource::Model> ptr);
@@ -0,0 +1,97 @@
+/*===============================================
+
+    Forr Engine
+
+    File : ResourceResidency.cpp
+    Role : tracks memory of resources and picks the ones to evict under a budget
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "ResourceManagement/ResourceResidency.hpp"
+
+#include <algorithm>
+
+void fe::ResourceResidency::track(const Entry& entry) {
+    m_Stats.cpu_bytes += entry.cpu_bytes;
+    m_Stats.gpu_bytes += entry.gpu_bytes;
+
+    if (entry.state == ResidencyState::RESIDENT)
+        m_Stats.resident_count++;
+    else
+        m_Stats.evicted_count++;
+}
+
+void fe::ResourceResidency::untrack(const Entry& entry) {
+    m_Stats.cpu_bytes -= entry.cpu_bytes;
+    m_Stats.gpu_bytes -= entry.gpu_bytes;
+
+    if (entry.state == ResidencyState::RESIDENT)
+        m_Stats.resident_count--;
+    else
+        m_Stats.evicted_count--;
+}
+
+fe::ResidencyEvictions fe::ResourceResidency::Update(size_t gpu_budget_bytes) {
+    m_Frame++;
+
+    ResidencyEvictions evictions{};
+
+    size_t gpu_budget = m_Desc.gpu_budget_bytes;
+    if (gpu_budget_bytes != 0) gpu_budget = gpu_budget == 0 ? gpu_budget_bytes : std::min(gpu_budget, gpu_budget_bytes);
+
+    const size_t cpu_budget = m_Desc.cpu_budget_bytes;
+
+    bool over_cpu_budget = cpu_budget != 0 && m_Stats.cpu_bytes > cpu_budget;
+    bool over_gpu_budget = gpu_budget != 0 && m_Stats.gpu_bytes > gpu_budget;
+    if (!over_cpu_budget && !over_gpu_budget) return evictions;
+
+    struct Candidate {
+        uint64_t packed{};
+        uint64_t last_used_frame{};
+        size_t   cpu_bytes{};
+        size_t   gpu_bytes{};
+        bool     is_texture{};
+    };
+
+    std::vector<Candidate> candidates{};
+
+    auto collect = [&](const entries_t& entries, bool is_texture) {
+        for (const auto& [packed, entry] : entries) {
+            if (entry.pinned || entry.state != ResidencyState::RESIDENT) continue;
+            if (m_Frame - entry.last_used_frame < m_Desc.min_unused_frames) continue; // still hot
+
+            candidates.push_back({ packed, entry.last_used_frame, entry.cpu_bytes, entry.gpu_bytes, is_texture });
+        }
+    };
+    collect(m_Textures, true);
+    collect(m_Models, false);
+
+    // the least recently used first
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.last_used_frame < b.last_used_frame;
+    });
+
+    // the usage after the evictions. the renderer frees the memory and calls MarkEvicted()
+    size_t cpu_bytes = m_Stats.cpu_bytes;
+    size_t gpu_bytes = m_Stats.gpu_bytes;
+
+    for (const Candidate& candidate : candidates) {
+        over_cpu_budget = cpu_budget != 0 && cpu_bytes > cpu_budget;
+        over_gpu_budget = gpu_budget != 0 && gpu_bytes > gpu_budget;
+        if (!over_cpu_budget && !over_gpu_budget) break;
+
+        if (candidate.is_texture)
+            evictions.textures.emplace_back(candidate.packed);
+        else
+            evictions.models.emplace_back(candidate.packed);
+
+        cpu_bytes -= candidate.cpu_bytes;
+        gpu_bytes -= candidate.gpu_bytes;
+    }
+
+    return evictions;
+}
@@ -0,0 +1,392 @@
+/*===============================================
+
+    Forr Engine
+
+    File : block_compression.cpp
+    Role : CPU encoder of BC1, BC3, BC4, BC5 and BC7 blocks
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Core/block_compression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "Core/job_system.hpp"
+
+namespace fe {
+    using Color = std::array<float, 4>;
+    using Block = std::array<Color, 16>; // 4x4 texels, RGBA in [0, 255]
+
+    static constexpr uint32_t G_BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    static void fetchBlock(const unsigned char* texels, uint32_t width, uint32_t height, uint32_t components, uint32_t block_x, uint32_t block_y, Block& block) {
+        for (uint32_t y = 0; y < 4; y++) {
+            uint32_t source_y = std::min(block_y * 4 + y, height - 1);
+
+            for (uint32_t x = 0; x < 4; x++) {
+                uint32_t source_x = std::min(block_x * 4 + x, width - 1);
+
+                const unsigned char* texel = texels + (static_cast<size_t>(source_y) * width + source_x) * components;
+
+                Color& color = block[y * 4 + x];
+                color        = { 0.0f, 0.0f, 0.0f, 255.0f };
+
+                for (uint32_t c = 0; c < std::min(components, 4u); c++) color[c] = texel[c];
+            }
+        }
+    }
+
+    // the segment along the largest spread of the first N channels, found by power iteration
+    template <size_t N>
+    static void fitLine(const Block& block, Color& low, Color& high) {
+        Color mean{};
+        for (const Color& color : block) {
+            for (size_t c = 0; c < N; c++) mean[c] += color[c] / 16.0f;
+        }
+
+        float covariance[N][N]{};
+        for (const Color& color : block) {
+            for (size_t i = 0; i < N; i++) {
+                for (size_t j = 0; j < N; j++) covariance[i][j] += (color[i] - mean[i]) * (color[j] - mean[j]);
+            }
+        }
+
+        Color axis{};
+        for (size_t c = 0; c < N; c++) axis[c] = 1.0f;
+
+        for (int iteration = 0; iteration < 8; iteration++) {
+            Color next{};
+            for (size_t i = 0; i < N; i++) {
+                for (size_t j = 0; j < N; j++) next[i] += covariance[i][j] * axis[j];
+            }
+
+            float length = 0.0f;
+            for (size_t c = 0; c < N; c++) length = std::max(length, std::abs(next[c]));
+            if (length < 1e-6f) break; // every texel is the same
+
+            for (size_t c = 0; c < N; c++) axis[c] = next[c] / length;
+        }
+
+        float norm = 0.0f;
+        for (size_t c = 0; c < N; c++) norm += axis[c] * axis[c];
+        norm = std::sqrt(norm);
+        for (size_t c = 0; c < N; c++) axis[c] /= norm;
+
+        float min_t = std::numeric_limits<float>::max();
+        float max_t = std::numeric_limits<float>::lowest();
+
+        for (const Color& color : block) {
+            float t = 0.0f;
+            for (size_t c = 0; c < N; c++) t += (color[c] - mean[c]) * axis[c];
+
+            min_t = std::min(min_t, t);
+            max_t = std::max(max_t, t);
+        }
+
+        for (size_t c = 0; c < N; c++) {
+            low[c]  = std::clamp(mean[c] + axis[c] * min_t, 0.0f, 255.0f);
+            high[c] = std::clamp(mean[c] + axis[c] * max_t, 0.0f, 255.0f);
+        }
+    }
+
+    // least squares endpoints for the chosen indices. 'weights' is how much of 'second' every texel takes
+    template <size_t N>
+    static bool refineLine(const Block& block, const float (&weights)[16], Color& first, Color& second) {
+        float aa{}, ab{}, bb{};
+        Color ax{}, bx{};
+
+        for (size_t i = 0; i < 16; i++) {
+            float b = weights[i];
+            float a = 1.0f - b;
+
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+
+            for (size_t c = 0; c < N; c++) {
+                ax[c] += a * block[i][c];
+                bx[c] += b * block[i][c];
+            }
+        }
+
+        float determinant = aa * bb - ab * ab;
+        if (std::abs(determinant) < 1e-6f) return false; // every texel took the same index
+
+        for (size_t c = 0; c < N; c++) {
+            first[c]  = std::clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+            second[c] = std::clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+        }
+
+        return true;
+    }
+
+    template <size_t N>
+    static float distanceSquared(const Color& a, const Color& b) {
+        float distance = 0.0f;
+        for (size_t c = 0; c < N; c++) distance += (a[c] - b[c]) * (a[c] - b[c]);
+        return distance;
+    }
+
+    static void writeLittleEndian(unsigned char* out, uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++) out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+
+    /// BC1
+
+    static uint16_t packRGB565(const Color& color) {
+        auto quantize = [](float value, float max) { return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 255.0f) * max / 255.0f)); };
+        return static_cast<uint16_t>((quantize(color[0], 31.0f) << 11) | (quantize(color[1], 63.0f) << 5) | quantize(color[2], 31.0f));
+    }
+
+    static Color unpackRGB565(uint16_t packed) {
+        uint32_t r = (packed >> 11) & 31;
+        uint32_t g = (packed >> 5) & 63;
+        uint32_t b = packed & 31;
+        return { static_cast<float>((r << 3) | (r >> 2)), static_cast<float>((g << 2) | (g >> 4)), static_cast<float>((b << 3) | (b >> 2)), 255.0f };
+    }
+
+    // the 4 color mode, that BC3 always uses too. returns the squared error
+    static float encodeColorBlock(const Block& block, const Color& first, const Color& second, unsigned char* out, float (&weights)[16]) {
+        uint16_t color0 = packRGB565(first);
+        uint16_t color1 = packRGB565(second);
+
+        // color0 > color1 selects the 4 color mode in BC1
+        bool swapped = color0 < color1;
+        if (swapped) std::swap(color0, color1);
+
+        Color palette[4]{ unpackRGB565(color0), unpackRGB565(color1) };
+        for (size_t c = 0; c < 3; c++) {
+            palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+            palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+        }
+
+        // how much of color1 every index takes
+        static constexpr float G_INDEX_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+        uint32_t indices{};
+        float    error{};
+
+        for (size_t i = 0; i < 16; i++) {
+            uint32_t best_index    = 0;
+            float    best_distance = distanceSquared<3>(block[i], palette[0]);
+
+            // with equal colors it's the 3 color mode, where index 3 is black
+            for (uint32_t index = 1; index < 4 && color0 != color1; index++) {
+                float distance = distanceSquared<3>(block[i], palette[index]);
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best_index    = index;
+                }
+            }
+
+            indices |= best_index << (2 * i);
+            error += best_distance;
+
+            weights[i] = swapped ? 1.0f - G_INDEX_WEIGHTS[best_index] : G_INDEX_WEIGHTS[best_index];
+        }
+
+        writeLittleEndian(out, color0, 2);
+        writeLittleEndian(out + 2, color1, 2);
+        writeLittleEndian(out + 4, indices, 4);
+
+        return error;
+    }
+
+    static void encodeBC1(const Block& block, unsigned char* out) {
+        Color low{}, high{};
+        fitLine<3>(block, low, high);
+
+        // the ends of the segment are outliers, a bit inside fits better
+        for (size_t c = 0; c < 3; c++) {
+            float inset = (high[c] - low[c]) / 16.0f;
+            low[c] += inset;
+            high[c] -= inset;
+        }
+
+        float weights[16]{};
+        float error = encodeColorBlock(block, high, low, out, weights);
+
+        if (!refineLine<3>(block, weights, high, low)) return;
+
+        unsigned char refined[8]{};
+        if (encodeColorBlock(block, high, low, refined, weights) < error) std::copy(std::begin(refined), std::end(refined), out);
+    }
+
+    /// BC4
+
+    static void encodeBC4(const Block& block, size_t channel, unsigned char* out) {
+        float low  = 255.0f;
+        float high = 0.0f;
+
+        for (const Color& color : block) {
+            low  = std::min(low, color[channel]);
+            high = std::max(high, color[channel]);
+        }
+
+        uint32_t red0 = static_cast<uint32_t>(std::lround(high));
+        uint32_t red1 = static_cast<uint32_t>(std::lround(low));
+
+        // red0 > red1 selects 8 values : red0, red1 and 6 between them. index 2 is the closest to red0
+        uint64_t indices{};
+        if (red0 > red1) {
+            for (size_t i = 0; i < 16; i++) {
+                long position = std::lround((block[i][channel] - red1) * 7.0f / static_cast<float>(red0 - red1)); // 0 - red1, 7 - red0
+                position      = std::clamp(position, 0l, 7l);
+
+                uint64_t index = position == 7 ? 0 : position == 0 ? 1 : 8 - position;
+                indices |= index << (3 * i);
+            }
+        }
+
+        out[0] = static_cast<unsigned char>(red0);
+        out[1] = static_cast<unsigned char>(red1);
+        writeLittleEndian(out + 2, indices, 6);
+    }
+
+    /// BC7
+
+    struct BitWriter {
+        unsigned char* out{};
+        uint32_t       position{};
+
+        void write(uint32_t value, uint32_t count) {
+            for (uint32_t i = 0; i < count; i++, position++) {
+                if ((value >> i) & 1) out[position / 8] |= static_cast<unsigned char>(1 << (position % 8));
+            }
+        }
+    };
+
+    // 7 bits per channel and one p-bit, the lowest bit of every channel
+    static void quantizeEndpoint(const Color& endpoint, std::array<uint32_t, 4>& quantized, uint32_t& p_bit) {
+        float best_error = std::numeric_limits<float>::max();
+
+        for (uint32_t p = 0; p < 2; p++) {
+            std::array<uint32_t, 4> candidate{};
+            float                   error{};
+
+            for (size_t c = 0; c < 4; c++) {
+                candidate[c] = static_cast<uint32_t>(std::clamp(std::lround((endpoint[c] - p) / 2.0f), 0l, 127l));
+
+                float value = static_cast<float>(candidate[c] * 2 + p);
+                error += (value - endpoint[c]) * (value - endpoint[c]);
+            }
+
+            if (error < best_error) {
+                best_error = error;
+                quantized  = candidate;
+                p_bit      = p;
+            }
+        }
+    }
+
+    static float encodeBC7Mode6(const Block& block, const Color& first, const Color& second, unsigned char* out, float (&weights)[16]) {
+        std::array<uint32_t, 4> quantized0{}, quantized1{};
+        uint32_t                p0{}, p1{};
+
+        quantizeEndpoint(first, quantized0, p0);
+        quantizeEndpoint(second, quantized1, p1);
+
+        Color palette[16]{};
+        for (size_t index = 0; index < 16; index++) {
+            for (size_t c = 0; c < 4; c++) {
+                uint32_t endpoint0 = quantized0[c] * 2 + p0;
+                uint32_t endpoint1 = quantized1[c] * 2 + p1;
+
+                palette[index][c] = static_cast<float>(((64 - G_BC7_WEIGHTS[index]) * endpoint0 + G_BC7_WEIGHTS[index] * endpoint1 + 32) >> 6);
+            }
+        }
+
+        uint32_t indices[16]{};
+        float    error{};
+
+        for (size_t i = 0; i < 16; i++) {
+            float best_distance = std::numeric_limits<float>::max();
+
+            for (uint32_t index = 0; index < 16; index++) {
+                float distance = distanceSquared<4>(block[i], palette[index]);
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    indices[i]    = index;
+                }
+            }
+
+            error += best_distance;
+            weights[i] = static_cast<float>(G_BC7_WEIGHTS[indices[i]]) / 64.0f;
+        }
+
+        // the highest bit of the first index isn't stored, it has to be 0
+        if (indices[0] & 8) {
+            std::swap(quantized0, quantized1);
+            std::swap(p0, p1);
+            for (uint32_t& index : indices) index = 15 - index;
+        }
+
+        std::fill(out, out + 16, static_cast<unsigned char>(0));
+
+        BitWriter writer{ out };
+        writer.write(1 << 6, 7); // mode 6
+
+        for (size_t c = 0; c < 4; c++) {
+            writer.write(quantized0[c], 7);
+            writer.write(quantized1[c], 7);
+        }
+
+        writer.write(p0, 1);
+        writer.write(p1, 1);
+
+        writer.write(indices[0], 3);
+        for (size_t i = 1; i < 16; i++) writer.write(indices[i], 4);
+
+        return error;
+    }
+
+    static void encodeBC7(const Block& block, unsigned char* out) {
+        Color low{}, high{};
+        fitLine<4>(block, low, high);
+
+        float weights[16]{};
+        float error = encodeBC7Mode6(block, low, high, out, weights);
+
+        if (!refineLine<4>(block, weights, low, high)) return;
+
+        unsigned char refined[16]{};
+        if (encodeBC7Mode6(block, low, high, refined, weights) < error) std::copy(std::begin(refined), std::end(refined), out);
+    }
+} // namespace fe
+
+void fe::compress_blocks(const unsigned char* texels, uint32_t width, uint32_t height, uint32_t components, BlockFormat format, unsigned char* blocks) {
+    const uint32_t blocks_x   = (width + 3) / 4;
+    const uint32_t blocks_y   = (height + 3) / 4;
+    const size_t   block_size = block_bytes(format);
+
+    JOBS.parallel_for(0, blocks_y, 1, [&](size_t block_y) {
+        Block block{};
+
+        for (uint32_t block_x = 0; block_x < blocks_x; block_x++) {
+            fetchBlock(texels, width, height, components, block_x, static_cast<uint32_t>(block_y), block);
+
+            unsigned char* out = blocks + (block_y * blocks_x + block_x) * block_size;
+
+            switch (format) {
+                case BlockFormat::BC1: encodeBC1(block, out); break;
+                case BlockFormat::BC3:
+                    encodeBC4(block, 3, out);
+                    encodeBC1(block, out + 8);
+                    break;
+                case BlockFormat::BC4: encodeBC4(block, 0, out); break;
+                case BlockFormat::BC5:
+                    encodeBC4(block, 0, out);
+                    encodeBC4(block, 1, out + 8);
+                    break;
+                case BlockFormat::BC7: encodeBC7(block, out); break;
+            }
+        }
+    });
+}
@@ -0,0 +1,331 @@
+/*===============================================
+
+    Forr Engine
+
+    File : custom_allocators.cpp
+    Role : Arena and Pool allocators
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Core/custom_allocators.hpp"
+
+#include <unordered_map>
+
+namespace fe {
+    static constexpr size_t G_THREAD_ARENA_BLOCK_SIZE = 256 * 1024;
+
+    static constexpr size_t G_POOL_CACHE_ENTRIES = 16; // pools that one thread can cache at once
+    static constexpr size_t G_POOL_CACHE_SIZE    = 64; // max free slots in one cache
+    static constexpr size_t G_POOL_BATCH_SIZE    = 32; // slots moved between a cache and the global free-list at once
+
+    static std::atomic<uint64_t> G_POOL_NEXT_ID{ 1 };
+
+    // alive pools. used to flush the caches of finished threads
+    struct PoolRegistry {
+        std::mutex                                   mutex;
+        std::unordered_map<uint64_t, PoolAllocator*> pools;
+    };
+
+    static PoolRegistry& poolRegistry() {
+        static PoolRegistry registry{};
+        return registry;
+    }
+
+    static bool isPoolAlive(uint64_t id) {
+        PoolRegistry&               registry = poolRegistry();
+        std::lock_guard<std::mutex> lock_guard(registry.mutex);
+        return registry.pools.contains(id);
+    }
+
+    // set when the cache of the thread is destroyed. pools that are destroyed or used after it ( static destruction ) skip the cache
+    static thread_local bool G_POOL_THREAD_CACHE_DESTROYED = false;
+
+    struct PoolThreadCache {
+        struct Entry {
+            uint64_t                 pool_id = 0;
+            PoolAllocator::FreeNode* head    = nullptr;
+            size_t                   count   = 0;
+        };
+
+        std::array<Entry, G_POOL_CACHE_ENTRIES> entries{};
+
+        PoolThreadCache()  = default;
+        ~PoolThreadCache() {
+            G_POOL_THREAD_CACHE_DESTROYED = true;
+
+            PoolRegistry&               registry = poolRegistry();
+            std::lock_guard<std::mutex> lock_guard(registry.mutex);
+
+            for (Entry& entry : entries) {
+                if (entry.pool_id == 0 || !entry.head) continue;
+
+                auto it = registry.pools.find(entry.pool_id);
+                if (it != registry.pools.end()) it->second->returnBatch(entry.head);
+            }
+        }
+
+        // nullptr if there is no place for the pool
+        Entry* find(uint64_t pool_id) {
+            Entry* empty = nullptr;
+
+            for (Entry& entry : entries) {
+                if (entry.pool_id == pool_id) return &entry;
+                if (entry.pool_id == 0 && !empty) empty = &entry;
+            }
+
+            if (!empty) { // take the place of a destroyed pool
+                for (Entry& entry : entries) {
+                    if (!isPoolAlive(entry.pool_id)) {
+                        empty = &entry;
+                        break;
+                    }
+                }
+            }
+
+            if (empty) *empty = Entry{ pool_id, nullptr, 0 };
+
+            return empty;
+        }
+
+        void remove(uint64_t pool_id) noexcept {
+            for (Entry& entry : entries) {
+                if (entry.pool_id == pool_id) entry = Entry{};
+            }
+        }
+    };
+
+    // nullptr once the cache of the thread is destroyed
+    static PoolThreadCache* poolThreadCache() {
+        if (G_POOL_THREAD_CACHE_DESTROYED) return nullptr;
+
+        thread_local PoolThreadCache cache{};
+        return &cache;
+    }
+
+    Arena& thread_arena() {
+        thread_local Arena arena{ G_THREAD_ARENA_BLOCK_SIZE, MemoryTag::Scratch };
+        return arena;
+    }
+
+    static size_t alignUp(size_t value, size_t alignment) noexcept {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    PoolAllocator::PoolAllocator(size_t slot_size, size_t slot_alignment, size_t slab_capacity, MemoryTag tag)
+        : m_id(G_POOL_NEXT_ID.fetch_add(1, std::memory_order_relaxed)),
+          m_slot_size(alignUp(std::max(slot_size, sizeof(FreeNode)), std::max(slot_alignment, alignof(FreeNode)))),
+          m_slot_alignment(std::max(slot_alignment, alignof(FreeNode))),
+          m_slab_capacity(slab_capacity),
+          m_tag(tag) {
+
+        assert(slab_capacity > 0);
+        assert(slot_alignment > 0 && (slot_alignment & (slot_alignment - 1)) == 0); // check that it's a power of two
+
+        PoolRegistry&               registry = poolRegistry();
+        std::lock_guard<std::mutex> lock_guard(registry.mutex);
+        registry.pools[m_id] = this;
+    }
+
+    PoolAllocator::~PoolAllocator() {
+        {
+            PoolRegistry&               registry = poolRegistry();
+            std::lock_guard<std::mutex> lock_guard(registry.mutex);
+            registry.pools.erase(m_id);
+        }
+
+        // caches of other threads are dropped when they meet a destroyed pool
+        if (PoolThreadCache* cache = poolThreadCache()) cache->remove(m_id);
+
+        for (const Slab& slab : m_slabs) {
+            memory::trackDeallocation(m_tag, m_slot_size * m_slab_capacity);
+            ::operator delete(slab.begin, std::align_val_t{ m_slot_alignment });
+        }
+    }
+
+    void* PoolAllocator::allocate() {
+        PoolThreadCache*        cache = poolThreadCache();
+        PoolThreadCache::Entry* entry = cache ? cache->find(m_id) : nullptr;
+
+        if (!entry) { // no cache or no place in it, go straight to the global free-list
+            size_t    taken = 0;
+            FreeNode* node  = this->takeBatch(1, taken);
+
+            this->onAllocate();
+            return node;
+        }
+
+        if (!entry->head) {
+            entry->head = this->takeBatch(G_POOL_BATCH_SIZE, entry->count);
+        }
+
+        FreeNode* node = entry->head;
+        entry->head    = node->next;
+        entry->count--;
+
+        this->onAllocate();
+        return node;
+    }
+
+    void PoolAllocator::deallocate(void* ptr) {
+        if (!ptr) return;
+
+        m_live_count.fetch_sub(1, std::memory_order_relaxed);
+
+        FreeNode* node = static_cast<FreeNode*>(ptr);
+
+        PoolThreadCache*        cache = poolThreadCache();
+        PoolThreadCache::Entry* entry = cache ? cache->find(m_id) : nullptr;
+
+        if (!entry) {
+            node->next = nullptr;
+            this->returnBatch(node);
+            return;
+        }
+
+        node->next  = entry->head;
+        entry->head = node;
+        entry->count++;
+
+        if (entry->count > G_POOL_CACHE_SIZE) {
+            FreeNode* batch = entry->head;
+            FreeNode* last  = batch;
+            for (size_t i = 1; i < G_POOL_BATCH_SIZE; i++) {
+                last = last->next;
+            }
+
+            entry->head = last->next;
+            entry->count -= G_POOL_BATCH_SIZE;
+
+            last->next = nullptr;
+            this->returnBatch(batch);
+        }
+    }
+
+    void PoolAllocator::flush_thread_cache() {
+        PoolThreadCache*        cache = poolThreadCache();
+        PoolThreadCache::Entry* entry = cache ? cache->find(m_id) : nullptr;
+        if (!entry || !entry->head) return;
+
+        this->returnBatch(entry->head);
+
+        entry->head  = nullptr;
+        entry->count = 0;
+    }
+
+    size_t PoolAllocator::release_empty_slabs() {
+        this->flush_thread_cache();
+
+        std::lock_guard<std::mutex> lock_guard(m_mutex);
+
+        size_t empty_count = std::ranges::count_if(m_slabs, [](const Slab& slab) { return slab.outstanding == 0; });
+        if (empty_count == 0) return 0;
+
+        // remove the slots of empty slabs from the free-list
+        FreeNode* kept = nullptr;
+        while (m_free_list) {
+            FreeNode* node = m_free_list;
+            m_free_list    = node->next;
+
+            if (this->findSlab(node)->outstanding != 0) {
+                node->next = kept;
+                kept       = node;
+            }
+        }
+        m_free_list = kept;
+
+        std::erase_if(m_slabs, [this](const Slab& slab) {
+            if (slab.outstanding != 0) return false;
+
+            memory::trackDeallocation(m_tag, m_slot_size * m_slab_capacity);
+            ::operator delete(slab.begin, std::align_val_t{ m_slot_alignment });
+            return true;
+        });
+
+        m_slab_count.store(m_slabs.size(), std::memory_order_relaxed);
+
+        return empty_count;
+    }
+
+    PoolStats PoolAllocator::stats() const noexcept {
+        PoolStats stats{};
+        stats.live_count = m_live_count.load(std::memory_order_relaxed);
+        stats.peak_count = m_peak_count.load(std::memory_order_relaxed);
+        stats.slab_count = m_slab_count.load(std::memory_order_relaxed);
+        stats.slot_size  = m_slot_size;
+        return stats;
+    }
+
+    PoolAllocator::FreeNode* PoolAllocator::takeBatch(size_t count, size_t& taken) {
+        std::lock_guard<std::mutex> lock_guard(m_mutex);
+
+        FreeNode* head = nullptr;
+        for (taken = 0; taken < count; taken++) {
+            if (!m_free_list) this->addSlab();
+
+            FreeNode* node = m_free_list;
+            m_free_list    = node->next;
+
+            this->findSlab(node)->outstanding++;
+
+            node->next = head;
+            head       = node;
+        }
+
+        return head;
+    }
+
+    void PoolAllocator::returnBatch(FreeNode* head) {
+        std::lock_guard<std::mutex> lock_guard(m_mutex);
+
+        while (head) {
+            FreeNode* node = head;
+            head           = node->next;
+
+            this->findSlab(node)->outstanding--;
+
+            node->next  = m_free_list;
+            m_free_list = node;
+        }
+    }
+
+    void PoolAllocator::addSlab() {
+        std::byte* begin = static_cast<std::byte*>(::operator new(m_slot_size * m_slab_capacity, std::align_val_t{ m_slot_alignment }));
+        memory::trackAllocation(m_tag, m_slot_size * m_slab_capacity);
+
+        for (size_t i = m_slab_capacity; i-- > 0;) { // the first slot ends up on top
+            FreeNode* node = reinterpret_cast<FreeNode*>(begin + i * m_slot_size);
+            node->next     = m_free_list;
+            m_free_list    = node;
+        }
+
+        auto it = std::ranges::upper_bound(m_slabs, begin, std::less{}, &Slab::begin);
+        m_slabs.insert(it, Slab{ begin, 0 });
+
+        m_slab_count.store(m_slabs.size(), std::memory_order_relaxed);
+    }
+
+    PoolAllocator::Slab* PoolAllocator::findSlab(const void* ptr) noexcept {
+        const std::byte* address = static_cast<const std::byte*>(ptr);
+
+        // the last slab that begins before the address
+        auto it = std::ranges::upper_bound(m_slabs, address, std::less{}, &Slab::begin);
+        assert(it != m_slabs.begin() && "fe::PoolAllocator : the pointer doesn't belong to this pool");
+
+        Slab* slab = std::to_address(std::prev(it));
+        assert(address < slab->begin + m_slot_size * m_slab_capacity && "fe::PoolAllocator : the pointer doesn't belong to this pool");
+
+        return slab;
+    }
+
+    void PoolAllocator::onAllocate() noexcept {
+        size_t live = m_live_count.fetch_add(1, std::memory_order_relaxed) + 1;
+        size_t peak = m_peak_count.load(std::memory_order_relaxed);
+
+        while (live > peak && !m_peak_count.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+
+} // namespace fe
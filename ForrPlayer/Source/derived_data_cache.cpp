@@ -0,0 +1,228 @@
+/*===============================================
+
+    Forr Engine
+
+    File : derived_data_cache.cpp
+    Role : content-addressed cache of importer outputs
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Core/derived_data_cache.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace fe {
+    // evicting goes a bit below the limit, so the next stores don't evict again right away
+    static constexpr double G_EVICTION_TARGET = 0.9;
+
+    static std::atomic<uint64_t> G_TEMPORARY_COUNTER{};
+
+    DerivedDataCache& DerivedDataCache::Instance() {
+        static DerivedDataCache derived_data_cache;
+        return derived_data_cache;
+    }
+
+    void DerivedDataCache::init(const std::filesystem::path& folder, const DerivedDataCacheDesc& desc) {
+        std::lock_guard<std::mutex> lock_guard(m_mutex);
+
+        m_folder = folder;
+        m_desc   = desc;
+
+        m_entries.clear();
+        m_use_counter = 0;
+        m_stats       = {};
+
+        if (!desc.enabled) {
+            fe::logging::info("Derived data cache is disabled");
+            return;
+        }
+
+        std::error_code error_code{};
+        std::filesystem::create_directories(m_folder, error_code);
+        if (error_code) {
+            fe::logging::error("File -> Unified. Failed to create the derived data cache folder. The cache is disabled. %s\nPath : %s", error_code.message().c_str(), m_folder.string().c_str());
+            return;
+        }
+
+        struct FoundEntry {
+            std::string                     name{};
+            uint64_t                        size{};
+            std::filesystem::file_time_type time{};
+        };
+
+        std::vector<FoundEntry> found{};
+
+        for (const auto& entry : std::filesystem::directory_iterator(m_folder, error_code)) {
+            if (!entry.is_regular_file()) continue;
+
+            if (entry.path().extension() == ".tmp") { // left by a crash while writing
+                std::filesystem::remove(entry.path(), error_code);
+                continue;
+            }
+
+            FoundEntry& found_entry = found.emplace_back();
+            found_entry.name        = entry.path().filename().string();
+            found_entry.size        = entry.file_size(error_code);
+            found_entry.time        = entry.last_write_time(error_code);
+        }
+
+        // the recency survives between runs in the last write time
+        std::sort(found.begin(), found.end(), [](const FoundEntry& a, const FoundEntry& b) { return a.time < b.time; });
+
+        for (FoundEntry& found_entry : found) {
+            Entry& entry   = m_entries[std::move(found_entry.name)];
+            entry.size     = found_entry.size;
+            entry.last_use = ++m_use_counter;
+
+            m_stats.size += entry.size;
+        }
+
+        m_enabled.store(true, std::memory_order_release);
+
+        this->evict(); // the limit could be decreased since the last run
+
+        fe::logging::info("Derived data cache is initialized. Entries : %zu, Size : %.2f MB / %.2f MB\nPath : %s",
+                          m_entries.size(), m_stats.size / (1024.0 * 1024.0), m_desc.max_size / (1024.0 * 1024.0), m_folder.string().c_str());
+    }
+
+    void DerivedDataCache::shutdown() {
+        if (!this->is_enabled()) return;
+
+        DerivedDataCacheStats stats = this->stats();
+
+        size_t lookups = stats.hits + stats.misses;
+        fe::logging::info("Derived data cache. Hits : %zu, Misses : %zu ( %.1f%% hit rate ), Stores : %zu, Evictions : %zu, Size : %.2f MB",
+                          stats.hits, stats.misses, lookups > 0 ? 100.0 * stats.hits / lookups : 0.0,
+                          stats.stores, stats.evictions, stats.size / (1024.0 * 1024.0));
+
+        std::lock_guard<std::mutex> lock_guard(m_mutex);
+
+        m_enabled.store(false, std::memory_order_release);
+        m_entries.clear();
+    }
+
+    std::filesystem::path DerivedDataCache::entry_path(uint64_t key, const std::filesystem::path& extension) const {
+        return m_folder / entryName(key, extension);
+    }
+
+    bool DerivedDataCache::find(uint64_t key, const std::filesystem::path& extension) {
+        if (!this->is_enabled()) return false;
+
+        std::string name = entryName(key, extension);
+
+        {
+            std::lock_guard<std::mutex> lock_guard(m_mutex);
+
+            auto it = m_entries.find(name);
+            if (it == m_entries.end()) {
+                m_stats.misses++;
+                return false;
+            }
+
+            it->second.last_use = ++m_use_counter;
+            m_stats.hits++;
+        }
+
+        // keeps the recency for the next run
+        std::error_code error_code{};
+        std::filesystem::last_write_time(m_folder / name, std::filesystem::file_time_type::clock::now(), error_code);
+
+        return true;
+    }
+
+    void DerivedDataCache::store(uint64_t key, const std::filesystem::path& extension) {
+        if (!this->is_enabled()) return;
+
+        std::string name = entryName(key, extension);
+
+        std::error_code error_code{};
+        uint64_t        size = std::filesystem::file_size(m_folder / name, error_code);
+        if (error_code) {
+            fe::logging::warning("File -> Unified. Failed to store a derived data cache entry. It wasn't written\nPath : %s", (m_folder / name).string().c_str());
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock_guard(m_mutex);
+
+        Entry& entry = m_entries[name];
+
+        m_stats.size -= entry.size; // the same entry can be stored again by another thread
+        m_stats.size += size;
+        m_stats.stores++;
+
+        entry.size     = size;
+        entry.last_use = ++m_use_counter;
+
+        this->evict();
+    }
+
+    void DerivedDataCache::discard(uint64_t key, const std::filesystem::path& extension) {
+        if (!this->is_enabled()) return;
+
+        std::string name = entryName(key, extension);
+
+        std::lock_guard<std::mutex> lock_guard(m_mutex);
+
+        auto it = m_entries.find(name);
+        if (it == m_entries.end()) return;
+
+        std::error_code error_code{};
+        std::filesystem::remove(m_folder / name, error_code);
+
+        m_stats.size -= it->second.size;
+        m_entries.erase(it);
+    }
+
+    DerivedDataCacheStats DerivedDataCache::stats() const {
+        std::lock_guard<std::mutex> lock_guard(m_mutex);
+
+        DerivedDataCacheStats stats = m_stats;
+        stats.entry_count           = m_entries.size();
+        return stats;
+    }
+
+    std::filesystem::path DerivedDataCache::temporary_path(const std::filesystem::path& path) {
+        std::filesystem::path temporary = path;
+        temporary += "." + std::to_string(G_TEMPORARY_COUNTER.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+        return temporary;
+    }
+
+    std::string DerivedDataCache::entryName(uint64_t key, const std::filesystem::path& extension) {
+        return hash_to_string(key) + extension.string();
+    }
+
+    void DerivedDataCache::evict() {
+        if (m_stats.size <= m_desc.max_size) return;
+
+        auto target = static_cast<uint64_t>(m_desc.max_size * G_EVICTION_TARGET);
+
+        std::vector<std::pair<uint64_t, const std::string*>> by_use{};
+        by_use.reserve(m_entries.size());
+        for (const auto& [name, entry] : m_entries) by_use.emplace_back(entry.last_use, &name);
+
+        std::sort(by_use.begin(), by_use.end());
+
+        std::vector<std::string> evicted{};
+
+        for (const auto& [last_use, name] : by_use) {
+            if (m_stats.size <= target) break;
+
+            // a file that is being read can't be removed on Windows, it's evicted next time
+            std::error_code error_code{};
+            std::filesystem::remove(m_folder / *name, error_code);
+            if (error_code) continue;
+
+            m_stats.size -= m_entries[*name].size;
+            m_stats.evictions++;
+
+            evicted.emplace_back(*name);
+        }
+
+        for (const std::string& name : evicted) m_entries.erase(name);
+    }
+} // namespace fe
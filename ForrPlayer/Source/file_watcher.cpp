@@ -0,0 +1,277 @@
+/*===============================================
+
+    Forr Engine
+
+    File : file_watcher.cpp
+    Role : reports changed files of a folder
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Core/file_watcher.hpp"
+
+#include <array>
+
+#if _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fe {
+#if _WIN32
+    struct FileWatcher::Native {
+        HANDLE     directory = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped{};
+
+        alignas(DWORD) std::array<std::byte, 64 * 1024> buffer{};
+
+        ~Native() {
+            if (directory != INVALID_HANDLE_VALUE) {
+                CancelIoEx(directory, &overlapped);
+
+                DWORD bytes{};
+                GetOverlappedResult(directory, &overlapped, &bytes, TRUE); // the buffer must not be freed while the OS writes to it
+
+                CloseHandle(directory);
+            }
+            if (overlapped.hEvent) CloseHandle(overlapped.hEvent);
+        }
+
+        bool read() {
+            constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+            return ReadDirectoryChangesW(directory, buffer.data(), static_cast<DWORD>(buffer.size()), TRUE, filter, nullptr, &overlapped, nullptr);
+        }
+    };
+#else
+    struct FileWatcher::Native {
+        int descriptor = -1;
+
+        std::unordered_map<int, std::filesystem::path> folders{}; // by watch descriptor, inotify isn't recursive
+
+        alignas(inotify_event) std::array<std::byte, 64 * 1024> buffer{};
+
+        ~Native() {
+            if (descriptor != -1) close(descriptor);
+        }
+
+        // the folder and all its subfolders
+        void watch(const std::filesystem::path& folder) {
+            this->watchFolder(folder);
+
+            std::error_code error_code{};
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(folder, error_code)) {
+                if (entry.is_directory()) this->watchFolder(entry.path());
+            }
+        }
+
+        void watchFolder(const std::filesystem::path& folder) {
+            int watch = inotify_add_watch(descriptor, folder.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (watch == -1) {
+                fe::logging::warning("Failed to watch a folder. Its changes won't be reported\nPath : %s", folder.string().c_str());
+                return;
+            }
+            folders[watch] = folder;
+        }
+    };
+#endif
+
+    static std::string keyOf(const std::filesystem::path& path) {
+        return path.lexically_normal().generic_string();
+    }
+} // namespace fe
+
+fe::FileWatcher::FileWatcher() = default;
+
+fe::FileWatcher::~FileWatcher() {
+    this->shutdown();
+}
+
+bool fe::FileWatcher::init(const std::filesystem::path& folder, const FileWatcherDesc& desc) {
+    this->shutdown();
+
+    std::error_code error_code{};
+    if (!std::filesystem::is_directory(folder, error_code)) {
+        fe::logging::error("File -> Unified. Failed to watch a folder. It doesn't exist\nPath : %s", folder.string().c_str());
+        return false;
+    }
+
+    m_folder = folder;
+    m_desc   = desc;
+
+    if (desc.native && this->initNative()) {
+        fe::logging::info("Watching a folder for changes\nPath : %s", m_folder.string().c_str());
+        return true;
+    }
+
+    this->scan(false);
+    m_last_scan = Clock::now();
+
+    fe::logging::info("Watching a folder for changes by polling every %u ms. Files : %zu\nPath : %s",
+                      desc.poll_interval_milliseconds, m_snapshot.size(), m_folder.string().c_str());
+    return true;
+}
+
+void fe::FileWatcher::shutdown() {
+    m_native.reset();
+
+    m_folder.clear();
+    m_snapshot.clear();
+    m_pending.clear();
+}
+
+std::vector<std::filesystem::path> fe::FileWatcher::poll() {
+    std::vector<std::filesystem::path> changed{};
+    if (!this->is_watching()) return changed;
+
+    Clock::time_point now = Clock::now();
+
+    if (m_native) {
+        this->readNative();
+    }
+    else if (now - m_last_scan >= std::chrono::milliseconds(m_desc.poll_interval_milliseconds)) {
+        this->scan(true);
+        m_last_scan = now;
+    }
+
+    const auto settle_time = std::chrono::milliseconds(m_desc.settle_milliseconds);
+
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (now - it->second < settle_time) {
+            ++it;
+            continue;
+        }
+
+        changed.emplace_back(it->first);
+        it = m_pending.erase(it);
+    }
+
+    return changed;
+}
+
+bool fe::FileWatcher::initNative() {
+    auto native = std::make_unique<Native>();
+
+#if _WIN32
+    native->directory = CreateFileW(m_folder.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                    nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (native->directory == INVALID_HANDLE_VALUE) {
+        fe::logging::warning("Failed to open a folder for watching. It's polled instead\nPath : %s", m_folder.string().c_str());
+        return false;
+    }
+
+    native->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!native->overlapped.hEvent || !native->read()) {
+        fe::logging::warning("Failed to watch a folder. It's polled instead\nPath : %s", m_folder.string().c_str());
+        return false;
+    }
+#else
+    native->descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (native->descriptor == -1) {
+        fe::logging::warning("Failed to initialize inotify. The folder is polled instead\nPath : %s", m_folder.string().c_str());
+        return false;
+    }
+
+    native->watch(m_folder);
+#endif
+
+    m_native = std::move(native);
+    return true;
+}
+
+void fe::FileWatcher::readNative() {
+#if _WIN32
+    DWORD bytes{};
+    while (GetOverlappedResult(m_native->directory, &m_native->overlapped, &bytes, FALSE)) {
+        if (bytes == 0) { // the OS buffer overflowed and the events are lost
+            fe::logging::warning("Too many file changes at once, some of them were missed\nPath : %s", m_folder.string().c_str());
+        }
+
+        size_t offset = 0;
+        while (bytes != 0) {
+            const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(m_native->buffer.data() + offset);
+
+            if (info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME) {
+                std::filesystem::path path = m_folder / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR));
+
+                std::error_code error_code{};
+                if (std::filesystem::is_regular_file(path, error_code)) this->touch(path);
+            }
+
+            if (info->NextEntryOffset == 0) break;
+            offset += info->NextEntryOffset;
+        }
+
+        ResetEvent(m_native->overlapped.hEvent);
+        if (!m_native->read()) {
+            fe::logging::error("Failed to keep watching a folder. It's polled from now\nPath : %s", m_folder.string().c_str());
+
+            m_native.reset();
+            this->scan(false);
+            return;
+        }
+    }
+#else
+    while (true) {
+        ssize_t size = read(m_native->descriptor, m_native->buffer.data(), m_native->buffer.size());
+        if (size <= 0) break; // EAGAIN, nothing more to read
+
+        for (ssize_t offset = 0; offset < size;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(m_native->buffer.data() + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                fe::logging::warning("Too many file changes at once, some of them were missed\nPath : %s", m_folder.string().c_str());
+                continue;
+            }
+
+            auto folder = m_native->folders.find(event->wd);
+            if (folder == m_native->folders.end() || event->len == 0) continue;
+
+            std::filesystem::path path = folder->second / event->name;
+
+            if (event->mask & IN_ISDIR) {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) m_native->watch(path);
+                continue;
+            }
+
+            // a created file is reported when it's closed after writing
+            if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) this->touch(path);
+        }
+    }
+#endif
+}
+
+void fe::FileWatcher::scan(bool report) {
+    std::unordered_map<std::string, FileState> snapshot{};
+    snapshot.reserve(m_snapshot.size());
+
+    std::error_code error_code{};
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(m_folder, error_code)) {
+        if (!entry.is_regular_file(error_code)) continue;
+
+        FileState state{};
+        state.time = entry.last_write_time(error_code);
+        state.size = entry.file_size(error_code);
+
+        std::string key = keyOf(entry.path());
+
+        if (report) {
+            auto it = m_snapshot.find(key);
+            if (it == m_snapshot.end() || it->second.time != state.time || it->second.size != state.size) this->touch(entry.path());
+        }
+
+        snapshot.emplace(std::move(key), state);
+    }
+
+    m_snapshot = std::move(snapshot);
+}
+
+void fe::FileWatcher::touch(const std::filesystem::path& path) {
+    m_pending[keyOf(path)] = Clock::now(); // the settle time starts again
+}
@@ -0,0 +1,141 @@
+/*===============================================
+
+    Forr Engine
+
+    File : hash.cpp
+    Role : fast non-cryptographic hashing of bytes and files
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Core/hash.hpp"
+
+#include <bit>
+#include <charconv>
+
+#include "Core/mapped_file.hpp"
+
+namespace fe {
+    static constexpr uint64_t G_PRIME_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t G_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t G_PRIME_3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t G_PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t G_PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+    // the format is little-endian, like every platform the engine runs on
+    static uint64_t read64(const uint8_t* p) noexcept {
+        uint64_t value{};
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint32_t read32(const uint8_t* p) noexcept {
+        uint32_t value{};
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint64_t roundStep(uint64_t accumulator, uint64_t input) noexcept {
+        accumulator += input * G_PRIME_2;
+        accumulator = std::rotl(accumulator, 31);
+        return accumulator * G_PRIME_1;
+    }
+
+    static uint64_t mergeRound(uint64_t accumulator, uint64_t value) noexcept {
+        accumulator ^= roundStep(0, value);
+        return accumulator * G_PRIME_1 + G_PRIME_4;
+    }
+} // namespace fe
+
+uint64_t fe::hash_bytes(const void* data, size_t size, uint64_t seed) noexcept {
+    const auto*    p   = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+
+    uint64_t hash{};
+
+    if (size >= 32) {
+        uint64_t v1 = seed + G_PRIME_1 + G_PRIME_2;
+        uint64_t v2 = seed + G_PRIME_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - G_PRIME_1;
+
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = roundStep(v1, read64(p));
+            v2 = roundStep(v2, read64(p + 8));
+            v3 = roundStep(v3, read64(p + 16));
+            v4 = roundStep(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    }
+    else {
+        hash = seed + G_PRIME_5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    for (; p + 8 <= end; p += 8) {
+        hash ^= roundStep(0, read64(p));
+        hash = std::rotl(hash, 27) * G_PRIME_1 + G_PRIME_4;
+    }
+
+    if (p + 4 <= end) {
+        hash ^= static_cast<uint64_t>(read32(p)) * G_PRIME_1;
+        hash = std::rotl(hash, 23) * G_PRIME_2 + G_PRIME_3;
+        p += 4;
+    }
+
+    for (; p < end; p++) {
+        hash ^= (*p) * G_PRIME_5;
+        hash = std::rotl(hash, 11) * G_PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= G_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= G_PRIME_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+bool fe::hash_file(const std::filesystem::path& path, uint64_t& hash, uint64_t seed) {
+    std::error_code error_code{};
+    uintmax_t       file_size = std::filesystem::file_size(path, error_code);
+
+    if (error_code) return false;
+
+    if (file_size == 0) { // empty files can't be mapped
+        hash = hash_bytes(nullptr, 0, seed);
+        return true;
+    }
+
+    MappedFile file{};
+    if (!file.open(path)) return false;
+
+    hash = hash_bytes(file.data(), file.size(), seed);
+    return true;
+}
+
+std::string fe::hash_to_string(uint64_t hash) {
+    char buffer[16]{};
+    auto result = std::to_chars(std::begin(buffer), std::end(buffer), hash, 16);
+
+    std::string string(16 - (result.ptr - buffer), '0'); // leading zeros
+    string.append(buffer, result.ptr);
+    return string;
+}
+
+bool fe::hash_from_string(std::string_view string, uint64_t& hash) noexcept {
+    auto result = std::from_chars(string.data(), string.data() + string.size(), hash, 16);
+    return result.ec == std::errc{} && result.ptr == string.data() + string.size();
+}
@@ -0,0 +1,145 @@
+/*===============================================
+
+    Forr Engine
+
+    File : image_mips.cpp
+    Role : layout and CPU generation of mip chains of 8-bit images
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Core/image_mips.hpp"
+
+#include <array>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FORR_MIPS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace fe {
+    struct SRGBTables {
+        std::array<float, 256> to_linear{};
+        std::array<float, 255> thresholds{}; // linear values halfway between neighbouring sRGB bytes, in sRGB space
+
+        SRGBTables() {
+            auto decode = [](float c) { return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f); };
+
+            for (size_t i = 0; i < to_linear.size(); i++) to_linear[i] = decode(static_cast<float>(i) / 255.0f);
+            for (size_t i = 0; i < thresholds.size(); i++) thresholds[i] = decode((static_cast<float>(i) + 0.5f) / 255.0f);
+        }
+    };
+
+    static const SRGBTables& srgbTables() {
+        static const SRGBTables tables{};
+        return tables;
+    }
+
+    // rounds like encoding to sRGB and then to a byte would, without pow()
+    static unsigned char linearToSRGB(const SRGBTables& tables, float value) {
+        return static_cast<unsigned char>(std::upper_bound(tables.thresholds.begin(), tables.thresholds.end(), value) - tables.thresholds.begin());
+    }
+
+    static unsigned char linearToUNorm(float value) {
+        return static_cast<unsigned char>(std::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f));
+    }
+
+    // one level from the previous one. a side of 1 texel uses the same texel twice
+    static void downsample(const unsigned char* source, uint32_t source_width, uint32_t source_height,
+                           unsigned char* destination, uint32_t width, uint32_t height, uint32_t components, bool srgb) {
+        const SRGBTables& tables = srgbTables();
+
+        const uint32_t color_components = components == 4 ? 3 : components; // the rest is alpha
+
+        const size_t source_pitch = static_cast<size_t>(source_width) * components;
+
+        for (uint32_t y = 0; y < height; y++) {
+            const unsigned char* row0 = source + std::min(2 * y, source_height - 1) * source_pitch;
+            const unsigned char* row1 = source + std::min(2 * y + 1, source_height - 1) * source_pitch;
+
+            unsigned char* out = destination + static_cast<size_t>(y) * width * components;
+
+            uint32_t x = 0;
+
+#ifdef FORR_MIPS_SSE2
+            // two output texels at a time : 4 texels of each source row are one 16 byte load
+            if (components == 4 && !srgb) {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i two  = _mm_set1_epi16(2);
+
+                for (; x + 1 < width && 2 * x + 3 < source_width; x += 2) {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * x * 4));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * x * 4));
+
+                    __m128i low  = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)); // texels 0 and 1, 16 bit
+                    __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)); // texels 2 and 3
+
+                    low  = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+                    high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+
+                    __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(low, high), two), 2);
+
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(sum, zero));
+                }
+            }
+#endif
+
+            for (; x < width; x++) {
+                const size_t x0 = std::min(2 * x, source_width - 1) * components;
+                const size_t x1 = std::min(2 * x + 1, source_width - 1) * components;
+
+                const unsigned char* texels[4] = { row0 + x0, row0 + x1, row1 + x0, row1 + x1 };
+
+                unsigned char* texel = out + static_cast<size_t>(x) * components;
+
+                if (!srgb) {
+                    for (uint32_t c = 0; c < components; c++) {
+                        texel[c] = static_cast<unsigned char>((texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c] + 2) >> 2);
+                    }
+                    continue;
+                }
+
+#ifdef FORR_MIPS_SSE2
+                if (components == 4) {
+                    __m128 sum = _mm_setzero_ps();
+                    for (const unsigned char* t : texels) {
+                        sum = _mm_add_ps(sum, _mm_set_ps(t[3] / 255.0f, tables.to_linear[t[2]], tables.to_linear[t[1]], tables.to_linear[t[0]]));
+                    }
+
+                    alignas(16) float average[4]{};
+                    _mm_store_ps(average, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+
+                    texel[0] = linearToSRGB(tables, average[0]);
+                    texel[1] = linearToSRGB(tables, average[1]);
+                    texel[2] = linearToSRGB(tables, average[2]);
+                    texel[3] = linearToUNorm(average[3]);
+                    continue;
+                }
+#endif
+
+                for (uint32_t c = 0; c < components; c++) {
+                    if (c < color_components) {
+                        float sum = tables.to_linear[texels[0][c]] + tables.to_linear[texels[1][c]] + tables.to_linear[texels[2][c]] + tables.to_linear[texels[3][c]];
+                        texel[c]  = linearToSRGB(tables, sum * 0.25f);
+                    }
+                    else {
+                        texel[c] = static_cast<unsigned char>((texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c] + 2) >> 2);
+                    }
+                }
+            }
+        }
+    }
+} // namespace fe
+
+void fe::generate_mips(unsigned char* chain, uint32_t width, uint32_t height, uint32_t components, uint32_t count, bool srgb) {
+    for (uint32_t level = 1; level < count; level++) {
+        MipLevel source      = mip_level(width, height, components, level - 1);
+        MipLevel destination = mip_level(width, height, components, level);
+
+        downsample(chain + source.offset, source.width, source.height, chain + destination.offset, destination.width, destination.height, components, srgb);
+    }
+}
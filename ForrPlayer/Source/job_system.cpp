@@ -0,0 +1,318 @@
+/*===============================================
+
+    Forr Engine
+
+    File : job_system.cpp
+    Role : work-stealing job scheduler
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Core/job_system.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#if _WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace fe {
+    struct JobSystem::Job {
+        JobFunction func{};
+        JobCounter* counter = nullptr;
+    };
+
+    struct alignas(64) JobSystem::Worker {
+        std::mutex       mutex;
+        std::deque<Job*> jobs;
+        std::thread      thread;
+
+        void push(Job* job) {
+            std::lock_guard<std::mutex> lock_guard(mutex);
+            jobs.push_back(job);
+        }
+
+        // the owner takes the newest job ( it's still in cache )
+        FORR_NODISCARD Job* pop() {
+            std::lock_guard<std::mutex> lock_guard(mutex);
+            if (jobs.empty()) return nullptr;
+
+            Job* job = jobs.back();
+            jobs.pop_back();
+            return job;
+        }
+
+        // others take the oldest one ( it's usually the biggest part of the work )
+        FORR_NODISCARD Job* steal() {
+            std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+            if (!lock.owns_lock() || jobs.empty()) return nullptr;
+
+            Job* job = jobs.front();
+            jobs.pop_front();
+            return job;
+        }
+    };
+
+    static constexpr size_t G_JOB_POOL_SLAB_CAPACITY = 1024;
+
+    static std::mutex              G_SLEEP_MUTEX;
+    static std::condition_variable G_SLEEP_CONDITION;
+
+    static std::thread::id G_MAIN_THREAD_ID{};
+
+    static thread_local size_t   G_WORKER_INDEX = JobSystem::INVALID_WORKER_INDEX;
+    static thread_local uint32_t G_STEAL_SEED   = 0;
+
+    static void setupWorkerThread(std::thread& thread, const std::string& name, size_t core_index, bool pin) {
+#if _WIN32
+        std::wstring wide_name(name.begin(), name.end());
+        SetThreadDescription(thread.native_handle(), wide_name.c_str());
+
+        if (pin && core_index < sizeof(DWORD_PTR) * 8) {
+            SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << core_index);
+        }
+#else
+        std::string short_name = name.substr(0, 15); // pthread limit
+        pthread_setname_np(thread.native_handle(), short_name.c_str());
+
+        if (pin && core_index < CPU_SETSIZE) {
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            CPU_SET(core_index, &cpu_set);
+            pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set);
+        }
+#endif
+    }
+
+    JobSystem::JobSystem()
+        : m_global(std::make_unique<Worker>()),
+          m_main(std::make_unique<Worker>()),
+          m_job_pool(std::make_unique<Pool<Job>>(G_JOB_POOL_SLAB_CAPACITY, MemoryTag::Jobs)) {
+    }
+
+    JobSystem::~JobSystem() {
+        assert(m_workers.empty() && "fe::JobSystem : call shutdown() before the end of the program");
+    }
+
+    JobSystem& JobSystem::Instance() {
+        static JobSystem job_system;
+        return job_system;
+    }
+
+    void JobSystem::init(const JobSystemDesc& desc) {
+        assert(m_workers.empty() && "fe::JobSystem : already initialized");
+
+        G_MAIN_THREAD_ID = std::this_thread::get_id();
+
+        size_t worker_count = desc.worker_count;
+        if (worker_count == 0) {
+            size_t cores = std::thread::hardware_concurrency();
+            worker_count = cores > 1 ? cores - 1 : 1;
+        }
+
+        m_stop.store(false);
+
+        if (!m_job_pool) m_job_pool = std::make_unique<Pool<Job>>(G_JOB_POOL_SLAB_CAPACITY, MemoryTag::Jobs); // shutdown() destroys it
+
+        m_workers.reserve(worker_count);
+        for (size_t i = 0; i < worker_count; i++) {
+            m_workers.emplace_back(std::make_unique<Worker>());
+        }
+
+        // start only when all the deques exist, workers steal from each other
+        for (size_t i = 0; i < worker_count; i++) {
+            m_workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+            setupWorkerThread(m_workers[i]->thread, desc.worker_name + " " + std::to_string(i), i + 1, desc.pin_workers);
+        }
+
+        fe::logging::info("Job system is initialized with %zu workers", worker_count);
+    }
+
+    void JobSystem::shutdown() {
+        if (m_workers.empty()) return;
+
+        {
+            std::lock_guard<std::mutex> lock_guard(G_SLEEP_MUTEX);
+            m_stop.store(true);
+        }
+        G_SLEEP_CONDITION.notify_all();
+
+        for (auto& worker : m_workers) {
+            worker->thread.join();
+        }
+
+        // nobody is going to run them now
+        for (auto& worker : m_workers) {
+            while (Job* job = worker->pop()) this->execute(job);
+        }
+        while (Job* job = m_global->pop()) this->execute(job);
+
+        this->process_main_thread_jobs();
+
+        m_workers.clear();
+        m_pending.store(0);
+
+        // while the pool cache of this thread is alive. at static destruction thread_local objects are destroyed already
+        m_job_pool.reset();
+    }
+
+    void JobSystem::run(JobFunction func, JobCounter* counter) {
+        if (m_workers.empty()) {
+            invoke(func);
+            return;
+        }
+
+        Job* job = this->createJob(std::move(func), counter);
+
+        m_pending.fetch_add(1, std::memory_order_release); // before the push, so findJob() never makes it negative
+
+        size_t worker_index = G_WORKER_INDEX;
+        if (worker_index < m_workers.size()) {
+            m_workers[worker_index]->push(job);
+        }
+        else {
+            m_global->push(job);
+        }
+
+        {
+            // an empty lock, so the worker can't miss the notification between checking m_pending and sleeping
+            std::lock_guard<std::mutex> lock_guard(G_SLEEP_MUTEX);
+        }
+        G_SLEEP_CONDITION.notify_one();
+    }
+
+    void JobSystem::run_on_main_thread(JobFunction func, JobCounter* counter) {
+        if (m_workers.empty() && this->is_main_thread()) {
+            invoke(func);
+            return;
+        }
+
+        m_main->push(this->createJob(std::move(func), counter));
+    }
+
+    void JobSystem::wait(const JobCounter& counter) {
+        size_t worker_index   = G_WORKER_INDEX;
+        bool   is_main_thread = this->is_main_thread();
+
+        while (!counter.is_done()) {
+            Job* job = nullptr;
+
+            if (is_main_thread) {
+                std::lock_guard<std::mutex> lock_guard(m_main->mutex);
+                if (!m_main->jobs.empty()) {
+                    job = m_main->jobs.front();
+                    m_main->jobs.pop_front();
+                }
+            }
+
+            if (!job) job = this->findJob(worker_index);
+
+            if (job) {
+                this->execute(job);
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::process_main_thread_jobs() {
+        assert(this->is_main_thread() && "fe::JobSystem : process_main_thread_jobs() must be called from the main thread");
+
+        std::deque<Job*> jobs{};
+        {
+            std::lock_guard<std::mutex> lock_guard(m_main->mutex);
+            jobs.swap(m_main->jobs);
+        }
+
+        for (Job* job : jobs) {
+            this->execute(job);
+        }
+    }
+
+    bool JobSystem::is_main_thread() const noexcept {
+        return std::this_thread::get_id() == G_MAIN_THREAD_ID;
+    }
+
+    size_t JobSystem::current_worker_index() const noexcept {
+        return G_WORKER_INDEX;
+    }
+
+    void JobSystem::workerLoop(size_t worker_index) {
+        G_WORKER_INDEX = worker_index;
+        G_STEAL_SEED   = static_cast<uint32_t>(worker_index * 2654435761u + 1);
+
+        while (true) {
+            if (Job* job = this->findJob(worker_index)) {
+                this->execute(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(G_SLEEP_MUTEX);
+            G_SLEEP_CONDITION.wait(lock, [this] { return m_stop.load() || m_pending.load(std::memory_order_acquire) != 0; });
+
+            if (m_stop.load()) break;
+        }
+    }
+
+    JobSystem::Job* JobSystem::createJob(JobFunction&& func, JobCounter* counter) {
+        if (counter) counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+        return m_job_pool->create(Job{ std::move(func), counter });
+    }
+
+    JobSystem::Job* JobSystem::findJob(size_t worker_index) {
+        Job* job = nullptr;
+
+        if (worker_index < m_workers.size()) job = m_workers[worker_index]->pop();
+        if (!job) job = m_global->pop();
+
+        if (!job && !m_workers.empty()) {
+            // xorshift, so workers don't all start stealing from the same victim
+            G_STEAL_SEED ^= G_STEAL_SEED << 13;
+            G_STEAL_SEED ^= G_STEAL_SEED >> 17;
+            G_STEAL_SEED ^= G_STEAL_SEED << 5;
+
+            size_t start = G_STEAL_SEED % m_workers.size();
+            for (size_t i = 0; i < m_workers.size() && !job; i++) {
+                size_t victim = (start + i) % m_workers.size();
+                if (victim != worker_index) job = m_workers[victim]->steal();
+            }
+        }
+
+        if (job) m_pending.fetch_sub(1, std::memory_order_relaxed);
+
+        return job;
+    }
+
+    void JobSystem::execute(Job* job) {
+        JobCounter* counter = job->counter;
+
+        // a job that throws is still done, otherwise wait() on its counter never returns
+        invoke(job->func);
+
+        m_job_pool->destroy(job);
+
+        if (counter) counter->m_count.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void JobSystem::invoke(const JobFunction& func) noexcept {
+        try {
+            func();
+        }
+        catch (const std::exception& e) {
+            fe::logging::error("fe::JobSystem : a job threw an exception. %s", e.what());
+        }
+        catch (...) {
+            fe::logging::error("fe::JobSystem : a job threw an unknown exception");
+        }
+    }
+} // namespace fe
@@ -0,0 +1,118 @@
+/*===============================================
+
+    Forr Engine
+
+    File : mapped_file.cpp
+    Role : read-only memory-mapped file
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Core/mapped_file.hpp"
+
+#include <utility>
+
+#if _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool fe::MappedFile::open(const std::filesystem::path& path) {
+    this->close();
+
+#if _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        fe::logging::error("File -> Unified. Failed to open a file\nPath : %s", path.string().c_str());
+        return false;
+    }
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        fe::logging::error("File -> Unified. The file is empty or its size is unknown\nPath : %s", path.string().c_str());
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        fe::logging::error("File -> Unified. Failed to create a file mapping\nPath : %s", path.string().c_str());
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        fe::logging::error("File -> Unified. Failed to map a file\nPath : %s", path.string().c_str());
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file    = file;
+    m_mapping = mapping;
+    m_data    = static_cast<const std::byte*>(data);
+    m_size    = static_cast<size_t>(file_size.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        fe::logging::error("File -> Unified. Failed to open a file\nPath : %s", path.string().c_str());
+        return false;
+    }
+
+    struct stat file_stat{};
+    if (fstat(file, &file_stat) != 0 || file_stat.st_size == 0) {
+        fe::logging::error("File -> Unified. The file is empty or its size is unknown\nPath : %s", path.string().c_str());
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file); // the mapping keeps the file alive
+
+    if (data == MAP_FAILED) {
+        fe::logging::error("File -> Unified. Failed to map a file\nPath : %s", path.string().c_str());
+        return false;
+    }
+
+    m_data = static_cast<const std::byte*>(data);
+    m_size = static_cast<size_t>(file_stat.st_size);
+#endif
+
+    return true;
+}
+
+void fe::MappedFile::close() {
+    if (!m_data) return;
+
+#if _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+
+    m_mapping = nullptr;
+    m_file    = nullptr;
+#else
+    munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+void fe::MappedFile::swap(MappedFile& other) noexcept {
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+
+#if _WIN32
+    std::swap(m_file, other.m_file);
+    std::swap(m_mapping, other.m_mapping);
+#endif
+}
@@ -0,0 +1,127 @@
+/*===============================================
+
+    Forr Engine
+
+    File : memory_tracking.cpp
+    Role : per-subsystem memory accounting. Tags, budgets and high-water marks
+
+    Copyright (C) 2026 Farrakh
+    All Rights Reserved.
+
+===============================================*/
+
+#include "pch.hpp"
+#include "Core/memory_tracking.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+
+namespace fe::memory {
+    struct alignas(64) TagCounters { // one cache line per tag, so different subsystems don't fight
+        std::atomic<size_t> current_bytes{};
+        std::atomic<size_t> peak_bytes{};
+        std::atomic<size_t> allocation_count{};
+        std::atomic<size_t> total_allocations{};
+        std::atomic<size_t> budget{};
+    };
+
+    static std::array<TagCounters, static_cast<size_t>(MemoryTag::Count)> G_TAG_COUNTERS{};
+
+    static TagCounters& getCounters(MemoryTag tag) noexcept {
+        size_t index = static_cast<size_t>(tag);
+        return G_TAG_COUNTERS[index < G_TAG_COUNTERS.size() ? index : 0];
+    }
+
+    void trackAllocation(MemoryTag tag, size_t bytes) noexcept {
+        TagCounters& counters = getCounters(tag);
+
+        size_t previous = counters.current_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        size_t current  = previous + bytes;
+
+        counters.allocation_count.fetch_add(1, std::memory_order_relaxed);
+        counters.total_allocations.fetch_add(1, std::memory_order_relaxed);
+
+        size_t peak = counters.peak_bytes.load(std::memory_order_relaxed);
+        while (current > peak && !counters.peak_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+
+        size_t budget = counters.budget.load(std::memory_order_relaxed);
+        if (budget != 0 && previous <= budget && current > budget) { // only when crossing, not on every allocation
+            fe::logging::warning("Memory budget of '%s' is exceeded : %zu / %zu bytes", getTagName(tag), current, budget);
+        }
+    }
+
+    void trackDeallocation(MemoryTag tag, size_t bytes) noexcept {
+        TagCounters& counters = getCounters(tag);
+
+        counters.current_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        counters.allocation_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void setBudget(MemoryTag tag, size_t bytes) noexcept {
+        getCounters(tag).budget.store(bytes, std::memory_order_relaxed);
+    }
+
+    TagStats getStats(MemoryTag tag) noexcept {
+        const TagCounters& counters = getCounters(tag);
+
+        TagStats stats{};
+        stats.current_bytes     = counters.current_bytes.load(std::memory_order_relaxed);
+        stats.peak_bytes        = counters.peak_bytes.load(std::memory_order_relaxed);
+        stats.allocation_count  = counters.allocation_count.load(std::memory_order_relaxed);
+        stats.total_allocations = counters.total_allocations.load(std::memory_order_relaxed);
+        stats.budget            = counters.budget.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    const char* getTagName(MemoryTag tag) noexcept {
+        // clang-format off
+        switch (tag) {
+            case MemoryTag::Unknown  : return "Unknown";
+            case MemoryTag::Textures : return "Textures";
+            case MemoryTag::Meshes   : return "Meshes";
+            case MemoryTag::Animation: return "Animation";
+            case MemoryTag::Shaders  : return "Shaders";
+            case MemoryTag::Materials: return "Materials";
+            case MemoryTag::Renderer : return "Renderer";
+            case MemoryTag::Resources: return "Resources";
+            case MemoryTag::Scratch  : return "Scratch";
+            case MemoryTag::Jobs     : return "Jobs";
+            default: return "Invalid";
+        }
+        // clang-format on
+    }
+
+    void resetPeaks() noexcept {
+        for (TagCounters& counters : G_TAG_COUNTERS) {
+            counters.peak_bytes.store(counters.current_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    void dump() {
+        char   buffer[4096];
+        size_t offset = 0;
+
+        offset += snprintf(buffer + offset, sizeof(buffer) - offset, "Memory usage ( current / peak / budget bytes, live / total allocations ) :");
+
+        for (size_t i = 0; i < G_TAG_COUNTERS.size() && offset < sizeof(buffer); i++) {
+            MemoryTag tag   = static_cast<MemoryTag>(i);
+            TagStats  stats = getStats(tag);
+
+            if (stats.total_allocations == 0) continue;
+
+            offset += snprintf(buffer + offset, sizeof(buffer) - offset,
+                               "\n    %-10s : %12zu / %12zu / %12zu, %zu / %zu%s",
+                               getTagName(tag),
+                               stats.current_bytes,
+                               stats.peak_bytes,
+                               stats.budget,
+                               stats.allocation_count,
+                               stats.total_allocations,
+                               (stats.budget != 0 && stats.peak_bytes > stats.budget) ? " ( OVER BUDGET )" : "");
+        }
+
+        fe::logging::info("%s", buffer);
+    }
+
+} // namespace fe::memory